@@ -17,47 +17,62 @@ Manifold::Manifold() : std::deque< Patch >()
 
 }
 
-Manifold::Manifold( const Manifold& m) : std::deque< Patch >(m)
+Manifold::Manifold( const Patch& p) : std::deque< Patch >(1, p)
 {
-    this->integrator_ = m.integrator_;
+
 }
 
-Manifold::Manifold( const Patch& p)
+Manifold::Manifold( const DACE::AlgebraicVector<DACE::DA>& p) : Manifold(Patch(p))
 {
-    // Create a temporal Manifold
-    Manifold temp;
-
-    // Push back the input patch to a temporal Manifold
-    temp.push_back(p);
-
-    // TODO: WTF: Set the created temporal Manifold to "this" class instance
-    *this = temp;
 
 }
 
-Manifold::Manifold( const DACE::AlgebraicVector<DACE::DA>& p)
+std::unique_ptr<Manifold> Manifold::getSplitDomain(ALGORITHM algorithm, int nSplitMax, bool domain_evolution,
+                                                   std::unique_ptr<Manifold> results, int* split_counter)
 {
-    // Create a patch from the DA vector
-    Patch temp = p;
-
-    // TODO: WTF: Create Manifold from a Patch
-    Manifold aux(temp);
+    // Profile
+    PROFILE_SCOPE(PROFILE_SECTION::GET_SPLIT_DOMAIN);
 
-    // TODO: WTF: Set aux to "this" class instance from a temporal Patch
-    *this = aux;
-}
+    // Identifier of the next patch to be created
+    int split_count = split_counter != nullptr ? *split_counter : 1;
 
-Manifold* Manifold::getSplitDomain(ALGORITHM algorithm, int nSplitMax, bool domain_evolution)
-{
     /* (Low Order?) Automatic Domain Splitting Algorithm */
-    auto results = new Manifold();
+    if (results == nullptr)
+    {
+        results = std::make_unique<Manifold>();
+    }
 
-    // Re-set integrator
+    // Re-set integrator, checkpoint, coarsening, budget, splitting and weighting settings
     results->integrator_ = this->integrator_;
+    results->checkpoint_ = this->checkpoint_;
+    results->merge_tolerance_ = this->merge_tolerance_;
+    results->budget_ = this->budget_;
+    results->split_plan_ = this->split_plan_;
+    results->confidence_interval_ = this->confidence_interval_;
 
     // Iterator
     int i = 0;
-    int split_count = 1;
+
+    // Priority order: the pending patches are kept as a max-heap of the priorities stored when queued
+    bool by_priority = this->budget_.priority != BUDGET_PRIORITY::FIFO;
+    auto lower_priority = [](const Patch& a, const Patch& b)
+    {
+        return a.priority_ < b.priority_;
+    };
+    if (by_priority)
+    {
+        for (auto& p : *this) { p.priority_ = budget::priority(this->budget_, p); }
+        std::make_heap(this->begin(), this->end(), lower_priority);
+    }
+
+    // Budget: exhausted cap, and new patches of a split beyond the one replaced
+    std::string exhausted{};
+    std::size_t split_growth = (this->split_plan_.enabled() ? this->split_plan_.max_pieces :
+                                split_plan::cut_pieces(this->integrator_->get_algorithm())) - 1;
+    bool interruption = this->integrator_->get_interruption();
+
+    // Last checkpoint
+    auto last_checkpoint = std::chrono::steady_clock::now();
 
     /*execute steps of Automatic Domain Splitting, calling the function to estimate the error and to split the Patch*/
     // While runs until the vector gets emptied >> (std::deque< Patch >)
@@ -70,15 +85,37 @@ Manifold* Manifold::getSplitDomain(ALGORITHM algorithm, int nSplitMax, bool doma
         if (domain_evolution && false)
         {
             // Make a copy and store its poin ter
-            results->ini_domain_record->push_back(new Manifold(*this));
-            results->fin_domain_record->push_back(new Manifold(*results));
+            results->ini_domain_record.push_back(*this);
+            results->fin_domain_record.push_back(*results);
         }
 
-        // Creates new patch from the first position in this Manifold
-        auto p = this->front();
+        // Budget: once a cap is hit, every remaining patch is finished without splitting
+        if (this->budget_.enabled() && interruption && exhausted.empty())
+        {
+            exhausted = budget::exhausted(this->budget_, this->size() + results->size() + split_growth);
+            if (!exhausted.empty())
+            {
+                std::fprintf(stdout, "Budget: '%s' cap hit, '%zu' pending patches finish without splitting.\n",
+                             exhausted.c_str(), this->size());
+            }
+        }
 
-        // Removes the one in front
-        this->pop_front();
+        // Creates new patch from the first position (or the highest priority) in this Manifold
+        if (by_priority)
+        {
+            std::pop_heap(this->begin(), this->end(), lower_priority);
+        }
+        auto p = by_priority ? this->back() : this->front();
+
+        // Removes it
+        if (by_priority)
+        {
+            this->pop_back();
+        }
+        else
+        {
+            this->pop_front();
+        }
 
         // Set time for the integrator
         this->integrator_->t_ = p.t_;
@@ -86,11 +123,22 @@ Manifold* Manifold::getSplitDomain(ALGORITHM algorithm, int nSplitMax, bool doma
         // Set the beta from the patch to the integrator
         this->integrator_->betas_ = p.betas;
 
-        // Get the new state
+        // Set the truncation order of the patch, only used by the adaptive order
+        this->integrator_->set_order(p.order_);
+
+        // Get the new state, unsplit if the budget is exhausted
+        this->integrator_->set_interruption(interruption && exhausted.empty());
         auto scv = this->integrator_->integrate(p, p.id_);
+        this->integrator_->set_interruption(interruption);
 
         // Builds patch from the resulting scv
-        Patch f(scv, p.get_history_int(), p.get_times_doubles(), p.get_nlis_doubles(), algorithm, this->integrator_->t_, p.nli, p.t_split_);
+        Patch f(scv, p.get_history(), p.get_times_doubles(), p.get_nlis_doubles(), algorithm, this->integrator_->t_, p.nli, p.t_split_);
+
+        // Keep identifier and scaling, so the patch can be propagated further later on
+        f.id_ = p.id_;
+        f.betas = p.betas;
+        f.order_ = this->integrator_->get_order();
+        f.budget_limited_ = p.budget_limited_ || !exhausted.empty();
 
         if (f.get_history_count() == nSplitMax || this->integrator_->end_) // TODO: What about this case: (*max_error == 0.0) See old function
         {
@@ -99,23 +147,87 @@ Manifold* Manifold::getSplitDomain(ALGORITHM algorithm, int nSplitMax, bool doma
         }
         else
         {
-            // Get direction of the split
-            auto dir = this->integrator_->get_splitting_pos() + 1;
+            // Get directions of the split: one unless the predictive splitting asks for more
+            auto dirs = split_plan::directions(this->split_plan_, *this->integrator_,
+                                               nSplitMax - (int) f.get_history_count());
 
-            // Split the patch
-            auto s = f.split(dir);
+            // Split the patch, every piece again along the next direction
+            std::vector<Patch> s{f};
+            for (const auto& dir : dirs)
+            {
+                std::vector<Patch> pieces;
+                for (auto& piece : s)
+                {
+                    auto children = piece.split(dir);
+                    pieces.insert(pieces.end(), children.begin(), children.end());
+                }
+                s = std::move(pieces);
+            }
+
+            // Trace split event
+            if (tools::trace::enabled())
+            {
+                tools::trace::instant("split", "split", tools::string::print2string(
+                        "\"id\": %d, \"dir\": %d, \"cuts\": %zu, \"pieces\": %zu, \"nli\": %.16f, "
+                        "\"t\": %.16f", p.id_, dirs.front(), dirs.size(), s.size(), this->integrator_->nli_current_,
+                        this->integrator_->t_));
+            }
 
             // Add new patches
-            this->add_new_patches(s, split_count, dir);
+            this->add_new_patches(s, split_count, dirs);
+
+            // Keep the heap
+            if (by_priority)
+            {
+                for (auto k = this->size() - s.size() + 1; k <= this->size(); k++)
+                {
+                    (*this)[k - 1].priority_ = budget::priority(this->budget_, (*this)[k - 1]);
+                    std::push_heap(this->begin(), this->begin() + (long) k, lower_priority);
+                }
+            }
+        }
+
+        // Periodic checkpoint: every patch is either pending or finished at this point
+        if (this->checkpoint_.enabled() && !this->empty() &&
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - last_checkpoint).count() >= this->checkpoint_.interval)
+        {
+            checkpoint::save(this->checkpoint_.file_path, *this, *results, split_count, *this->integrator_);
+            last_checkpoint = std::chrono::steady_clock::now();
         }
 
         i++;
     }
 
+    // Info
+    if (!exhausted.empty())
+    {
+        auto limited = std::count_if(results->begin(), results->end(), [](const Patch& f) { return f.budget_limited_; });
+        std::fprintf(stdout, "Budget: '%ld' of '%zu' patches finished without splitting.\n", (long) limited,
+                     results->size());
+    }
+
+    // Coarsening: the patches finished together may be merged back
+    if (results->merge_tolerance_ > 0.0)
+    {
+        results->coarsen(split_count);
+    }
+
+    // Weight the final boxes
+    if (results->confidence_interval_ > 0.0)
+    {
+        results->set_probability_masses(results->confidence_interval_);
+    }
+
+    // Give the counter back, so that the next call keeps the identifiers unique
+    if (split_counter != nullptr)
+    {
+        *split_counter = split_count;
+    }
+
     return results;
 }
 
-void Manifold::add_new_patches(std::vector<Patch> & new_patches, int & split_count, int dir)
+void Manifold::add_new_patches(std::vector<Patch> & new_patches, int & split_count, const std::vector<int>& dirs)
 {
     // Add new patches
     for (auto & p_new : new_patches)
@@ -124,12 +236,16 @@ void Manifold::add_new_patches(std::vector<Patch> & new_patches, int & split_cou
         p_new.id_ = split_count;
         p_new.nli = this->integrator_->nli_current_;
         p_new.t_split_ = this->integrator_->t_;
+        p_new.order_ = this->integrator_->get_order();
 
-        // CRITICAL: collect betas from last patch and scale in the split direction
+        // CRITICAL: collect betas from last patch and scale in every split direction
         if (this->integrator_->get_algorithm() == ALGORITHM::LOADS)
         {
             p_new.betas = this->integrator_->betas_;
-            p_new.betas[dir - 1] /= 3;
+            for (const auto& dir : dirs)
+            {
+                p_new.betas[dir - 1] /= 3;
+            }
         }
 
         // TODO: push back of this object... copies are lost? Analyze what's happening in memory
@@ -140,6 +256,87 @@ void Manifold::add_new_patches(std::vector<Patch> & new_patches, int & split_cou
     }
 }
 
+int Manifold::coarsen(int & split_count)
+{
+    // Profile
+    PROFILE_SCOPE(PROFILE_SECTION::COARSEN);
+
+    // Children of a split
+    std::size_t n_children = this->integrator_->get_algorithm() == ALGORITHM::LOADS ? 3 : 2;
+
+    // Counter
+    int merges = 0;
+
+    // Repeat while something merges: a merged patch may complete a group of its own parent
+    for (bool merged_any = true; merged_any; )
+    {
+        merged_any = false;
+
+        // Group the patches by parent box and time
+        std::map<std::pair<SplittingHistory, double>, std::vector<std::size_t>> groups;
+        for (std::size_t k = 0; k < this->size(); k++)
+        {
+            const auto& history = (*this)[k].get_history();
+            if (history.empty()) { continue; }
+            groups[{history.parent(), (*this)[k].t_}].push_back(k);
+        }
+
+        // Try to merge every complete group
+        std::vector<bool> removed(this->size(), false);
+        std::vector<Patch> added;
+        for (const auto& group : groups)
+        {
+            // Safety check: every sibling must be there
+            if (group.second.size() != n_children) { continue; }
+
+            // Siblings
+            std::vector<Patch> siblings;
+            for (const auto& k : group.second) { siblings.push_back((*this)[k]); }
+
+            // Rebuild the parent
+            Patch merged;
+            if (!Patch::merge(siblings, this->merge_tolerance_, merged)) { continue; }
+
+            // It would be split again right away
+            this->integrator_->t_ = merged.t_;
+            this->integrator_->betas_ = merged.betas;
+            if (this->integrator_->check_conditions(merged)) { continue; }
+
+            // Trace merge event
+            if (tools::trace::enabled())
+            {
+                tools::trace::instant("merge", "split", tools::string::print2string(
+                        "\"id\": %d, \"nli\": %.16f, \"t\": %.16f", split_count, this->integrator_->nli_current_,
+                        merged.t_));
+            }
+
+            // Replace the siblings
+            merged.id_ = split_count++;
+            for (const auto& k : group.second) { removed[k] = true; }
+            added.push_back(merged);
+            merged_any = true;
+            merges++;
+        }
+
+        // Keep the rest, merged patches at the end
+        Manifold kept;
+        for (std::size_t k = 0; k < this->size(); k++)
+        {
+            if (!removed[k]) { kept.push_back((*this)[k]); }
+        }
+        kept.insert(kept.end(), added.begin(), added.end());
+        this->assign(kept.begin(), kept.end());
+    }
+
+    // Info
+    if (merges > 0)
+    {
+        std::fprintf(stdout, "Manifold: '%d' groups of siblings merged, '%zu' patches left.\n", merges, this->size());
+    }
+
+    return merges;
+}
+
 /*
 Manifold* Manifold::getSplitDomain(const std::vector<double>& errToll, const int nSplitMax, int posOverride)
 {
@@ -759,6 +956,67 @@ std::vector<DACE::AlgebraicVector<double>> Manifold::centerPointEvaluationManifo
     return result;
 }
 
+double Manifold::set_probability_masses(double confidence_interval)
+{
+    // Mass of every box, and their sum
+    double total = 0.0;
+    for (auto & p : *this)
+    {
+        p.mass_ = p.probability_mass(confidence_interval);
+        total += p.mass_;
+    }
+
+    return total;
+}
+
+bool Manifold::weighted_center_moments(DACE::AlgebraicVector<double>& mean,
+                                       std::vector<DACE::AlgebraicVector<double>>& covariance)
+{
+    // Every patch must be weighted
+    if (this->empty() || std::any_of(this->begin(), this->end(), [](const Patch& p) { return p.mass_ < 0.0; }))
+    {
+        return false;
+    }
+
+    // Centers and total mass, to normalize the weights
+    auto centers = this->centerPointEvaluationManifold();
+    double total = 0.0;
+    for (const auto & p : *this)
+    {
+        total += p.mass_;
+    }
+
+    if (!(total > 0.0))
+    {
+        return false;
+    }
+
+    // Weighted mean
+    const std::size_t n = centers.front().size();
+    mean = DACE::AlgebraicVector<double>(n, 0.0);
+    for (std::size_t i = 0; i < centers.size(); i++)
+    {
+        mean += (this->at(i).mass_ / total) * centers[i];
+    }
+
+    // Weighted covariance
+    covariance.assign(n, DACE::AlgebraicVector<double>(n, 0.0));
+    for (std::size_t i = 0; i < centers.size(); i++)
+    {
+        double w = this->at(i).mass_ / total;
+        auto d = centers[i] - mean;
+        for (std::size_t a = 0; a < n; a++)
+        {
+            for (std::size_t b = 0; b < n; b++)
+            {
+                covariance[a][b] += w * d[a] * d[b];
+            }
+        }
+    }
+
+    return true;
+}
+
 std::vector<std::vector<DACE::AlgebraicVector<double>>> Manifold::wallsPointEvaluationManifold()
 {
     // Result vector to be returned
@@ -950,14 +1208,11 @@ std::vector<std::vector<DACE::AlgebraicVector<double>>> Manifold::wallsPointEval
 }
 
 
-Manifold* Manifold::get_initial_split_domain()
+Manifold Manifold::get_initial_split_domain()
 {
-    // Create manifold to return TODO: What the fuck, why it is copied from this class? After it is cleared...
-    auto splitbox = new Manifold(*this);
-    splitbox->clear();
-
-    // TODO: Reserve, since we know the amount of patches
-    // splitbox->shrink_to_fit();
+    // Create manifold to return, sharing the integrator of this one
+    Manifold splitbox;
+    splitbox.integrator_ = this->integrator_;
 
     // Replay history for every path
     for (auto & p : *this)
@@ -966,7 +1221,7 @@ Manifold* Manifold::get_initial_split_domain()
         auto new_p = p.replay();
 
         // Push back in the box manifold
-        splitbox->push_back(new_p);
+        splitbox.push_back(new_p);
     }
 
     return splitbox;
@@ -985,10 +1240,10 @@ void Manifold::summary(std::string * summary2return, bool recursive)
     // Pointers
     *summary2return += tools::string::print2string("Manifold (%p): integrator flag set to '%p'\n",
                                                    this, this->integrator_);
-    *summary2return += tools::string::print2string("Manifold (%p): ini_domain_record flag set to '%p'\n",
-                                                   this, this->ini_domain_record);
-    *summary2return += tools::string::print2string("Manifold (%p): fin_domain_record flag set to '%p'\n",
-                                                   this, this->fin_domain_record);
+    *summary2return += tools::string::print2string("Manifold (%p): ini_domain_record size set to '%zu'\n",
+                                                   this, this->ini_domain_record.size());
+    *summary2return += tools::string::print2string("Manifold (%p): fin_domain_record size set to '%zu'\n",
+                                                   this, this->fin_domain_record.size());
     // Recursive?
     if (recursive)
     {
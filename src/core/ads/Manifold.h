@@ -11,10 +11,15 @@
 // System libraries
 #include <deque>
 #include <algorithm>
+#include <map>
+#include <memory>
 
 // Project libraries
 #include "Patch.h"
 #include "integrator.h"
+#include "checkpoint.h"
+#include "budget.h"
+#include "split_plan.h"
 
 struct Observable;
 
@@ -32,10 +37,23 @@ public: // Constructors
     Manifold();
 
     /**
-     * Builds from another manifold.
+     * Builds from another manifold: patches, integrator and every setting.
      * @param m
      */
-    Manifold(const Manifold& m);
+    Manifold(const Manifold& m) = default;
+
+    /**
+     * Moves another manifold.
+     * @param m
+     */
+    Manifold(Manifold&& m) = default;
+
+    /**
+     * Copy and move assignments, consistent with the constructors.
+     * @param m
+     */
+    Manifold& operator=(const Manifold& m) = default;
+    Manifold& operator=(Manifold&& m) = default;
 
     /**
      * Build class from Patch object
@@ -53,13 +71,60 @@ private:
     // Attributes
     integrator* integrator_ = nullptr;
 
-    // Domain evolution
-    std::vector<Manifold*>* ini_domain_record = new std::vector<Manifold*>();
-    std::vector<Manifold*>* fin_domain_record = new std::vector<Manifold*>();
+    // Domain evolution, empty unless recorded
+    std::vector<Manifold> ini_domain_record{};
+    std::vector<Manifold> fin_domain_record{};
+
+    // Periodic checkpoints
+    checkpoint::settings checkpoint_{};
+
+    // Coarsening: relative tolerance to merge siblings back, disabled if zero
+    double merge_tolerance_ = 0.0;
+
+    // Budget: caps and order of the pending patches
+    budget::settings budget_{};
+
+    // How the patches violating the threshold are cut
+    split_plan::settings split_plan_{};
+
+    // Standard deviations from the center to the wall of the initial box, to weight the finished patches. Not
+    // weighted if zero
+    double confidence_interval_ = 0.0;
 
 public:
     // Setters
 
+    /**
+     * Sets periodic checkpoints while splitting
+     * @param settings [in] [checkpoint::settings]
+     */
+    void set_checkpoint(const checkpoint::settings& settings) { this->checkpoint_ = settings; }
+
+    /**
+     * Sets the coarsening of the finished patches
+     * @param tolerance [in] [double] relative tolerance to merge siblings, zero to disable it
+     */
+    void set_merge_tolerance(double tolerance) { this->merge_tolerance_ = tolerance; }
+
+    /**
+     * Sets the budget of the splitting
+     * @param settings [in] [budget::settings]
+     */
+    void set_budget(const budget::settings& settings) { this->budget_ = settings; }
+
+    /**
+     * Sets how the patches violating the threshold are cut
+     * @param settings [in] [split_plan::settings]
+     */
+    void set_split_plan(const split_plan::settings& settings) { this->split_plan_ = settings; }
+
+    /**
+     * Sets the confidence interval of the initial box, so that the finished patches are weighted by their probability
+     * mass
+     * @param confidence_interval [in] [double] zero to leave them unweighted
+     */
+    void set_confidence_interval(double confidence_interval) { this->confidence_interval_ = confidence_interval; }
+
     /**
      * Sets integrator pointer
      * @param integrator [in] [integrator]
@@ -77,11 +142,11 @@ public:
 
 
     /**
-     * Gets pointer to domain record
-     * @return std::vector<Manifold*>*
+     * Gets domain record
+     * @return std::vector<Manifold>&
      */
-    auto get_ini_domain_record() {return this->ini_domain_record; }
-    auto get_fin_domain_record() {return this->fin_domain_record; }
+    auto& get_ini_domain_record() {return this->ini_domain_record; }
+    auto& get_fin_domain_record() {return this->fin_domain_record; }
 
 public: // Methods
 
@@ -93,7 +158,22 @@ public: // Methods
      * @return Manifold*
      */
     Manifold* getSplitDomain(const std::vector<double>& errToll, int nSplitMax, int posOverride = 0);
-    Manifold* getSplitDomain(ALGORITHM algorithm, int nSplitMax, bool domain_evolution = true);
+
+    /**
+     * Main runninng class function, it splits the domains while integrating the dynamics of the object.
+     * @details With a budget, the pending patches are processed by priority and, once a cap is hit, the remaining ones
+     * are integrated up to the final time without splitting and flagged.
+     * @param algorithm         [in] [ALGORITHM]
+     * @param nSplitMax         [in] [int]
+     * @param domain_evolution  [in] [bool]
+     * @param results           [in] [std::unique_ptr<Manifold>] already finished patches when resuming, nullptr
+     *                          otherwise
+     * @param split_counter     [in/out] [int*] identifier of the next patch to be created (split or merged), above
+     *                          every existing one, updated on return. nullptr to start at 1
+     * @return std::unique_ptr<Manifold> finished patches, this manifold is left empty
+     */
+    std::unique_ptr<Manifold> getSplitDomain(ALGORITHM algorithm, int nSplitMax, bool domain_evolution = true,
+                                             std::unique_ptr<Manifold> results = nullptr, int* split_counter = nullptr);
 
     /**
      * Evaluates a point in this manifold, returns the corresponding translation using the proper patch.
@@ -110,6 +190,24 @@ public: // Methods
      */
     std::vector<DACE::AlgebraicVector<double>> centerPointEvaluationManifold();
 
+    /**
+     * Stores in every patch the probability mass of its box, for a Gaussian distribution truncated to the initial box.
+     * @param confidence_interval [in] [double] standard deviations from the center to the wall of the initial box
+     * @return sum of the masses, one if the patches cover the initial box
+     */
+    double set_probability_masses(double confidence_interval);
+
+    /**
+     * Mean and covariance of the centers of the patches (see 'centerPointEvaluationManifold'), weighted by their
+     * probability mass: a cheap approximation of the propagated distribution, without sampling. The spread inside
+     * each patch is not accounted for.
+     * @param mean [out] [DACE::AlgebraicVector<double>]
+     * @param covariance [out] [std::vector<DACE::AlgebraicVector<double>>] one row per variable
+     * @return false if some patch has not been weighted
+     */
+    bool weighted_center_moments(DACE::AlgebraicVector<double>& mean,
+                                 std::vector<DACE::AlgebraicVector<double>>& covariance);
+
     /**
      * Evaluates points at the domain edge of the patches (box), returns them all transposed.
      * @details Returns array per patch, per collection of wall points and the algebraic vector (point coordinates)
@@ -122,16 +220,29 @@ public: // Methods
      * Add new patches to this Manifold.
      * @param new_patches [std::vector<Patch> new_patches]
      * @param split_count [int]
-     * @param dir [int]
+     * @param dirs [std::vector<int>] directions of the cuts the patches come from
      */
-    void add_new_patches(std::vector<Patch> &new_patches, int &split_count, int dir);
+    void add_new_patches(std::vector<Patch> &new_patches, int &split_count, const std::vector<int>& dirs);
+
+    /**
+     * Coarsening pass: merges every complete group of siblings (children of the same split, stopped at the same time)
+     * whose maps are reproduced by one polynomial on the parent box and which would not be split again there.
+     * Repeated until nothing merges, so whole sub-trees can collapse.
+     * @param split_count [in/out] [int] identifier of the next patch to be created
+     * @return number of merges
+     */
+    int coarsen(int & split_count);
 
     /**
      * Prints status of the manifold, this routine is called from the main running routine 'getSplitDomain'
      */
     void print_status();
 
-    Manifold *get_initial_split_domain();
+    /**
+     * Initial box of every patch, replayed from its splitting history.
+     * @return Manifold
+     */
+    Manifold get_initial_split_domain();
 
     void summary(std::string *summary2return, bool recursive);
 
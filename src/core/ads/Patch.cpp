@@ -8,6 +8,7 @@
 /********************************************************************************************/
 
 #include "Patch.h"
+#include "tools/profiler.h"
 
 struct Observable;
 
@@ -169,6 +170,9 @@ unsigned int Patch::getSplittingDirection(const unsigned int comp, DACE::Algebra
 
 std::vector<Patch> Patch::split(int dir, DACE::AlgebraicVector<DACE::DA> obj)
 {
+    // Profile
+    PROFILE_SCOPE(PROFILE_SECTION::SPLIT);
+
     /*
      * Member function to split the Patch \param[in] the hidden input is the 'Patch'
      * int comp: is the component of function DA vector with maximum error
@@ -247,3 +251,120 @@ std::vector<Patch> Patch::split(int dir, DACE::AlgebraicVector<DACE::DA> obj)
 
     return output;
 }
+
+bool Patch::merge(const std::vector<Patch>& siblings, double tolerance, Patch& merged)
+{
+    // Safety check
+    if (siblings.empty() || siblings.front().history.empty())
+    {
+        return false;
+    }
+
+    // Auxiliary variables
+    const auto& first = siblings.front();
+    auto algorithm = first.algorithm_;
+    auto dir = SplittingHistory::getdir(first.history.back());
+    unsigned int n = dir - 1;
+    unsigned int n_var = DACE::DA::getMaxVariables();
+    double scaling = ALGORITHM::LOADS == algorithm ? 1.0/3.0 : 0.5;
+    double center = ALGORITHM::LOADS == algorithm ? 2.0/3.0 : 0.5;
+
+    // Parent polynomial: each child is the parent on 'shift + scaling * y', so the parent is the child on
+    // '(x - shift) / scaling'
+    DACE::AlgebraicVector<DACE::DA> parent(first.size(), 0.0);
+    std::vector<DACE::AlgebraicVector<DACE::DA>> to_child;
+    for (const auto& sibling : siblings)
+    {
+        // Safety check: children of the same split
+        auto val = sibling.history.back();
+        if (SplittingHistory::getdir(val) != dir || sibling.size() != first.size())
+        {
+            return false;
+        }
+
+        // Place of the child in the parent box
+        double shift = SplittingHistory::get_splitting_place(val) == SPLITTING_PLACE::MIDDLE ? 0.0 :
+                       center * (double) tools::math::sgn(val);
+
+        // From the parent box to the child one
+        auto to_parent = DACE::AlgebraicVector<DACE::DA>::identity(n_var);
+        to_parent[n] = (DACE::DA((int) dir) - shift) / scaling;
+        parent += sibling.eval(to_parent);
+
+        // From the child box to the parent one
+        to_child.push_back(DACE::AlgebraicVector<DACE::DA>::identity(n_var));
+        to_child.back()[n] = shift + scaling * DACE::DA((int) dir);
+    }
+    parent = parent / (double) siblings.size();
+
+    // Every child must be reproduced
+    for (std::size_t k = 0; k < siblings.size(); k++)
+    {
+        const DACE::AlgebraicVector<DACE::DA>& child = siblings[k];
+        auto diff = child - parent.eval(to_child[k]);
+        for (unsigned int i = 0; i < diff.size(); i++)
+        {
+            // Mismatch relative to the variation of the child over its box
+            double variation = (siblings[k][i] - siblings[k][i].cons()).norm(1);
+            if (diff[i].norm(1) > tolerance * variation)
+            {
+                return false;
+            }
+        }
+    }
+
+    // History of the parent: the last split is undone
+    auto history = first.history;
+    auto times = first.times;
+    auto nlis = first.nlis;
+    history.pop_back();
+    double t_split = times.size() > 1 ? times[times.size() - 2] : -1;
+    double nli = nlis.empty() ? -1 : nlis.back();
+    if (!times.empty()) { times.pop_back(); }
+    if (!nlis.empty()) { nlis.pop_back(); }
+
+    // Build it
+    merged = Patch(parent, history, times, nlis, algorithm, first.t_, nli, t_split);
+    merged.betas = first.betas;
+    if (ALGORITHM::LOADS == algorithm && n < merged.betas.size())
+    {
+        // Scaling of the parent box
+        merged.betas[n] *= 3;
+    }
+    for (const auto& sibling : siblings)
+    {
+        merged.order_ = std::max(merged.order_, sibling.order_);
+        merged.budget_limited_ = merged.budget_limited_ || sibling.budget_limited_;
+    }
+
+    return true;
+}
+
+double Patch::probability_mass(double confidence_interval) const
+{
+    // Box of the patch in the initial one, [-1, 1] in every direction
+    auto c = this->history.center(this->algorithm_);
+    auto w = this->history.width(this->algorithm_);
+
+    // Mass of the initial box
+    double full = std::erf(confidence_interval / std::sqrt(2.0));
+
+    // Product of the masses along the split directions
+    double mass = 1.0;
+    for (std::size_t n = 0; n < c.size(); n++)
+    {
+        // Not split in this direction
+        if (w[n] >= 2.0)
+        {
+            continue;
+        }
+
+        // Walls in standard deviations
+        double lower = confidence_interval * (c[n] - 0.5 * w[n]) / std::sqrt(2.0);
+        double upper = confidence_interval * (c[n] + 0.5 * w[n]) / std::sqrt(2.0);
+        mass *= 0.5 * (std::erf(upper) - std::erf(lower)) / full;
+    }
+
+    return mass;
+}
+
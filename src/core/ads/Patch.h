@@ -29,6 +29,18 @@ public:
     int id_ = 0;
     ALGORITHM algorithm_{ALGORITHM::NONE};
 
+    // Truncation order the patch is integrated at, 0 for the algebra one (adaptive order disabled or not yet set)
+    int order_ = 0;
+
+    // Integrated without splitting because the budget of the propagation was exhausted
+    bool budget_limited_ = false;
+
+    // Probability mass of the box of the patch, -1 until the finished manifold is weighted
+    double mass_ = -1.0;
+
+    // Priority in the queue of a budgeted splitting, computed once when the patch is queued
+    double priority_ = 0.0;
+
     // Auxiliary variables
     double scaling;
     double center;
@@ -81,12 +93,31 @@ public:
 
     static unsigned int getSplittingDirection(unsigned int comp, AlgebraicVector <DACE::DA> algebraicVector);
 
+    /**
+     * Undo a split: rebuild the polynomial on the parent box from every child of the split (the average of what each
+     * child says about it) and accept it only if it reproduces all of them within the relative tolerance.
+     * @param siblings [in] [std::vector<Patch>] every child of one split, at the same time
+     * @param tolerance [in] [double] allowed mismatch, relative to the variation of each child component
+     * @param merged [out] [Patch] parent patch, identifier not set
+     * @return true if merged
+     */
+    static bool merge(const std::vector<Patch>& siblings, double tolerance, Patch& merged);
+
+    /**
+     * Probability mass of the box of the patch, for a Gaussian distribution truncated to the initial box.
+     * @param confidence_interval [in] [double] standard deviations from the center to the wall of the initial box
+     * @return double in (0, 1]
+     */
+    [[nodiscard]] double probability_mass(double confidence_interval) const;
+
 
     ////////////////////////////////////////////////////////////////////////////////
     /*HISTORY WRAPPER                                                             */
     ////////////////////////////////////////////////////////////////////////////////
     auto history_is_empty() { return this->history.empty(); }
-    auto get_history_int() {return (std::vector<int>)this->history;}
+    [[nodiscard]] const SplittingHistory& get_history() const { return this->history; }
+    auto get_history_int() {return this->history.to_vector();}
+    auto get_tree_id() { return this->history.tree_id(); }
     auto get_history_count(int n = 0) {return (int)this->history.count(n); }
     auto history_contains(std::vector<double> pt) { return this->history.contain(std::move(pt), this->algorithm_); }
     auto get_center() { return this->history.center(this->algorithm_); }
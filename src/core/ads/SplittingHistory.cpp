@@ -8,42 +8,22 @@
 /********************************************************************************************/
 #include "SplittingHistory.h"
 
+// System libraries
+#include <algorithm>
+#include <stdexcept>
+
 ////////////////////////////////////////////////////////////////////////////////
 /*CONSTRUCTORS                                                                */
 ////////////////////////////////////////////////////////////////////////////////
-SplittingHistory::SplittingHistory() : std::vector<int>() {
-    /*! Default Constructor to create empty SplittingHistory object*/
-}
-
-SplittingHistory::SplittingHistory(unsigned int size) : std::vector<int>(size){
-    /*! Constructor with size to allocate a vector of the given size with elements initialized using their default constructor.
-       \param[in] size length of SplittingHistory.
-     */
-}
-
-SplittingHistory::SplittingHistory(unsigned int size, const int &d) : std::vector<int>(size, d){
-    /*! Constructor with size and elements value to allocate a vector of the given size with elements initialized as copies of d.
-       \param[in] size length of SplittingHistory
-       \param[in] d  initial value for the elements
-     */
-}
-
-SplittingHistory::SplittingHistory(const std::vector<int> &v) : std::vector<int>(v){
-    /*! Copy constructor to create a copy of any existing vector.
-      \param[in] v vector to be copied into PatchVector
+SplittingHistory::SplittingHistory(const std::vector<int> &v)
+{
+    /*! Constructor from the legacy format, one integer per split.
+      \param[in] v vector to be packed into SplittingHistory
     */
-}
-
-SplittingHistory::SplittingHistory(const std::vector<int> &v, unsigned int first, unsigned int last) : std::vector<int>(v.begin()+first, v.begin()+last+1){
-    /*! Extraction constructor to copy only a given range of elements from vector v.
-       \param[in] v vector to be copied into PatchVector
-       \param[in] first index of the first element to be copied
-       \param[in] last index of the last element to be copied
-       \note The constructor does not perform any range checking for the extraction.
-     */
-        // Notice that the range in the std::vector constructor above includes all
-        // elements between first and last, including the first excluding the last.
-        // Hence the +1.
+    for (const auto& val : v)
+    {
+        this->push_back(val);
+    }
 }
 
 template <typename T> int sgn(T val)
@@ -66,10 +46,26 @@ std::ostream& operator<<(std::ostream& os, const SplittingHistory &obj) {
     return os;
 }
 
+bool SplittingHistory::operator<(const SplittingHistory &other) const
+{
+    // First level that differs
+    auto n = std::min(this->size(), other.size());
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (this->code(i) != other.code(i))
+        {
+            return (*this)[i] < other[i];
+        }
+    }
+
+    // Prefix first
+    return this->depth_ < other.depth_;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /*MEMBER FUNCTION                                                             */
 ////////////////////////////////////////////////////////////////////////////////
-unsigned int SplittingHistory::count(unsigned int n)
+unsigned int SplittingHistory::count(unsigned int n) const
 {
     /* member fuction to compute the number of splits in varius direction
        INPUT  param[in] the splitting history vector is the hidden object of function
@@ -79,16 +75,132 @@ unsigned int SplittingHistory::count(unsigned int n)
     if ( n == 0) {return this -> size();}
     else {
         unsigned int c = 0;
-        for ( int i = 0; i < this -> size(); ++i) {
-            if ( abs(this -> at(i)) == n ) { c += 1;} // TODO: FIX THIS... IT DOESN'T WORK WITH LOADS
+        for ( std::size_t i = 0; i < this -> size(); ++i) {
+            if ( SplittingHistory::getdir((*this)[i]) == n ) { c += 1;}
     }
 
       return c;
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/*CONTAINER                                                                   */
+////////////////////////////////////////////////////////////////////////////////
+void SplittingHistory::push_back(int val)
+{
+    // Safety check
+    if (this->depth_ >= SplittingHistory::capacity)
+    {
+        throw std::runtime_error("error in 'SplittingHistory::push_back': the history is full, no more than '" +
+                                 std::to_string(SplittingHistory::capacity) + "' splits fit");
+    }
+
+    // Pack it in its slot
+    auto i = (std::size_t) this->depth_;
+    auto shift = SplittingHistory::bits_per_split * (i % SplittingHistory::splits_per_word);
+    this->words_[i / SplittingHistory::splits_per_word] |= (std::uint64_t) SplittingHistory::encode(val) << shift;
+    this->depth_++;
+}
+
+void SplittingHistory::pop_back()
+{
+    // Clear the last slot
+    this->depth_--;
+    auto i = (std::size_t) this->depth_;
+    auto shift = SplittingHistory::bits_per_split * (i % SplittingHistory::splits_per_word);
+    this->words_[i / SplittingHistory::splits_per_word] &= ~((std::uint64_t) 0x3F << shift);
+}
+
+std::vector<int> SplittingHistory::to_vector() const
+{
+    // Unpack every level
+    std::vector<int> v(this->size());
+    for (std::size_t i = 0; i < v.size(); ++i)
+    {
+        v[i] = (*this)[i];
+    }
+
+    return v;
+}
+
+unsigned int SplittingHistory::encode(int val)
+{
+    // Direction and place
+    auto dir = SplittingHistory::getdir(val);
+    auto place = SplittingHistory::get_splitting_place(val);
+
+    // Safety check
+    if (dir == 0 || dir > SplittingHistory::max_direction || (place == SPLITTING_PLACE::MIDDLE && val % 100 != 0))
+    {
+        throw std::runtime_error("error in 'SplittingHistory::encode': cannot pack the split '" + std::to_string(val) +
+                                 "', directions go from 1 to " + std::to_string(SplittingHistory::max_direction));
+    }
+
+    // Place in the two low bits: 1 left, 2 right, 3 middle; never zero
+    unsigned int place_bits = place == SPLITTING_PLACE::LEFT ? 1 : place == SPLITTING_PLACE::RIGHT ? 2 : 3;
+
+    return (dir << 2) | place_bits;
+}
+
+int SplittingHistory::decode(unsigned int code)
+{
+    // Direction and place
+    auto dir = (int) (code >> 2);
+    auto place_bits = code & 0x3u;
+
+    return place_bits == 1 ? -dir : place_bits == 2 ? dir : dir * 100;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/*PATCH TREE                                                                  */
+////////////////////////////////////////////////////////////////////////////////
+SplittingHistory SplittingHistory::parent() const
+{
+    auto p = *this;
+    p.pop_back();
+    return p;
+}
+
+SplittingHistory SplittingHistory::child(int val) const
+{
+    auto c = *this;
+    c.push_back(val);
+    return c;
+}
+
+bool SplittingHistory::is_parent_of(const SplittingHistory &other) const
+{
+    return !other.empty() && other.parent() == *this;
+}
+
+bool SplittingHistory::is_sibling_of(const SplittingHistory &other) const
+{
+    // Same level below the root, same box above
+    if (this->empty() || this->depth_ != other.depth_ || this->parent() != other.parent())
+    {
+        return false;
+    }
+
+    // Same direction
+    return SplittingHistory::getdir(this->back()) == SplittingHistory::getdir(other.back());
+}
+
+std::string SplittingHistory::tree_id() const
+{
+    // One character per packed split
+    static const char alphabet[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz-_";
+
+    std::string id(1 + this->size(), 'r');
+    for (std::size_t i = 0; i < this->size(); ++i)
+    {
+        id[i + 1] = alphabet[this->code(i)];
+    }
+
+    return id;
+}
+
 
-DACE::AlgebraicVector<DACE::DA> SplittingHistory::replay( ALGORITHM algorithm, DACE::AlgebraicVector<DACE::DA> obj)
+DACE::AlgebraicVector<DACE::DA> SplittingHistory::replay( ALGORITHM algorithm, DACE::AlgebraicVector<DACE::DA> obj) const
 {
     /*member function to replicate the box splitted by means the assigned splitting history
     INPUT param[in]: the splitting history vector is the hidden object of function
@@ -146,7 +258,7 @@ DACE::AlgebraicVector<DACE::DA> SplittingHistory::replay( ALGORITHM algorithm, D
  * @return
  */
 
-std::vector<double> SplittingHistory::center(ALGORITHM algorithm)
+std::vector<double> SplittingHistory::center(ALGORITHM algorithm) const
 {
     /*member function to compute the center of the box after the splitting represented by the splitting history vector
     INPUT param[in] the splitting history vector is the hidden object of function
@@ -194,7 +306,7 @@ std::vector<double> SplittingHistory::center(ALGORITHM algorithm)
       return c;
 }
 
-std::vector<double> SplittingHistory::width(ALGORITHM algorithm)
+std::vector<double> SplittingHistory::width(ALGORITHM algorithm) const
 {
     /* member function to compute the width of the box after the splitting represented by the splitting history vector
     INPUT param[in] the splitting history vector is the hidden object of function
@@ -218,7 +330,7 @@ std::vector<double> SplittingHistory::width(ALGORITHM algorithm)
 }
 
 
-bool SplittingHistory::contain(std::vector<double> pt, ALGORITHM algorithm)
+bool SplittingHistory::contain(std::vector<double> pt, ALGORITHM algorithm) const
 {
     /* member function to know if a point belong to an assigned box
     INPUT pt: vector conteining the point to check the belonging
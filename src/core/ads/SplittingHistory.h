@@ -9,8 +9,12 @@
 #pragma once
 
 // System libraries
-#include <vector>
+#include <array>
 #include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
 
 // Project libraries
 #include "base/enums.h"
@@ -20,24 +24,37 @@
 #include "dace/dace.h"
 
 
-class SplittingHistory : public std::vector<int>
+/**
+ * Splitting history of a patch: the split it comes from at every level of the patch tree, from the root box.
+ * @details Every split is packed in 6 bits, its direction (4 bits) and its place in the parent box (2 bits), in a
+ * fixed array of words, so a history is a small trivially copyable value: no allocation per patch and cheap copies
+ * into every child. The legacy integer format (-dir left, +dir right, dir*100 middle) is what goes in and out.
+ */
+class SplittingHistory
 {
+public: // Layout
+    static constexpr unsigned int bits_per_split = 6;
+    static constexpr unsigned int splits_per_word = 64 / SplittingHistory::bits_per_split;
+    static constexpr unsigned int n_words = 3;
+
+    // Deepest history and highest direction that fit
+    static constexpr unsigned int capacity = SplittingHistory::splits_per_word * SplittingHistory::n_words;
+    static constexpr unsigned int max_direction = 15;
+
+private: // Attributes
+    std::array<std::uint64_t, SplittingHistory::n_words> words_{};
+    std::uint8_t depth_{0};
+
 public:
     ////////////////////////////////////////////////////////////////////////////////
     /*CONSTRUCTORS                                                                */
     ////////////////////////////////////////////////////////////////////////////////
     /**
-     * Default constructor.
+     * Default constructor: the root box.
      */
-    SplittingHistory();                                                          // >! default constructor
-
-    SplittingHistory(unsigned int size);                                                    // >! Constructor with dimension gives by size
-
-    SplittingHistory(unsigned int size, const int &d);                                      // >! Constructor with dimension and equal element give by size and d
+    SplittingHistory() = default;                                                 // >! default constructor
 
-    SplittingHistory(const std::vector<int> &v);                                            // >! Copy constructor of vector
-
-    SplittingHistory(const std::vector<int> &v, unsigned int first, unsigned int last);     // >! Copy constructor of
+    SplittingHistory(const std::vector<int> &v);                                  // >! Constructor from the legacy format
 
 public:
     ////////////////////////////////////////////////////////////////////////////////
@@ -51,11 +68,99 @@ public:
      */
     friend std::ostream& operator<<(std::ostream& os, const SplittingHistory &obj);
 
+    /**
+     * Split at a level, in the legacy format.
+     * @param i [in] [std::size_t] level, 0 for the first split
+     * @return int
+     */
+    int operator[](std::size_t i) const { return SplittingHistory::decode(this->code(i)); }
+
+    bool operator==(const SplittingHistory &other) const
+    {
+        return this->depth_ == other.depth_ && this->words_ == other.words_;
+    }
+    bool operator!=(const SplittingHistory &other) const { return !(*this == other); }
+
+    /**
+     * Strict order of the legacy format (lexicographic, as 'std::vector<int>'): to be used as a key.
+     */
+    bool operator<(const SplittingHistory &other) const;
+
+public: // Container
+    ////////////////////////////////////////////////////////////////////////////////
+    /*CONTAINER                                                                   */
+    ////////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] std::size_t size() const { return this->depth_; }
+    [[nodiscard]] bool empty() const { return this->depth_ == 0; }
+
+    /**
+     * Last split, in the legacy format. The history must not be empty.
+     * @return int
+     */
+    [[nodiscard]] int back() const { return (*this)[this->depth_ - 1]; }
+
+    /**
+     * Add a split, in the legacy format. Throws if it does not fit.
+     * @param val [in] [int]
+     */
+    void push_back(int val);
+
+    /**
+     * Undo the last split. The history must not be empty.
+     */
+    void pop_back();
+
+    /**
+     * Legacy format: one integer per split.
+     * @return std::vector<int>
+     */
+    [[nodiscard]] std::vector<int> to_vector() const;
+
+    explicit operator std::vector<int>() const { return this->to_vector(); }
+
+public: // Patch tree
+    ////////////////////////////////////////////////////////////////////////////////
+    /*PATCH TREE                                                                  */
+    ////////////////////////////////////////////////////////////////////////////////
+    /**
+     * History of the parent box: the last split undone. The history must not be empty.
+     * @return SplittingHistory
+     */
+    [[nodiscard]] SplittingHistory parent() const;
+
+    /**
+     * History of a child box.
+     * @param val [in] [int] split, in the legacy format
+     * @return SplittingHistory
+     */
+    [[nodiscard]] SplittingHistory child(int val) const;
+
+    /**
+     * Is this the parent box of 'other'?
+     * @param other [in] [SplittingHistory]
+     * @return bool
+     */
+    [[nodiscard]] bool is_parent_of(const SplittingHistory &other) const;
+
+    /**
+     * Do both come from the same split of the same box (the same history being its own sibling)?
+     * @param other [in] [SplittingHistory]
+     * @return bool
+     */
+    [[nodiscard]] bool is_sibling_of(const SplittingHistory &other) const;
+
+    /**
+     * Identifier of the node in the patch tree, stable across runs: 'r' for the root box and one character per split.
+     * The identifier of the parent is this one without its last character.
+     * @return std::string
+     */
+    [[nodiscard]] std::string tree_id() const;
+
 public: // Methods
     ////////////////////////////////////////////////////////////////////////////////
     /*MEMBER FUNCTION                                                             */
     ////////////////////////////////////////////////////////////////////////////////
-    unsigned int count(unsigned int n = 0);                                                                       // >! Function to count the number of splits (default is total splits)
+    unsigned int count(unsigned int n = 0) const;                                                                       // >! Function to count the number of splits (default is total splits)
 
     /**
      * Function to replicate the split box: that is, the initial box split
@@ -66,21 +171,21 @@ public: // Methods
      * @param algorithm [in] [ALGORITHM]
      * @return
      */
-    DACE::AlgebraicVector<DACE::DA> replay( ALGORITHM algorithm, DACE::AlgebraicVector<DACE::DA>  obj = DACE::AlgebraicVector<DACE::DA>::identity());
+    DACE::AlgebraicVector<DACE::DA> replay( ALGORITHM algorithm, DACE::AlgebraicVector<DACE::DA>  obj = DACE::AlgebraicVector<DACE::DA>::identity()) const;
 
     /**
      *
      * @param algorithm
      * @return
      */
-    std::vector<double> center( ALGORITHM algorithm);                                                                                 // >! Function to compute the center
+    std::vector<double> center( ALGORITHM algorithm) const;                                                                                 // >! Function to compute the center
 
     /**
      *
      * @param algorithm
      * @return
      */
-    std::vector<double> width( ALGORITHM algorithm);                                                                                  // >! Function to compute the center
+    std::vector<double> width( ALGORITHM algorithm) const;                                                                                  // >! Function to compute the center
 
     /**
      *
@@ -102,6 +207,24 @@ public: // Methods
      * @param algorithm
      * @return
      */
-    bool contain (std::vector<double> pt, ALGORITHM algorithm);                                                                        // >! Function to verify the point belonging of point
+    bool contain (std::vector<double> pt, ALGORITHM algorithm) const;                                                                        // >! Function to verify the point belonging of point
 
+private:
+    /**
+     * Packed split at a level.
+     * @param i [in] [std::size_t]
+     * @return unsigned int
+     */
+    [[nodiscard]] unsigned int code(std::size_t i) const
+    {
+        return (unsigned int) (this->words_[i / SplittingHistory::splits_per_word] >>
+                               (SplittingHistory::bits_per_split * (i % SplittingHistory::splits_per_word))) & 0x3Fu;
+    }
+
+    /**
+     * Pack a split given in the legacy format, and unpack it back.
+     */
+    static unsigned int encode(int val);
+    static int decode(unsigned int code);
 };
+
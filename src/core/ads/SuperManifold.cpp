@@ -17,7 +17,7 @@ void SuperManifold::set_integrator_ptr(integrator* integrator)
     }
 
     // Creating new current manifold from integrator
-    this->current_ = new Manifold(integrator->get_scv());
+    this->current_ = std::make_unique<Manifold>(integrator->get_scv());
 
     // Set there the error tolerances and the maximum number of splits
     if (this->algorithm_ == ALGORITHM::ADS)
@@ -46,8 +46,8 @@ void SuperManifold::set_integrator_ptr(integrator* integrator)
 
     // Info
     std::fprintf(stdout, "SuperManifold successfully built in: '%p'\n", this);
-    std::fprintf(stdout, "\t-> Previous Manifold in: '%p'\n", this->previous_);
-    std::fprintf(stdout, "\t-> Current Manifold in: '%p'\n", this->current_);
+    std::fprintf(stdout, "\t-> Previous Manifold in: '%p'\n", this->previous_.get());
+    std::fprintf(stdout, "\t-> Current Manifold in: '%p'\n", this->current_.get());
 
 }
 
@@ -64,7 +64,7 @@ void SuperManifold::split_domain(std::string * propagation_summary)
     }
 
     // Current passes to be previous in a new pointer
-    this->previous_ =  new Manifold(*this->current_);
+    this->previous_ = std::make_unique<Manifold>(*this->current_);
 
     // Summary check before launching algorithm, if not nullptr
     if (propagation_summary != nullptr)
@@ -76,8 +76,11 @@ void SuperManifold::split_domain(std::string * propagation_summary)
     // Split domain: get current domain
     if (this->algorithm_ != ALGORITHM::NA)
     {
+        // Fresh run: identifiers start after the initial patch
+        this->split_count_ = 1;
+
         // Integrate and/or split
-        this->current_ = this->current_->getSplitDomain(this->algorithm_, this->nSplitMax_);
+        this->propagate_current(this->current_->get_integrator_ptr()->get_initial_time());
     }
     else
     {
@@ -87,7 +90,251 @@ void SuperManifold::split_domain(std::string * propagation_summary)
 
 }
 
-Manifold *SuperManifold::get_manifold_ini() const
+void SuperManifold::extend_domain(double t1)
+{
+    // Safety check that the domain has already been split once
+    if (this->current_ == nullptr || this->previous_ == nullptr)
+    {
+        // Throw FTL
+        std::fprintf(stderr, "Cannot extend the domain before splitting it!\n");
+
+        // Exit program
+        std::exit(-1);
+    }
+
+    // Keep the manifold of the segment just finished, in memory or spilled to disk
+    auto integ = this->current_->get_integrator_ptr();
+    this->segment_times_.push_back(integ->get_final_time());
+    if (this->spill_dir_.empty())
+    {
+        this->segments_.push_back(std::make_unique<Manifold>(*this->current_));
+    }
+    else
+    {
+        auto spill_path = this->spill_dir_ / tools::string::print2string("segment_%zu.bin", this->segments_.size());
+        checkpoint::save_manifold(spill_path, *this->current_);
+        this->segments_.push_back(nullptr);
+    }
+
+    // Move the final time of the integrator
+    double t_start = integ->get_final_time();
+    integ->extend_final_time(t1);
+
+    // Integrate and/or split from where every patch stopped
+    this->propagate_current(t_start);
+}
+
+void SuperManifold::propagate_current(double t_start)
+{
+    // Auxiliary variables
+    auto integ = this->current_->get_integrator_ptr();
+    double t_end = integ->get_final_time();
+
+    // First coarsening stop
+    if (this->coarsening_interval_ > 0.0 && t_start + this->coarsening_interval_ < t_end)
+    {
+        integ->set_stop_time(t_start, t_start + this->coarsening_interval_);
+    }
+
+    while (true)
+    {
+        // Integrate and/or split up to the next stop, siblings finished together are merged there
+        // The old manifold is left empty and released at the end of the iteration
+        auto finished = std::move(this->current_);
+        finished->set_checkpoint(this->checkpoint_);
+        finished->set_merge_tolerance(this->coarsening_tolerance_);
+        finished->set_budget(this->budget_);
+        finished->set_split_plan(this->split_plan_);
+        finished->set_confidence_interval(this->confidence_interval_);
+        this->current_ = finished->getSplitDomain(this->algorithm_, this->nSplitMax_, true, nullptr,
+                                                  &this->split_count_);
+
+        // Final time reached
+        if (integ->get_final_time() >= t_end)
+        {
+            break;
+        }
+
+        // Info
+        std::fprintf(stdout, "SuperManifold: coarsening stop at '%.6f' with '%zu' patches.\n",
+                     integ->get_final_time(), this->current_->size());
+
+        // Next stop
+        integ->extend_final_time(std::min(integ->get_final_time() + this->coarsening_interval_, t_end));
+    }
+}
+
+void SuperManifold::extend_domain(const std::vector<double>& epochs)
+{
+    // Safety check that the domain has already been split once
+    if (this->current_ == nullptr)
+    {
+        // Throw FTL
+        std::fprintf(stderr, "Cannot extend the domain before splitting it!\n");
+
+        // Exit program
+        std::exit(-1);
+    }
+
+    for (const auto & epoch : epochs)
+    {
+        // Already reached
+        if (epoch <= this->current_->get_integrator_ptr()->get_final_time())
+        {
+            continue;
+        }
+
+        // Info
+        std::fprintf(stdout, "SuperManifold: segment '%zu' finished with '%zu' patches, extending to '%.6f'.\n",
+                     this->segments_.size(), this->current_->size(), epoch);
+
+        // Next segment
+        this->extend_domain(epoch);
+    }
+}
+
+void SuperManifold::resume_domain(const std::filesystem::path& file_path, std::string * propagation_summary)
+{
+    // Safety check that current manifold is available
+    if (this->current_ == nullptr)
+    {
+        // Throw FTL
+        std::fprintf(stderr, "Current manifold is nullptr! Must be set prior to resume it!\n");
+
+        // Exit program
+        std::exit(-1);
+    }
+
+    // Load pending and finished patches
+    Manifold pending;
+    Manifold finished;
+    int split_count = 1;
+
+    try
+    {
+        checkpoint::load(file_path, pending, finished, split_count, *this->current_->get_integrator_ptr());
+    }
+    catch (const std::runtime_error& e)
+    {
+        // Throw FTL
+        std::fprintf(stderr, "Cannot resume from checkpoint: %s\n", e.what());
+
+        // Exit program
+        std::exit(-1);
+    }
+
+    // Keep integrating and/or splitting
+    this->continue_domain(pending, finished, split_count, propagation_summary);
+}
+
+void SuperManifold::continue_domain(const Manifold& pending, const Manifold& finished, int split_count,
+                                    std::string * propagation_summary)
+{
+    // Safety check that current manifold is available
+    if (this->current_ == nullptr)
+    {
+        // Throw FTL
+        std::fprintf(stderr, "Current manifold is nullptr! Must be set prior to continue it!\n");
+
+        // Exit program
+        std::exit(-1);
+    }
+
+    // Initial domain, as in a fresh run
+    this->previous_ = std::make_unique<Manifold>(*this->current_);
+
+    // Summary check before launching algorithm, if not nullptr
+    if (propagation_summary != nullptr)
+    {
+        // Fill summary
+        this->summary(propagation_summary, true);
+    }
+
+    // Queue and results, the current manifold keeps the integrator. The queue is left empty and released on return
+    auto queue = std::move(this->current_);
+    auto results = std::make_unique<Manifold>(finished);
+    queue->clear();
+    queue->insert(queue->end(), pending.begin(), pending.end());
+
+    // Keep integrating and/or splitting
+    queue->set_checkpoint(this->checkpoint_);
+    queue->set_merge_tolerance(this->coarsening_tolerance_);
+    queue->set_budget(this->budget_);
+    queue->set_split_plan(this->split_plan_);
+    queue->set_confidence_interval(this->confidence_interval_);
+    this->split_count_ = split_count;
+    this->current_ = queue->getSplitDomain(this->algorithm_, this->nSplitMax_, true, std::move(results),
+                                           &this->split_count_);
+}
+
+void SuperManifold::restore_domain(std::vector<Manifold> segments, const std::vector<double>& times,
+                                   std::string * propagation_summary)
+{
+    // Safety check that current manifold is available
+    if (this->current_ == nullptr || segments.empty() || segments.size() != times.size())
+    {
+        // Throw FTL
+        std::fprintf(stderr, "Cannot restore '%zu' segments with '%zu' final times!\n", segments.size(), times.size());
+
+        // Exit program
+        std::exit(-1);
+    }
+
+    // Initial domain, as in a fresh run
+    this->previous_ = std::make_unique<Manifold>(*this->current_);
+
+    // Summary check, if not nullptr
+    if (propagation_summary != nullptr)
+    {
+        // Fill summary
+        this->summary(propagation_summary, true);
+    }
+
+    // Weight them with the current confidence interval
+    if (this->confidence_interval_ > 0.0)
+    {
+        for (auto & segment : segments)
+        {
+            segment.set_probability_masses(this->confidence_interval_);
+        }
+    }
+
+    // Next identifier, above every restored patch
+    this->split_count_ = 1;
+    for (const auto & segment : segments)
+    {
+        for (const auto & p : segment)
+        {
+            this->split_count_ = std::max(this->split_count_, p.id_ + 1);
+        }
+    }
+
+    // Finished segments, in memory or spilled to disk
+    for (std::size_t k = 0; k + 1 < segments.size(); k++)
+    {
+        this->segment_times_.push_back(times[k]);
+        if (this->spill_dir_.empty())
+        {
+            this->segments_.push_back(std::make_unique<Manifold>(segments[k]));
+        }
+        else
+        {
+            auto spill_path = this->spill_dir_ / tools::string::print2string("segment_%zu.bin", this->segments_.size());
+            checkpoint::save_manifold(spill_path, segments[k]);
+            this->segments_.push_back(nullptr);
+        }
+    }
+
+    // Last segment is the current manifold, the integrator is moved to its final time
+    auto integ = this->current_->get_integrator_ptr();
+    if (times.back() > integ->get_final_time())
+    {
+        integ->extend_final_time(times.back());
+    }
+    this->current_->assign(segments.back().begin(), segments.back().end());
+}
+
+Manifold SuperManifold::get_manifold_ini() const
 {
     // Safety checks
     if (!this->current_)
@@ -103,33 +350,69 @@ Manifold *SuperManifold::get_manifold_ini() const
 }
 
 
-void SuperManifold::set_6dof_domain()
+std::size_t SuperManifold::get_segment_count() const
 {
-    if (this->current_)
+    return this->current_ == nullptr ? 0 : this->segments_.size() + 1;
+}
+
+double SuperManifold::get_segment_time(std::size_t k) const
+{
+    // Safety check
+    if (k >= this->get_segment_count())
     {
-        // Set pointers
-        this->att_6dof_fin = new Manifold(*this->current_);
+        throw std::out_of_range(tools::string::print2string("SuperManifold: segment '%zu' out of range, '%zu' available.",
+                                                            k, this->get_segment_count()));
+    }
 
-        // Convert patches
-        for (auto & p : *this->att_6dof_fin)
-        {
-            auto euler_p = quaternion::quaternion2euler_DACE(p[0], p[1], p[2], p[3]);
+    // Last segment is the current manifold
+    return k < this->segments_.size() ? this->segment_times_[k] : this->current_->get_integrator_ptr()->get_final_time();
+}
 
-            p = {
-                    euler_p[0],
-                    euler_p[1],
-                    euler_p[2],
-                    p[4],
-                    p[5],
-                    p[6],
-                 };
-        }
+Manifold* SuperManifold::get_segment(std::size_t k)
+{
+    // Safety check
+    if (k >= this->get_segment_count())
+    {
+        throw std::out_of_range(tools::string::print2string("SuperManifold: segment '%zu' out of range, '%zu' available.",
+                                                            k, this->get_segment_count()));
     }
-    if (this->previous_)
+
+    // Last segment is the current manifold
+    if (k == this->segments_.size())
+    {
+        return this->current_.get();
+    }
+
+    // Kept in memory
+    if (this->segments_[k] != nullptr)
     {
-        this->att_6dof_ini = new Manifold(*this->previous_);
-        // Convert patches
-        for (auto & p : *this->att_6dof_ini)
+        return this->segments_[k].get();
+    }
+
+    // Load back a spilled segment, replacing the previous one loaded
+    if (this->reloaded_ == nullptr || this->reloaded_index_ != k)
+    {
+        // Release the previous one first, so that two are never in memory at the same time
+        this->reloaded_.reset();
+
+        // Copy the initial domain to share its integrator (needed to evaluate), then replace the patches
+        auto segment = std::make_unique<Manifold>(*this->previous_);
+        segment->clear();
+        checkpoint::load_manifold(this->spill_dir_ / tools::string::print2string("segment_%zu.bin", k), *segment);
+        this->reloaded_ = std::move(segment);
+        this->reloaded_index_ = k;
+    }
+
+    return this->reloaded_.get();
+}
+
+void SuperManifold::set_6dof_domain()
+{
+    // Copy of a manifold with the quaternion converted to Euler angles
+    auto to_euler = [](const Manifold& m)
+    {
+        auto att = std::make_unique<Manifold>(m);
+        for (auto & p : *att)
         {
             auto euler_p = quaternion::quaternion2euler_DACE(p[0], p[1], p[2], p[3]);
 
@@ -142,6 +425,17 @@ void SuperManifold::set_6dof_domain()
                     p[6],
             };
         }
+        return att;
+    };
+
+    // Replaces the previous ones, if any
+    if (this->current_)
+    {
+        this->att_6dof_fin = to_euler(*this->current_);
+    }
+    if (this->previous_)
+    {
+        this->att_6dof_ini = to_euler(*this->previous_);
     }
 }
 
@@ -158,15 +452,13 @@ void SuperManifold::summary(std::string * summary2return, bool recursive)
 
     // Pointers
     *summary2return += tools::string::print2string("SuperManifold (%p): current flag set to '%p'\n",
-                                                   this, this->current_);
+                                                   this, this->current_.get());
     *summary2return += tools::string::print2string("SuperManifold (%p): previous flag set to '%p'\n",
-                                                   this, this->previous_);
+                                                   this, this->previous_.get());
     *summary2return += tools::string::print2string("SuperManifold (%p): att_6dof_ini flag set to '%p'\n",
-                                                   this, this->att_6dof_ini);
+                                                   this, this->att_6dof_ini.get());
     *summary2return += tools::string::print2string("SuperManifold (%p): att_6dof_fin flag set to '%p'\n",
-                                                   this, this->att_6dof_fin);
-    *summary2return += tools::string::print2string("SuperManifold (%p): splitbox flag set to '%p'\n",
-                                                   this, this->splitbox_);
+                                                   this, this->att_6dof_fin.get());
 
     // INTEGERS
     *summary2return += tools::string::print2string("SuperManifold (%p): nSplitMax flag set to '%d'\n",
@@ -22,17 +22,17 @@ public:
             : nli_threshold_(nli_treshold), nSplitMax_(nSplitMax), algorithm_(algorithm) {};
 
     /**
-     * Default destructor. TODO: Fix this destructor
+     * Default destructor.
+     * @details Every manifold (previous, current, attitude ones and stored segments) is owned by this class.
      */
     ~ SuperManifold() = default;
 
 
 public:// Attributes
-    Manifold* previous_ = nullptr;
-    Manifold* current_ = nullptr;
-    Manifold* splitbox_ = nullptr;
-    Manifold* att_6dof_fin = nullptr;
-    Manifold* att_6dof_ini = nullptr;
+    std::unique_ptr<Manifold> previous_ = nullptr;
+    std::unique_ptr<Manifold> current_ = nullptr;
+    std::unique_ptr<Manifold> att_6dof_fin = nullptr;
+    std::unique_ptr<Manifold> att_6dof_ini = nullptr;
 
 private:
     // Tolerance error vector
@@ -45,24 +45,172 @@ private:
     // ADS/LOADS?
     ALGORITHM algorithm_{ALGORITHM::NA};
 
+    // Periodic checkpoints
+    checkpoint::settings checkpoint_{};
+
+    // Finished segments of a segmented propagation: manifold and final time of each one. A nullptr manifold has been
+    // spilled to 'spill_dir_' and is loaded back on demand
+    std::vector<std::unique_ptr<Manifold>> segments_{};
+    std::vector<double> segment_times_{};
+    std::filesystem::path spill_dir_{};
+
+    // Last spilled segment loaded back, evicted by the next load so that at most one is in memory
+    std::unique_ptr<Manifold> reloaded_{};
+    std::size_t reloaded_index_{};
+
+    // Coarsening: relative tolerance to merge siblings back (disabled if zero) and time between merging stops (only at
+    // the end of each segment if zero)
+    double coarsening_tolerance_{};
+    double coarsening_interval_{};
+
+    // Identifier of the next patch to be created (split or merged), carried over every segment and coarsening stop
+    int split_count_{1};
+
+    // Budget of the splitting
+    budget::settings budget_{};
+
+    // How the patches violating the threshold are cut
+    split_plan::settings split_plan_{};
+
+    // Confidence interval of the initial box, to weight the final patches by their probability mass. Zero to skip it
+    double confidence_interval_{};
+
 public:
     // Manifold operations
     void split_domain(std::string * propagation_summary = nullptr);
 
+    /**
+     * Keep propagating (and splitting) the current manifold up to a new final time. The initial domain is kept.
+     * @param t1 [in] [double]
+     */
+    void extend_domain(double t1);
+
+    /**
+     * Segmented propagation: extend the current manifold to every epoch in order, keeping the manifold of each
+     * segment. Epochs not later than the current final time are skipped.
+     * @param epochs [in] [std::vector<double>]
+     */
+    void extend_domain(const std::vector<double>& epochs);
+
+    /**
+     * Resume an interrupted 'split_domain' from a checkpoint file. The integrator must be set already, built from the
+     * same inputs, since the initial domain is taken from it.
+     * @param file_path [in] [std::filesystem::path]
+     * @param propagation_summary [in] [std::string*]
+     */
+    void resume_domain(const std::filesystem::path& file_path, std::string * propagation_summary = nullptr);
+
+    /**
+     * Start the splitting from an intermediate state instead of the initial domain: pending patches are integrated
+     * and/or split as usual, finished ones are kept. The integrator must be set already.
+     * @param pending [in] [Manifold]
+     * @param finished [in] [Manifold]
+     * @param split_count [in] [int] identifier of the next patch to be created
+     * @param propagation_summary [in] [std::string*]
+     */
+    void continue_domain(const Manifold& pending, const Manifold& finished, int split_count,
+                         std::string * propagation_summary = nullptr);
+
+    /**
+     * Restore an already propagated domain (e.g. from the cache) instead of propagating it: every segment is given
+     * with its final time, the last one becomes the current manifold. The integrator must be set already.
+     * @param segments [in] [std::vector<Manifold>]
+     * @param times [in] [std::vector<double>]
+     * @param propagation_summary [in] [std::string*]
+     */
+    void restore_domain(std::vector<Manifold> segments, const std::vector<double>& times,
+                        std::string * propagation_summary = nullptr);
+
 public:
     // Setters
     void set_integrator_ptr(integrator *integrator);
 
+    /**
+     * Write periodic checkpoints while splitting.
+     * @param settings [in] [checkpoint::settings]
+     */
+    void set_checkpoint(const checkpoint::settings& settings) { this->checkpoint_ = settings; }
+
+    /**
+     * Spill finished segments to binary files in this directory instead of keeping them in memory.
+     * @param spill_dir [in] [std::filesystem::path]
+     */
+    void set_segment_spill_dir(const std::filesystem::path& spill_dir) { this->spill_dir_ = spill_dir; }
+
+    /**
+     * Merge siblings back when their nonlinearity subsides, so that the number of patches stays bounded.
+     * @param tolerance [in] [double] relative mismatch allowed when rebuilding the parent, zero to disable it
+     * @param interval [in] [double] time between merging stops, zero to merge only at the end of each segment
+     */
+    void set_coarsening(double tolerance, double interval)
+    {
+        this->coarsening_tolerance_ = tolerance;
+        this->coarsening_interval_ = interval;
+    }
+
+    /**
+     * Cap the splitting (patches, memory, wall time) and choose the order of the pending patches. The wall time is
+     * counted from the start in the settings.
+     * @param settings [in] [budget::settings]
+     */
+    void set_budget(const budget::settings& settings) { this->budget_ = settings; }
+
+    /**
+     * Choose how the patches violating the threshold are cut: once along one direction, or along several at once
+     * predicted from the growth of their nonlinearity.
+     * @param settings [in] [split_plan::settings]
+     */
+    void set_split_plan(const split_plan::settings& settings) { this->split_plan_ = settings; }
+
+    /**
+     * Weight the patches of every segment by the probability mass of their box in the initial one.
+     * @param confidence_interval [in] [double] standard deviations from the center to the wall of the initial box
+     */
+    void set_confidence_interval(double confidence_interval) { this->confidence_interval_ = confidence_interval; }
+
 public:
     // Getters
-    [[nodiscard]] Manifold* get_manifold_fin() const {return this->current_; };
+    [[nodiscard]] Manifold* get_manifold_fin() const {return this->current_.get(); };
+
+    /**
+     * Initial box of every patch of the current manifold.
+     * @return Manifold
+     */
+    [[nodiscard]] Manifold get_manifold_ini() const;
 
-    [[nodiscard]] Manifold* get_manifold_ini() const;
+    [[nodiscard]] Manifold* get_att6dof_fin() const {return this->att_6dof_fin.get(); };
+    [[nodiscard]] Manifold* get_att6dof_ini() const {return this->att_6dof_ini.get(); };
+
+    /**
+     * Number of segments propagated so far, the current one included.
+     * @return std::size_t
+     */
+    [[nodiscard]] std::size_t get_segment_count() const;
+
+    /**
+     * Final time of a segment.
+     * @param k [in] [std::size_t] segment index, the last one is the current manifold
+     * @return double
+     */
+    [[nodiscard]] double get_segment_time(std::size_t k) const;
 
-    [[nodiscard]] Manifold* get_att6dof_fin() const {return this->att_6dof_fin; };
-    [[nodiscard]] Manifold* get_att6dof_ini() const {return this->att_6dof_ini; };
+    /**
+     * Manifold at the end of a segment. A spilled segment is loaded back and only kept until another spilled segment is
+     * requested, so the pointer is valid until the next call.
+     * @param k [in] [std::size_t] segment index, the last one is the current manifold
+     * @return Manifold*
+     */
+    Manifold* get_segment(std::size_t k);
 
     void set_6dof_domain();
 
     void summary(std::string *summary2return, bool recursive);
+
+private:
+    /**
+     * Integrate and/or split the current manifold from 't_start' up to the final time of the integrator, stopping at
+     * every coarsening interval so that siblings can be merged on the way.
+     * @param t_start [in] [double]
+     */
+    void propagate_current(double t_start);
 };
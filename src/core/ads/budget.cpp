@@ -0,0 +1,69 @@
+/**
+ * Budget of a propagation.
+ */
+
+#include "budget.h"
+
+// System libraries
+#include <fstream>
+#include <unistd.h>
+
+// Project libraries
+#include "ads/Patch.h"
+
+double budget::resident_memory()
+{
+    // Second field: resident pages
+    std::ifstream statm("/proc/self/statm");
+    std::size_t size{};
+    std::size_t resident{};
+    if (!(statm >> size >> resident))
+    {
+        return 0.0;
+    }
+
+    return (double) resident * (double) sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0);
+}
+
+std::string budget::exhausted(const settings& config, std::size_t patches)
+{
+    // Patches
+    if (config.max_patches > 0 && patches > config.max_patches)
+    {
+        return "patches";
+    }
+
+    // Wall time
+    if (config.max_time > 0.0 &&
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - config.start).count() >= config.max_time)
+    {
+        return "time";
+    }
+
+    // Memory
+    if (config.max_memory > 0.0 && budget::resident_memory() >= config.max_memory)
+    {
+        return "memory";
+    }
+
+    return {};
+}
+
+double budget::priority(const settings& config, const Patch& p)
+{
+    switch (config.priority)
+    {
+        case BUDGET_PRIORITY::MASS:
+        {
+            return p.probability_mass(config.confidence_interval);
+        }
+        case BUDGET_PRIORITY::NLI:
+        {
+            return p.nli;
+        }
+        default:
+        {
+            return 0.0;
+        }
+    }
+}
@@ -0,0 +1,68 @@
+/**
+ * Budget of a propagation: hard caps on patches, memory and wall time, and the order the pending patches are
+ * processed in. Once a cap is hit, the remaining patches are integrated up to the final time without splitting and
+ * flagged, so a usable result is always returned.
+ */
+
+#pragma once
+
+// System libraries
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+// Project libraries
+#include "base/enums.h"
+
+// Forward declarations
+class Patch;
+
+namespace budget
+{
+    /**
+     * Budget configuration
+     */
+    struct settings
+    {
+        // Caps, zero for unlimited
+        std::size_t max_patches{};  // Pending and finished patches
+        double max_memory{};        // Resident memory [MB]
+        double max_time{};          // Wall time since 'start' [s]
+
+        // Order of the pending patches
+        BUDGET_PRIORITY priority{BUDGET_PRIORITY::FIFO};
+
+        // Confidence interval of the initial box, for the probability mass priority
+        double confidence_interval{1.0};
+
+        // Wall time origin
+        std::chrono::steady_clock::time_point start{std::chrono::steady_clock::now()};
+
+        [[nodiscard]] bool enabled() const
+        {
+            return this->max_patches > 0 || this->max_memory > 0.0 || this->max_time > 0.0;
+        }
+    };
+
+    /**
+     * Resident memory of this process, from '/proc/self/statm'.
+     * @return double [MB], 0 if unknown
+     */
+    double resident_memory();
+
+    /**
+     * Check the caps.
+     * @param config [in] [settings]
+     * @param patches [in] [std::size_t] patches there would be after one more split
+     * @return name of the exhausted cap, empty if none
+     */
+    std::string exhausted(const settings& config, std::size_t patches);
+
+    /**
+     * Priority of a pending patch: the highest is processed first.
+     * @param config [in] [settings]
+     * @param p [in] [Patch]
+     * @return double
+     */
+    double priority(const settings& config, const Patch& p);
+}
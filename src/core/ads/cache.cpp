@@ -0,0 +1,224 @@
+/**
+ * Content-addressed cache of propagations.
+ */
+
+#include "cache.h"
+
+// System libraries
+#include <cstdint>
+
+// Project libraries
+#include "ads/SuperManifold.h"
+#include "tools/str.h"
+
+namespace cache
+{
+    /**
+     * Append a labelled list of values to the canonical text.
+     * @tparam T [in] [template]
+     * @param text [in/out] [std::string]
+     * @param label [in] [std::string]
+     * @param values [in] [std::vector<T>]
+     */
+    template<typename T>
+    void append(std::string& text, const std::string& label, const std::vector<T>& values)
+    {
+        text += label + ":";
+        for (const auto& val : values)
+        {
+            text += tools::string::print2string(" %.17g", (double) val);
+        }
+        text += "\n";
+    }
+
+    /**
+     * Final times of the segments of a propagation: the epochs and the final time.
+     * @param specs [in] [json_input]
+     * @return std::vector<double>
+     */
+    std::vector<double> segment_times(const json_input& specs)
+    {
+        auto times = specs.propagation.epochs;
+        times.push_back(specs.propagation.final_time);
+        return times;
+    }
+
+    /**
+     * Path of a segment of an entry, the last segment is the entry file itself.
+     * @param config [in] [settings]
+     * @param specs [in] [json_input]
+     * @param k [in] [std::size_t]
+     * @return std::filesystem::path
+     */
+    std::filesystem::path entry_path(const settings& config, const json_input& specs, std::size_t k)
+    {
+        auto name = cache::key(specs, config.code_version);
+        return config.dir / (k + 1 < cache::segment_times(specs).size() ?
+                             tools::string::print2string("%s.%zu.vdc", name.c_str(), k) : name + ".vdc");
+    }
+
+    /**
+     * Text stored with every segment of an entry, checked on lookup.
+     * @param config [in] [settings]
+     * @param specs [in] [json_input]
+     * @return std::string
+     */
+    std::string metadata(const settings& config, const json_input& specs)
+    {
+        return cache::canonical(specs) + "version: " + config.code_version + "\n";
+    }
+}
+
+std::string cache::canonical(const json_input& specs)
+{
+    // Text to be returned
+    std::string text{};
+
+    // Problem and algebra
+    cache::append<int>(text, "problem", {(int) specs.problem, (int) specs.algorithm});
+    cache::append<double>(text, "mu", {specs.mu});
+    cache::append<int>(text, "algebra", {specs.algebra.order, specs.algebra.variables, specs.algebra.adaptive_order,
+                                         specs.algebra.min_order});
+
+    // Propagation
+    cache::append<double>(text, "propagation", {specs.propagation.initial_time, specs.propagation.final_time,
+                                                specs.propagation.time_step, (double) specs.propagation.integrator});
+    cache::append(text, "epochs", specs.propagation.epochs);
+    if (specs.propagation.integrator == INTEGRATOR::TAYLOR)
+    {
+        cache::append<double>(text, "taylor_tolerance", {specs.propagation.tolerance});
+    }
+
+    // Initial conditions
+    cache::append<double>(text, "units", {(double) specs.initial_conditions.length_units});
+    cache::append(text, "mean", specs.initial_conditions.mean);
+    cache::append(text, "stddev", specs.initial_conditions.standard_deviation);
+    cache::append<double>(text, "ci", {specs.initial_conditions.confidence_interval});
+    std::vector<double> inertia(&specs.initial_conditions.inertia[0][0], &specs.initial_conditions.inertia[0][0] + 9);
+    cache::append(text, "inertia", inertia);
+
+    // Splitting
+    cache::append(text, "ads_tolerance", specs.ads.tolerance);
+    cache::append(text, "ads_max_split", specs.ads.max_split);
+    cache::append<double>(text, "loads_nli_threshold", {specs.loads.nli_threshold});
+    cache::append(text, "loads_max_split", specs.loads.max_split);
+    cache::append<double>(text, "coarsening", {specs.coarsening.tolerance, specs.coarsening.interval});
+
+    // Budget: the patch cap and the order change the result, memory and time caps only if hit (never stored)
+    cache::append<int>(text, "budget", {specs.budget.set, specs.budget.max_patches, (int) specs.budget.priority});
+    cache::append<int>(text, "splitting", {specs.splitting.set, (int) specs.splitting.mode, specs.splitting.max_pieces,
+                                           specs.splitting.min_steps});
+
+    // Scaling
+    cache::append<double>(text, "scaling", {specs.scaling.length, specs.scaling.time, specs.scaling.speed});
+    cache::append(text, "betas", specs.scaling.beta);
+
+    return text;
+}
+
+std::string cache::key(const json_input& specs, const std::string& code_version)
+{
+    // FNV-1a, 64 bits
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : cache::metadata({{}, code_version}, specs))
+    {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+
+    return tools::string::print2string("%016llx", (unsigned long long) hash);
+}
+
+bool cache::fetch(const settings& config, const json_input& specs, SuperManifold& sm,
+                  std::string * propagation_summary)
+{
+    // Entry: the last segment is written last, so it is only complete if that one exists
+    auto times = cache::segment_times(specs);
+    auto path = cache::entry_path(config, specs, times.size() - 1);
+    if (!std::filesystem::exists(path))
+    {
+        std::fprintf(stdout, "Cache: miss '%s'.\n", path.c_str());
+        return false;
+    }
+
+    // Load every segment in a copy of the current manifold, to share its integrator
+    Manifold empty(*sm.get_manifold_fin());
+    empty.clear();
+    std::vector<Manifold> segments(times.size(), empty);
+    auto expected = cache::metadata(config, specs);
+
+    for (std::size_t k = 0; k < segments.size(); k++)
+    {
+        auto segment_path = cache::entry_path(config, specs, k);
+        std::string metadata{};
+
+        try
+        {
+            checkpoint::load_manifold(segment_path, segments[k], &metadata);
+        }
+        catch (const std::runtime_error& e)
+        {
+            std::fprintf(stderr, "Cache: ignoring unreadable entry '%s': %s\n", segment_path.c_str(), e.what());
+            return false;
+        }
+
+        // Hash collisions are ignored
+        if (metadata != expected)
+        {
+            std::fprintf(stderr, "Cache: ignoring entry '%s', it was written for other inputs.\n",
+                         segment_path.c_str());
+            return false;
+        }
+    }
+
+    // Info
+    std::fprintf(stdout, "Cache: hit '%s', '%zu' patches restored.\n", path.c_str(), segments.back().size());
+
+    // Restore
+    sm.restore_domain(std::move(segments), times, propagation_summary);
+
+    return true;
+}
+
+void cache::store(const settings& config, const json_input& specs, SuperManifold& sm)
+{
+    // Entry
+    auto count = cache::segment_times(specs).size();
+    auto path = cache::entry_path(config, specs, count - 1);
+
+    // Safety check: every segment must have been propagated
+    if (sm.get_segment_count() != count)
+    {
+        std::fprintf(stderr, "Cache: not storing '%s', '%zu' segments propagated but '%zu' expected.\n",
+                     path.c_str(), sm.get_segment_count(), count);
+        return;
+    }
+
+    // Results cut by a memory or time cap depend on the machine: flags are carried on, so the last segment has them all
+    auto last = sm.get_manifold_fin();
+    bool limited = std::any_of(last->begin(), last->end(), [](const Patch& p) { return p.budget_limited_; });
+    if (limited && (specs.budget.max_memory > 0.0 || specs.budget.max_time > 0.0))
+    {
+        std::fprintf(stdout, "Cache: not storing '%s', the budget was exhausted.\n", path.c_str());
+        return;
+    }
+
+    try
+    {
+        // Final segment last: it marks the entry as complete
+        for (std::size_t k = 0; k < count; k++)
+        {
+            checkpoint::save_manifold(cache::entry_path(config, specs, k), *sm.get_segment(k),
+                                      cache::metadata(config, specs));
+        }
+    }
+    catch (const std::exception& e)
+    {
+        // A cache failure never fails the run
+        std::fprintf(stderr, "Cache: could not store '%s': %s\n", path.c_str(), e.what());
+        return;
+    }
+
+    // Info
+    std::fprintf(stdout, "Cache: stored '%s'.\n", path.c_str());
+}
@@ -0,0 +1,70 @@
+/**
+ * Content-addressed cache of propagations. The key is a hash of the resolved specifications (algebra, dynamics,
+ * initial conditions, betas, integrator and splitting settings) and of the code version; the entry stores the manifold
+ * of every segment, splitting history included.
+ */
+
+#pragma once
+
+// System libraries
+#include <filesystem>
+#include <string>
+
+// Project libraries
+#include "specs/json_input.h"
+
+// Forward declarations
+class SuperManifold;
+
+namespace cache
+{
+    /**
+     * Cache configuration
+     */
+    struct settings
+    {
+        // Where entries live, disabled if empty
+        std::filesystem::path dir{};
+
+        // Code version, part of the key: a new build never reuses old results
+        std::string code_version{};
+
+        [[nodiscard]] bool enabled() const { return !this->dir.empty(); }
+    };
+
+    /**
+     * Canonical text of everything in the specifications that changes the propagation result. Output directory and
+     * file path are left out.
+     * @param specs [in] [json_input]
+     * @return std::string
+     */
+    std::string canonical(const json_input& specs);
+
+    /**
+     * Key of an entry: 64-bit FNV-1a hash of the canonical specifications and the code version, in hexadecimal.
+     * @param specs [in] [json_input]
+     * @param code_version [in] [std::string]
+     * @return std::string
+     */
+    std::string key(const json_input& specs, const std::string& code_version);
+
+    /**
+     * Look up an entry and, on a hit, restore its segments in the super manifold (the integrator must be set already,
+     * up to the first epoch or final time). Entries whose stored specifications do not match are ignored.
+     * @param config [in] [settings]
+     * @param specs [in] [json_input]
+     * @param sm [in/out] [SuperManifold]
+     * @param propagation_summary [in] [std::string*]
+     * @return true on a hit
+     */
+    bool fetch(const settings& config, const json_input& specs, SuperManifold& sm,
+               std::string * propagation_summary = nullptr);
+
+    /**
+     * Store every segment of a propagated super manifold. Writes are atomic, so concurrent runs are safe.
+     * @param config [in] [settings]
+     * @param specs [in] [json_input]
+     * @param sm [in] [SuperManifold]
+     */
+    void store(const settings& config, const json_input& specs, SuperManifold& sm);
+}
@@ -0,0 +1,288 @@
+/**
+ * Binary checkpoint/restart of the splitting algorithm state.
+ */
+
+#include "checkpoint.h"
+
+// System libraries
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+// Project libraries
+#include "ads/Manifold.h"
+#include "tools/io_binary.h"
+
+namespace checkpoint
+{
+    // File identification
+    const char magic_[8] = {'V', 'D', 'A', 'C', 'K', 'P', 'T', '\0'};
+    const char magic_manifold_[8] = {'V', 'D', 'A', 'M', 'N', 'F', 'D', '\0'};
+    const std::uint32_t version_ = 5;
+
+    /**
+     * Write the file header: identification and algebra.
+     * @param os [in] [std::ostream]
+     * @param magic [in] [const char*]
+     */
+    void write_header(std::ostream& os, const char* magic)
+    {
+        os.write(magic, sizeof(checkpoint::magic_));
+        tools::io::binary::write<std::uint32_t>(os, checkpoint::version_);
+        tools::io::binary::write<std::uint32_t>(os, DACE::DA::getMaxOrder());
+        tools::io::binary::write<std::uint32_t>(os, DACE::DA::getMaxVariables());
+    }
+
+    /**
+     * Read and check the file header written by 'write_header'.
+     * @param is [in] [std::istream]
+     * @param magic [in] [const char*]
+     * @param file_path [in] [std::filesystem::path]
+     */
+    void read_header(std::istream& is, const char* magic, const std::filesystem::path& file_path)
+    {
+        // Identification
+        char magic_read[sizeof(checkpoint::magic_)];
+        is.read(magic_read, sizeof(magic_read));
+        if (!is || std::memcmp(magic_read, magic, sizeof(magic_read)) != 0)
+        {
+            throw std::runtime_error(tools::string::print2string("Checkpoint: '%s' is not a '%s' file.",
+                                                                 file_path.c_str(), magic));
+        }
+
+        auto version = tools::io::binary::read<std::uint32_t>(is);
+        if (version != checkpoint::version_)
+        {
+            throw std::runtime_error(tools::string::print2string("Checkpoint: unsupported version '%d'.", version));
+        }
+
+        // Algebra
+        auto order = tools::io::binary::read<std::uint32_t>(is);
+        auto nvar = tools::io::binary::read<std::uint32_t>(is);
+        if (order != DACE::DA::getMaxOrder() || nvar != DACE::DA::getMaxVariables())
+        {
+            throw std::runtime_error(tools::string::print2string(
+                    "Checkpoint: written with order '%d' and '%d' variables, DACE has order '%d' and '%d' variables.",
+                    order, nvar, DACE::DA::getMaxOrder(), DACE::DA::getMaxVariables()));
+        }
+    }
+
+    /**
+     * Create the parent directory if needed and get the temporary path to write first.
+     * @param file_path [in] [std::filesystem::path]
+     * @return std::filesystem::path
+     */
+    std::filesystem::path prepare_path(const std::filesystem::path& file_path)
+    {
+        if (file_path.has_parent_path() && !std::filesystem::is_directory(file_path.parent_path()))
+        {
+            std::filesystem::create_directories(file_path.parent_path());
+        }
+
+        auto tmp_path = file_path;
+        tmp_path += ".tmp";
+        return tmp_path;
+    }
+
+    /**
+     * Flush and close the temporary file, throw if any write failed so that it never replaces the previous file.
+     * @param os [in] [std::ofstream]
+     * @param tmp_path [in] [std::filesystem::path]
+     */
+    void close_checked(std::ofstream& os, const std::filesystem::path& tmp_path)
+    {
+        os.flush();
+        os.close();
+
+        // Safety check: short write (disk full, I/O error...)
+        if (os.fail())
+        {
+            std::error_code ec;
+            std::filesystem::remove(tmp_path, ec);
+            throw std::runtime_error(tools::string::print2string("Checkpoint: could not write '%s'.",
+                                                                 tmp_path.c_str()));
+        }
+    }
+}
+
+void checkpoint::write_patch(std::ostream& os, Patch& p)
+{
+    // Scalars
+    tools::io::binary::write<int>(os, p.id_);
+    tools::io::binary::write<int>(os, (int) p.algorithm_);
+    tools::io::binary::write<double>(os, p.t_);
+    tools::io::binary::write<double>(os, p.nli);
+    tools::io::binary::write<double>(os, p.t_split_);
+    tools::io::binary::write<int>(os, p.order_);
+    tools::io::binary::write<bool>(os, p.budget_limited_);
+    tools::io::binary::write<double>(os, p.mass_);
+
+    // History and scaling
+    tools::io::binary::write_vector<int>(os, p.get_history_int());
+    tools::io::binary::write_vector<double>(os, p.get_times_doubles());
+    tools::io::binary::write_vector<double>(os, p.get_nlis_doubles());
+    tools::io::binary::write_vector<double>(os, p.betas);
+
+    // Polynomials
+    tools::io::binary::write_da_vector(os, p);
+}
+
+Patch checkpoint::read_patch(std::istream& is)
+{
+    // Scalars
+    auto id = tools::io::binary::read<int>(is);
+    auto algorithm = (ALGORITHM) tools::io::binary::read<int>(is);
+    auto t = tools::io::binary::read<double>(is);
+    auto nli = tools::io::binary::read<double>(is);
+    auto t_split = tools::io::binary::read<double>(is);
+    auto order = tools::io::binary::read<int>(is);
+    auto budget_limited = tools::io::binary::read<bool>(is);
+    auto mass = tools::io::binary::read<double>(is);
+
+    // History and scaling
+    auto history = tools::io::binary::read_vector<int>(is);
+    auto times = tools::io::binary::read_vector<double>(is);
+    auto nlis = tools::io::binary::read_vector<double>(is);
+    auto betas = tools::io::binary::read_vector<double>(is);
+
+    // Polynomials
+    auto v = tools::io::binary::read_da_vector(is);
+
+    // Build patch
+    Patch p(v, history, times, nlis, algorithm, t, nli, t_split);
+    p.id_ = id;
+    p.betas = betas;
+    p.order_ = order;
+    p.budget_limited_ = budget_limited;
+    p.mass_ = mass;
+
+    return p;
+}
+
+void checkpoint::save(const std::filesystem::path& file_path, Manifold& pending, Manifold& results, int split_count,
+                      const integrator& integ)
+{
+    // Write in a temporary file first, so that a crash while writing does not destroy the previous checkpoint
+    auto tmp_path = checkpoint::prepare_path(file_path);
+
+    {
+        std::ofstream os(tmp_path, std::ios::binary | std::ios::trunc);
+
+        // Safety check
+        if (!os.is_open())
+        {
+            std::fprintf(stderr, "Checkpoint: could not open '%s' to write.\n", tmp_path.c_str());
+            return;
+        }
+
+        // Header: identification and algebra
+        checkpoint::write_header(os, checkpoint::magic_);
+
+        // Integrator and algorithm state
+        integ.write_checkpoint(os);
+        tools::io::binary::write<int>(os, split_count);
+
+        // Pending patches, in queue order
+        tools::io::binary::write<std::uint64_t>(os, pending.size());
+        for (auto& p : pending) { checkpoint::write_patch(os, p); }
+
+        // Finished patches
+        tools::io::binary::write<std::uint64_t>(os, results.size());
+        for (auto& p : results) { checkpoint::write_patch(os, p); }
+
+        // Safety check before replacing the previous checkpoint
+        checkpoint::close_checked(os, tmp_path);
+    }
+
+    // Replace
+    std::filesystem::rename(tmp_path, file_path);
+
+    // Info
+    std::fprintf(stdout, "Checkpoint: '%zu' pending and '%zu' finished patches saved in '%s'.\n",
+                 pending.size(), results.size(), file_path.c_str());
+}
+
+void checkpoint::load(const std::filesystem::path& file_path, Manifold& pending, Manifold& results, int& split_count,
+                      integrator& integ)
+{
+    std::ifstream is(file_path, std::ios::binary);
+
+    // Safety check
+    if (!is.is_open())
+    {
+        throw std::runtime_error(tools::string::print2string("Checkpoint: could not open '%s'.", file_path.c_str()));
+    }
+
+    // Header: identification and algebra
+    checkpoint::read_header(is, checkpoint::magic_, file_path);
+
+    // Integrator and algorithm state
+    integ.read_checkpoint(is);
+    split_count = tools::io::binary::read<int>(is);
+
+    // Pending patches
+    auto n_pending = tools::io::binary::read<std::uint64_t>(is);
+    for (std::uint64_t k = 0; k < n_pending; k++) { pending.push_back(checkpoint::read_patch(is)); }
+
+    // Finished patches
+    auto n_results = tools::io::binary::read<std::uint64_t>(is);
+    for (std::uint64_t k = 0; k < n_results; k++) { results.push_back(checkpoint::read_patch(is)); }
+
+    // Info
+    std::fprintf(stdout, "Checkpoint: '%zu' pending and '%zu' finished patches loaded from '%s'.\n",
+                 pending.size(), results.size(), file_path.c_str());
+}
+
+void checkpoint::save_manifold(const std::filesystem::path& file_path, Manifold& manifold, const std::string& metadata)
+{
+    // Write in a temporary file first
+    auto tmp_path = checkpoint::prepare_path(file_path);
+
+    {
+        std::ofstream os(tmp_path, std::ios::binary | std::ios::trunc);
+
+        // Safety check
+        if (!os.is_open())
+        {
+            throw std::runtime_error(tools::string::print2string("Checkpoint: could not open '%s' to write.",
+                                                                 tmp_path.c_str()));
+        }
+
+        // Header: identification and algebra
+        checkpoint::write_header(os, checkpoint::magic_manifold_);
+        tools::io::binary::write_string(os, metadata);
+
+        // Patches
+        tools::io::binary::write<std::uint64_t>(os, manifold.size());
+        for (auto& p : manifold) { checkpoint::write_patch(os, p); }
+
+        // Safety check before replacing the previous file
+        checkpoint::close_checked(os, tmp_path);
+    }
+
+    // Replace
+    std::filesystem::rename(tmp_path, file_path);
+}
+
+void checkpoint::load_manifold(const std::filesystem::path& file_path, Manifold& manifold, std::string* metadata)
+{
+    std::ifstream is(file_path, std::ios::binary);
+
+    // Safety check
+    if (!is.is_open())
+    {
+        throw std::runtime_error(tools::string::print2string("Checkpoint: could not open '%s'.", file_path.c_str()));
+    }
+
+    // Header: identification and algebra
+    checkpoint::read_header(is, checkpoint::magic_manifold_, file_path);
+    auto metadata_read = tools::io::binary::read_string(is);
+    if (metadata != nullptr)
+    {
+        *metadata = metadata_read;
+    }
+
+    // Patches
+    auto n_patches = tools::io::binary::read<std::uint64_t>(is);
+    for (std::uint64_t k = 0; k < n_patches; k++) { manifold.push_back(checkpoint::read_patch(is)); }
+}
@@ -0,0 +1,85 @@
+/**
+ * Binary checkpoint/restart of the splitting algorithm state: pending patches, finished patches, split counter and
+ * integrator settings. DA vectors are stored sparsely (exponents + coefficients).
+ */
+
+#pragma once
+
+// System libraries
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// Forward declarations
+class Manifold;
+class Patch;
+class integrator;
+
+namespace checkpoint
+{
+    /**
+     * Periodic checkpoint configuration
+     */
+    struct settings
+    {
+        // Where to write, disabled if empty
+        std::filesystem::path file_path{};
+
+        // Minimum wall time between two checkpoints [s]
+        double interval{300.0};
+
+        [[nodiscard]] bool enabled() const { return !this->file_path.empty(); }
+    };
+
+    /**
+     * Save the state of a running 'getSplitDomain'. The file is replaced atomically.
+     * @param file_path [in] [std::filesystem::path]
+     * @param pending [in] [Manifold] patches still to be integrated
+     * @param results [in] [Manifold] patches already finished
+     * @param split_count [in] [int]
+     * @param integ [in] [integrator]
+     */
+    void save(const std::filesystem::path& file_path, Manifold& pending, Manifold& results, int split_count,
+              const integrator& integ);
+
+    /**
+     * Load a state saved by 'save'. DACE must be initialized with the same algebra.
+     * @param file_path [in] [std::filesystem::path]
+     * @param pending [out] [Manifold]
+     * @param results [out] [Manifold]
+     * @param split_count [out] [int]
+     * @param integ [out] [integrator]
+     */
+    void load(const std::filesystem::path& file_path, Manifold& pending, Manifold& results, int& split_count,
+              integrator& integ);
+
+    /**
+     * Save a finished manifold (e.g. a segment of a segmented propagation). The file is replaced atomically.
+     * @param file_path [in] [std::filesystem::path]
+     * @param manifold [in] [Manifold]
+     * @param metadata [in] [std::string] free text stored before the patches
+     */
+    void save_manifold(const std::filesystem::path& file_path, Manifold& manifold, const std::string& metadata = {});
+
+    /**
+     * Load a manifold saved by 'save_manifold'. DACE must be initialized with the same algebra.
+     * @param file_path [in] [std::filesystem::path]
+     * @param manifold [out] [Manifold]
+     * @param metadata [out] [std::string*] if not nullptr
+     */
+    void load_manifold(const std::filesystem::path& file_path, Manifold& manifold, std::string* metadata = nullptr);
+
+    /**
+     * Write a patch: DA vector, splitting history, times, NLIs, betas, identifiers and times.
+     * @param os [in] [std::ostream]
+     * @param p [in] [Patch]
+     */
+    void write_patch(std::ostream& os, Patch& p);
+
+    /**
+     * Read a patch written by 'write_patch'.
+     * @param is [in] [std::istream]
+     * @return Patch
+     */
+    Patch read_patch(std::istream& is);
+}
@@ -0,0 +1,377 @@
+/**
+ * Gaussian mixture of a propagated manifold.
+ */
+
+#include "mixture.h"
+
+// System libraries
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+// Project libraries
+#include "ads/Manifold.h"
+#include "tools/io_binary.h"
+#include "tools/math.h"
+#include "tools/str.h"
+
+namespace mixture
+{
+    // File identification
+    const char magic_[8] = {'V', 'D', 'A', 'G', 'M', 'I', 'X', '\0'};
+    const std::uint32_t version_ = 1;
+
+    /**
+     * Cost of merging two components: weighted squared distance of their means, normalized per variable.
+     * @param a [in] [component]
+     * @param b [in] [component]
+     * @param scale [in] [std::vector<double>] inverse variance of every variable, zero to ignore it
+     * @return double
+     */
+    double merge_cost(const component& a, const component& b, const std::vector<double>& scale)
+    {
+        double distance = 0.0;
+        for (std::size_t k = 0; k < scale.size(); k++)
+        {
+            double d = a.mean[k] - b.mean[k];
+            distance += scale[k] * d * d;
+        }
+
+        return a.weight * b.weight / (a.weight + b.weight) * distance;
+    }
+
+    /**
+     * Merge 'b' into 'a', keeping the weight, mean and covariance of the pair.
+     * @param a [in/out] [component]
+     * @param b [in] [component]
+     */
+    void merge(component& a, const component& b)
+    {
+        const std::size_t n = a.mean.size();
+        double weight = a.weight + b.weight;
+        double fa = a.weight / weight;
+        double fb = b.weight / weight;
+
+        // Mean of the pair
+        std::vector<double> mean(n);
+        for (std::size_t k = 0; k < n; k++)
+        {
+            mean[k] = fa * a.mean[k] + fb * b.mean[k];
+        }
+
+        // Covariance of the pair: both covariances plus the spread of the means
+        for (std::size_t i = 0; i < n; i++)
+        {
+            for (std::size_t j = 0; j < n; j++)
+            {
+                double da = (a.mean[i] - mean[i]) * (a.mean[j] - mean[j]);
+                double db = (b.mean[i] - mean[i]) * (b.mean[j] - mean[j]);
+                a.covariance[i * n + j] = fa * (a.covariance[i * n + j] + da) + fb * (b.covariance[i * n + j] + db);
+            }
+        }
+
+        a.weight = weight;
+        a.mean = mean;
+    }
+}
+
+std::vector<mixture::component> mixture::extract(Manifold& manifold, double confidence_interval)
+{
+    // Safety check
+    if (!(confidence_interval > 0.0))
+    {
+        throw std::runtime_error(tools::string::print2string(
+                "Mixture: confidence interval must be positive, got '%g'.", confidence_interval));
+    }
+
+    std::vector<component> components;
+    components.reserve(manifold.size());
+    double total = 0.0;
+
+    for (auto & p : manifold)
+    {
+        // Box of the patch in the initial one, [-1, 1] in every direction
+        auto c = p.get_center();
+        auto w = p.get_width();
+        const std::size_t n_var = c.size();
+        const std::size_t n = p.size();
+
+        // Initial Gaussian truncated to the box, in the variables of the patch polynomial: 2 * (u - c) / w
+        std::vector<double> mean_var(n_var), variance_var(n_var);
+        for (std::size_t k = 0; k < n_var; k++)
+        {
+            double m, v;
+            tools::math::truncated_normal_moments(confidence_interval * (c[k] - 0.5 * w[k]),
+                                                  confidence_interval * (c[k] + 0.5 * w[k]), m, v);
+            mean_var[k] = 2.0 * (m / confidence_interval - c[k]) / w[k];
+            variance_var[k] = 4.0 * v / (confidence_interval * confidence_interval * w[k] * w[k]);
+        }
+
+        // Linear part of the polynomial, one row per component
+        std::vector<DACE::AlgebraicVector<double>> linear(n);
+        for (std::size_t i = 0; i < n; i++)
+        {
+            linear[i] = p[i].linear();
+        }
+
+        // Linearized mean and covariance
+        component g{};
+        g.weight = p.mass_ >= 0.0 ? p.mass_ : p.probability_mass(confidence_interval);
+        g.mean.assign(n, 0.0);
+        g.covariance.assign(n * n, 0.0);
+        for (std::size_t i = 0; i < n; i++)
+        {
+            g.mean[i] = p[i].cons();
+            for (std::size_t k = 0; k < n_var; k++)
+            {
+                g.mean[i] += linear[i][k] * mean_var[k];
+            }
+
+            for (std::size_t j = 0; j < n; j++)
+            {
+                for (std::size_t k = 0; k < n_var; k++)
+                {
+                    g.covariance[i * n + j] += linear[i][k] * linear[j][k] * variance_var[k];
+                }
+            }
+        }
+
+        total += g.weight;
+        components.push_back(std::move(g));
+    }
+
+    // Normalize weights
+    if (total > 0.0)
+    {
+        for (auto & g : components)
+        {
+            g.weight /= total;
+        }
+    }
+
+    return components;
+}
+
+void mixture::reduce(std::vector<component>& components, std::size_t target)
+{
+    // Nothing to do
+    if (target == 0 || components.size() <= target)
+    {
+        return;
+    }
+
+    const std::size_t n_comp = components.size();
+    const std::size_t n = components.front().mean.size();
+
+    // Variance of the whole mixture, per variable, to normalize the distances
+    std::vector<double> mean(n, 0.0), scale(n, 0.0);
+    double total = 0.0;
+    for (const auto & g : components)
+    {
+        total += g.weight;
+        for (std::size_t k = 0; k < n; k++) { mean[k] += g.weight * g.mean[k]; }
+    }
+    for (std::size_t k = 0; k < n; k++) { mean[k] /= total; }
+    for (const auto & g : components)
+    {
+        for (std::size_t k = 0; k < n; k++)
+        {
+            double d = g.mean[k] - mean[k];
+            scale[k] += g.weight * (g.covariance[k * n + k] + d * d) / total;
+        }
+    }
+    for (auto & s : scale)
+    {
+        s = s > 0.0 ? 1.0 / s : 0.0;
+    }
+
+    // Nearest neighbour (cheapest merge) of every component alive
+    std::vector<bool> alive(n_comp, true);
+    std::vector<std::size_t> nearest(n_comp, 0);
+    std::vector<double> nearest_cost(n_comp, std::numeric_limits<double>::infinity());
+    auto update_nearest = [&](std::size_t i)
+    {
+        nearest_cost[i] = std::numeric_limits<double>::infinity();
+        for (std::size_t j = 0; j < n_comp; j++)
+        {
+            if (j == i || !alive[j]) { continue; }
+            double cost = mixture::merge_cost(components[i], components[j], scale);
+            if (cost < nearest_cost[i])
+            {
+                nearest_cost[i] = cost;
+                nearest[i] = j;
+            }
+        }
+    };
+    for (std::size_t i = 0; i < n_comp; i++) { update_nearest(i); }
+
+    // Merge the cheapest pair until the target is reached
+    for (std::size_t count = n_comp; count > target; count--)
+    {
+        // Cheapest pair
+        std::size_t a = n_comp;
+        for (std::size_t i = 0; i < n_comp; i++)
+        {
+            if (alive[i] && (a == n_comp || nearest_cost[i] < nearest_cost[a])) { a = i; }
+        }
+        std::size_t b = nearest[a];
+
+        // Merge into the first one
+        if (b < a) { std::swap(a, b); }
+        mixture::merge(components[a], components[b]);
+        alive[b] = false;
+
+        // Neighbours: the merged component moved, the removed one is gone
+        update_nearest(a);
+        for (std::size_t i = 0; i < n_comp; i++)
+        {
+            if (!alive[i] || i == a) { continue; }
+            if (nearest[i] == a || nearest[i] == b)
+            {
+                update_nearest(i);
+            }
+            else
+            {
+                double cost = mixture::merge_cost(components[i], components[a], scale);
+                if (cost < nearest_cost[i])
+                {
+                    nearest_cost[i] = cost;
+                    nearest[i] = a;
+                }
+            }
+        }
+    }
+
+    // Keep the ones alive, in order
+    std::vector<component> reduced;
+    reduced.reserve(target);
+    for (std::size_t i = 0; i < n_comp; i++)
+    {
+        if (alive[i]) { reduced.push_back(std::move(components[i])); }
+    }
+    components = std::move(reduced);
+}
+
+void mixture::write_binary(const std::filesystem::path& file_path, const std::vector<component>& components)
+{
+    // Check that the output path is existing
+    if (file_path.has_parent_path() && !std::filesystem::is_directory(file_path.parent_path()))
+    {
+        std::filesystem::create_directories(file_path.parent_path());
+    }
+
+    std::ofstream os(file_path, std::ios::binary | std::ios::trunc);
+    if (!os.is_open())
+    {
+        throw std::runtime_error(tools::string::print2string("Mixture: could not open '%s' to write.",
+                                                             file_path.c_str()));
+    }
+
+    // Header
+    const std::size_t n = components.empty() ? 0 : components.front().mean.size();
+    os.write(mixture::magic_, sizeof(mixture::magic_));
+    tools::io::binary::write<std::uint32_t>(os, mixture::version_);
+    tools::io::binary::write<std::uint32_t>(os, (std::uint32_t) n);
+    tools::io::binary::write<std::uint64_t>(os, components.size());
+
+    // Components
+    for (const auto & g : components)
+    {
+        tools::io::binary::write<double>(os, g.weight);
+        os.write(reinterpret_cast<const char*>(g.mean.data()), (std::streamsize) (n * sizeof(double)));
+        os.write(reinterpret_cast<const char*>(g.covariance.data()), (std::streamsize) (n * n * sizeof(double)));
+    }
+}
+
+std::vector<mixture::component> mixture::read_binary(const std::filesystem::path& file_path)
+{
+    std::ifstream is(file_path, std::ios::binary);
+    if (!is.is_open())
+    {
+        throw std::runtime_error(tools::string::print2string("Mixture: could not open '%s' to read.",
+                                                             file_path.c_str()));
+    }
+
+    // Header
+    char magic[sizeof(mixture::magic_)];
+    is.read(magic, sizeof(magic));
+    if (!is || std::memcmp(magic, mixture::magic_, sizeof(magic)) != 0)
+    {
+        throw std::runtime_error(tools::string::print2string("Mixture: '%s' is not a mixture file.",
+                                                             file_path.c_str()));
+    }
+    auto version = tools::io::binary::read<std::uint32_t>(is);
+    if (version != mixture::version_)
+    {
+        throw std::runtime_error(tools::string::print2string("Mixture: unsupported version '%u'.", version));
+    }
+    auto n = (std::size_t) tools::io::binary::read<std::uint32_t>(is);
+    auto n_comp = tools::io::binary::read<std::uint64_t>(is);
+
+    // Components
+    std::vector<component> components(n_comp);
+    for (auto & g : components)
+    {
+        g.weight = tools::io::binary::read<double>(is);
+        g.mean.resize(n);
+        g.covariance.resize(n * n);
+        is.read(reinterpret_cast<char*>(g.mean.data()), (std::streamsize) (n * sizeof(double)));
+        is.read(reinterpret_cast<char*>(g.covariance.data()), (std::streamsize) (n * n * sizeof(double)));
+        if (!is)
+        {
+            throw std::runtime_error(tools::string::print2string("Mixture: '%s' is truncated.", file_path.c_str()));
+        }
+    }
+
+    return components;
+}
+
+void mixture::write_json(const std::filesystem::path& file_path, const std::vector<component>& components)
+{
+    // Check that the output path is existing
+    if (file_path.has_parent_path() && !std::filesystem::is_directory(file_path.parent_path()))
+    {
+        std::filesystem::create_directories(file_path.parent_path());
+    }
+
+    std::ofstream file(file_path);
+    if (!file.is_open())
+    {
+        throw std::runtime_error(tools::string::print2string("Mixture: could not open '%s' to write.",
+                                                             file_path.c_str()));
+    }
+
+    // Numbers list
+    auto list = [](const double* v, std::size_t size)
+    {
+        std::string text{"["};
+        for (std::size_t k = 0; k < size; k++)
+        {
+            text += tools::string::print2string(k == 0 ? "%.17g" : ", %.17g", v[k]);
+        }
+        return text + "]";
+    };
+
+    const std::size_t n = components.empty() ? 0 : components.front().mean.size();
+    file << "{" << std::endl;
+    file << tools::string::print2string("  \"variables\": %zu,", n) << std::endl;
+    file << "  \"components\": [" << std::endl;
+    for (std::size_t c = 0; c < components.size(); c++)
+    {
+        const auto& g = components[c];
+        file << "    {" << std::endl;
+        file << tools::string::print2string("      \"weight\": %.17g,", g.weight) << std::endl;
+        file << "      \"mean\": " << list(g.mean.data(), n) << "," << std::endl;
+        file << "      \"covariance\": [";
+        for (std::size_t i = 0; i < n; i++)
+        {
+            file << (i == 0 ? "" : ", ") << list(g.covariance.data() + i * n, n);
+        }
+        file << "]" << std::endl;
+        file << (c + 1 < components.size() ? "    }," : "    }") << std::endl;
+    }
+    file << "  ]" << std::endl;
+    file << "}" << std::endl;
+}
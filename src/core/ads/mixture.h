@@ -0,0 +1,89 @@
+/**
+ * Gaussian mixture of a propagated manifold, for filters that want a distribution instead of a cloud of samples. Every
+ * patch gives one component: its polynomial linearized at the center of its box, applied to the initial Gaussian
+ * truncated to that box, weighted by the probability mass of the box. Components can be merged down to a target count.
+ */
+
+#pragma once
+
+// System libraries
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+// Forward declarations
+class Manifold;
+
+namespace mixture
+{
+    /**
+     * Mixture output configuration
+     */
+    struct settings
+    {
+        // Components after merging, zero for one per patch
+        std::size_t components{};
+
+        // Output files
+        bool binary{false};
+        bool json{false};
+
+        // Confidence interval of the initial box: standard deviations from its center to its walls
+        double confidence_interval{1.0};
+
+        [[nodiscard]] bool enabled() const
+        {
+            return this->binary || this->json;
+        }
+    };
+
+    /**
+     * One Gaussian component
+     */
+    struct component
+    {
+        double weight{};
+        std::vector<double> mean{};
+        std::vector<double> covariance{};   // Row-major, [n x n]
+    };
+
+    /**
+     * One component per patch of the manifold, weights normalized to one. The mass stored in the patches is used if
+     * they have been weighted, otherwise it is computed here.
+     * @param manifold [in] [Manifold]
+     * @param confidence_interval [in] [double] standard deviations from the center to the wall of the initial box
+     * @return std::vector<component>
+     */
+    std::vector<component> extract(Manifold& manifold, double confidence_interval);
+
+    /**
+     * Merge components, two at a time, until 'target' are left. The pair merged is the one whose merge adds the least
+     * spread (weighted squared distance of the means, normalized by the variance of the whole mixture), and the merged
+     * component keeps the weight, mean and covariance of the pair.
+     * @param components [in/out] [std::vector<component>]
+     * @param target [in] [std::size_t] nothing is done if zero or not below the current count
+     */
+    void reduce(std::vector<component>& components, std::size_t target);
+
+    /**
+     * Write the mixture in binary: identification, version, number of variables and of components, then every
+     * component as its weight, mean and row-major covariance. Native endianness.
+     * @param file_path [in] [std::filesystem::path]
+     * @param components [in] [std::vector<component>]
+     */
+    void write_binary(const std::filesystem::path& file_path, const std::vector<component>& components);
+
+    /**
+     * Read a mixture written by 'write_binary'. Throws std::runtime_error if the file is not one.
+     * @param file_path [in] [std::filesystem::path]
+     * @return std::vector<component>
+     */
+    std::vector<component> read_binary(const std::filesystem::path& file_path);
+
+    /**
+     * Write the mixture in JSON: an array of components with their weight, mean and covariance (one row per variable).
+     * @param file_path [in] [std::filesystem::path]
+     * @param components [in] [std::vector<component>]
+     */
+    void write_json(const std::filesystem::path& file_path, const std::vector<component>& components);
+}
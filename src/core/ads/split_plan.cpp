@@ -0,0 +1,96 @@
+/**
+ * Splitting plan of a patch violating the threshold.
+ */
+
+#include "split_plan.h"
+
+// System libraries
+#include <algorithm>
+#include <cmath>
+
+// Project libraries
+#include "integrator.h"
+
+namespace split_plan
+{
+    // Target nonlinearity of the pieces, relative to the threshold, when its growth rate is unknown
+    constexpr double unknown_growth_ratio = 0.5;
+}
+
+int split_plan::cut_pieces(ALGORITHM algorithm)
+{
+    return algorithm == ALGORITHM::LOADS ? 3 : 2;
+}
+
+std::vector<int> split_plan::directions(const settings& config, integrator& integ, int splits_left)
+{
+    // Direction chosen by the conditions check, always cut
+    std::vector<int> dirs{integ.get_splitting_pos() + 1};
+
+    // Single cut
+    const auto& contributions = integ.get_split_contributions();
+    if (!config.enabled() || dirs.front() < 1 || dirs.front() > (int) contributions.size())
+    {
+        return dirs;
+    }
+
+    // Cut: the first order of the NLI along a direction scales with the width (LOADS), the truncation error with the
+    // width to the order plus one (ADS)
+    bool loads = integ.get_algorithm() == ALGORITHM::LOADS;
+    int cut = split_plan::cut_pieces(integ.get_algorithm());
+    double power = loads ? 1.0 : (double) DACE::DA::getMaxOrder() + 1.0;
+
+    // Pieces along every direction
+    std::vector<double> pieces(contributions.size(), 1.0);
+    pieces[dirs.front() - 1] = cut;
+    int total = cut;
+
+    // Contribution of a direction once cut
+    auto reduced = [&](std::size_t k) { return contributions[k] * std::pow(pieces[k], -power); };
+
+    // Nonlinearity of the pieces relative to the threshold: NLI contributions add in quadrature, errors linearly
+    auto piece_ratio = [&]()
+    {
+        double full = 0.0;
+        double cut_down = 0.0;
+        for (std::size_t k = 0; k < contributions.size(); k++)
+        {
+            full += loads ? contributions[k] * contributions[k] : contributions[k];
+            cut_down += loads ? reduced(k) * reduced(k) : reduced(k);
+        }
+        double scale = full > 0.0 ? (loads ? std::sqrt(cut_down / full) : cut_down / full) : 1.0;
+        return integ.get_nonlinearity_ratio() * scale;
+    };
+
+    // Time the pieces should last, no further than the final time
+    double horizon = std::min(integ.get_final_time() - integ.t_, config.min_steps * std::abs(integ.get_time_step()));
+
+    // Growth of the nonlinearity
+    double growth = integ.get_nonlinearity_growth();
+    auto last = [&](double ratio)
+    {
+        if (ratio >= 1.0) { return false; }
+        if (std::isnan(growth)) { return ratio <= split_plan::unknown_growth_ratio; }
+        if (growth <= 0.0) { return true; }
+        return std::log(1.0 / ratio) / growth >= horizon;
+    };
+
+    // More cuts, along the direction contributing the most
+    while (!last(piece_ratio()) && (int) dirs.size() < splits_left && total * cut <= config.max_pieces)
+    {
+        std::size_t best = 0;
+        for (std::size_t k = 1; k < contributions.size(); k++)
+        {
+            if (reduced(k) > reduced(best)) { best = k; }
+        }
+
+        // Nothing left to gain
+        if (reduced(best) <= 0.0) { break; }
+
+        pieces[best] *= cut;
+        total *= cut;
+        dirs.push_back((int) best + 1);
+    }
+
+    return dirs;
+}
@@ -0,0 +1,59 @@
+/**
+ * Splitting plan of a patch violating the threshold. Instead of one cut along the direction chosen by the conditions
+ * check, a predictive plan cuts the patch along several directions at once (e.g. 3x3 across two of them for LOADS),
+ * so that the pieces are expected to last some steps before splitting again. The expectation comes from the growth
+ * rate of the nonlinearity along the failed integration and from the contribution of every variable to it.
+ */
+
+#pragma once
+
+// System libraries
+#include <vector>
+
+// Project libraries
+#include "base/enums.h"
+
+// Forward declarations
+class integrator;
+
+namespace split_plan
+{
+    /**
+     * Splitting configuration
+     */
+    struct settings
+    {
+        SPLIT_MODE mode{SPLIT_MODE::SINGLE};
+
+        // Pieces a patch may be cut into at once
+        int max_pieces{9};
+
+        // Steps the pieces are expected to last before splitting again. Every extra cut is paid integrating more pieces
+        // from now on, so it only pays off for pieces that would split again right away
+        int min_steps{5};
+
+        [[nodiscard]] bool enabled() const
+        {
+            return this->mode == SPLIT_MODE::PREDICTIVE && this->max_pieces > 1;
+        }
+    };
+
+    /**
+     * Pieces one cut makes.
+     * @param algorithm [in] [ALGORITHM]
+     * @return int
+     */
+    int cut_pieces(ALGORITHM algorithm);
+
+    /**
+     * Directions to cut the patch just failed in the integrator, one per cut, in order: every piece of a cut is cut
+     * again along the next direction. The first one is always the direction chosen by the conditions check, further
+     * cuts are added greedily along the direction contributing the most until the pieces are expected to last, the
+     * splits left or the pieces allowed run out.
+     * @param config [in] [settings]
+     * @param integ [in] [integrator] right after the failed integration
+     * @param splits_left [in] [int] cuts the patch may still take
+     * @return std::vector<int> 1-based directions
+     */
+    std::vector<int> directions(const settings& config, integrator& integ, int splits_left);
+}
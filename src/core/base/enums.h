@@ -40,7 +40,8 @@ enum class STATE
 };
 
 /**
-* Type of integrator
+* Type of integrator. TAYLOR sums the Taylor series in time of the solution, its step chosen from the decay of the
+* coefficients.
 */
 enum class INTEGRATOR
 {
@@ -48,13 +49,19 @@ enum class INTEGRATOR
     RK4,
     RK78,
     STATIC,
+    ANALYTIC_KEPLER,
+    TAYLOR,
     NA
 };
 
+/**
+* Distribution of the samples. STRATIFIED draws the gaussian one, restricted to the initial domain, patch by patch.
+*/
 enum class DISTRIBUTION
 {
     GAUSSIAN,
-    UNIFORM
+    UNIFORM,
+    STRATIFIED
 };
 
 /**
@@ -149,6 +156,44 @@ enum class FILM
     NA
 };
 
+/**
+* Profiled sections of the engine
+*/
+enum class PROFILE_SECTION
+{
+    INTEGRATE,
+    STEP,
+    CHECK_ADS,
+    CHECK_LOADS,
+    SPLIT,
+    COARSEN,
+    GET_SPLIT_DOMAIN,
+    EVALUATE_DELTAS,
+    WRITE_FILES,
+    NA
+};
+
+/**
+* Order of the pending patches in a budgeted propagation
+*/
+enum class BUDGET_PRIORITY
+{
+    FIFO,
+    MASS,
+    NLI,
+    NA
+};
+
+/**
+* How a patch violating the splitting threshold is cut
+*/
+enum class SPLIT_MODE
+{
+    SINGLE,
+    PREDICTIVE,
+    NA
+};
+
 /**
 * MEX file type
 */
@@ -0,0 +1,584 @@
+/**
+ * VerneDA C ABI implementation: thin layer over the session registry. No C++ exception crosses this boundary.
+ */
+
+#include "capi/verneda.h"
+
+// Project libraries
+#include "session.h"
+#include "json/json_parser.h"
+#include "ads/mixture.h"
+#include "ads/SplittingHistory.h"
+
+namespace
+{
+    // Last error of each thread
+    thread_local std::string last_error_;
+
+    // Set error and return its code
+    int fail(int code, const std::string& msg)
+    {
+        last_error_ = msg;
+        return code;
+    }
+
+    // Run a function translating exceptions into status codes
+    template<typename F> int guarded(F f)
+    {
+        try
+        {
+            last_error_.clear();
+            return f();
+        }
+        catch (const std::exception& e)
+        {
+            return fail(VERNEDA_ERR_RUNTIME, e.what());
+        }
+        catch (...)
+        {
+            return fail(VERNEDA_ERR_RUNTIME, "Unknown error.");
+        }
+    }
+
+    // Get a session and check it has been propagated if needed
+    session* get_session(verneda_handle handle, bool propagated = true)
+    {
+        auto s = session_registry::find(handle);
+
+        if (s == nullptr)
+        {
+            throw std::invalid_argument(tools::string::print2string("Invalid handle '%lu'.", (unsigned long) handle));
+        }
+
+        if (propagated && !s->is_propagated())
+        {
+            throw std::runtime_error("Scenario has not been propagated yet.");
+        }
+
+        return s;
+    }
+
+    // Check the patch index against the final manifold
+    bool patch_in_range(session* s, std::size_t patch)
+    {
+        return patch < s->get_manifold_fin()->size();
+    }
+
+    // Check the segment index against the propagated segments
+    bool segment_in_range(session* s, std::size_t segment)
+    {
+        return segment < s->get_segment_count();
+    }
+
+    // Check a configuration before building the engine, whose own checks exit the process
+    int check_config(const verneda_config* config)
+    {
+        // Enumerations
+        if (config->problem != VERNEDA_TWO_BODY && config->problem != VERNEDA_FREE_TORQUE_MOTION)
+        {
+            return fail(VERNEDA_ERR_INVALID_ARGUMENT, tools::string::print2string(
+                    "Unknown problem '%d'.", (int) config->problem));
+        }
+        if (config->algorithm != VERNEDA_ADS && config->algorithm != VERNEDA_LOADS && config->algorithm != VERNEDA_NONE)
+        {
+            return fail(VERNEDA_ERR_INVALID_ARGUMENT, tools::string::print2string(
+                    "Unknown algorithm '%d'.", (int) config->algorithm));
+        }
+        if (config->integrator != VERNEDA_RK4 && config->integrator != VERNEDA_EULER &&
+            config->integrator != VERNEDA_RK78 && config->integrator != VERNEDA_ANALYTIC_KEPLER &&
+            config->integrator != VERNEDA_TAYLOR)
+        {
+            return fail(VERNEDA_ERR_INVALID_ARGUMENT, tools::string::print2string(
+                    "Unknown integrator '%d'.", (int) config->integrator));
+        }
+
+        // Problem and integrator
+        if (config->integrator == VERNEDA_ANALYTIC_KEPLER && config->problem != VERNEDA_TWO_BODY)
+        {
+            return fail(VERNEDA_ERR_INVALID_ARGUMENT, "The analytic Kepler integrator needs the two-body problem.");
+        }
+
+        // State size: position and velocity, or quaternion and angular velocity
+        unsigned int n_var = config->problem == VERNEDA_TWO_BODY ? 6 : 7;
+        if (config->n_var != n_var)
+        {
+            return fail(VERNEDA_ERR_INVALID_ARGUMENT, tools::string::print2string(
+                    "The problem needs '%u' variables, got '%u'.", n_var, config->n_var));
+        }
+
+        // Algebra
+        if (config->algorithm != VERNEDA_LOADS && config->order == 0)
+        {
+            return fail(VERNEDA_ERR_INVALID_ARGUMENT, "DA order must be greater than zero.");
+        }
+
+        // Distribution
+        if (!(config->confidence_interval > 0.0))
+        {
+            return fail(VERNEDA_ERR_INVALID_ARGUMENT, "Confidence interval must be positive.");
+        }
+        for (unsigned int i = 0; i < config->n_var; i++)
+        {
+            if (!(config->stddev[i] >= 0.0))
+            {
+                return fail(VERNEDA_ERR_INVALID_ARGUMENT, tools::string::print2string(
+                        "Standard deviation '%u' cannot be negative.", i));
+            }
+        }
+
+        // Splitting
+        if (config->algorithm != VERNEDA_NONE &&
+            (config->max_split < 0 || config->max_split > (int) SplittingHistory::capacity))
+        {
+            return fail(VERNEDA_ERR_INVALID_ARGUMENT, tools::string::print2string(
+                    "Maximum splits must be between 0 and '%u', got '%d'.", SplittingHistory::capacity,
+                    config->max_split));
+        }
+        if (config->algorithm == VERNEDA_LOADS && !(config->nli_threshold > 0.0))
+        {
+            return fail(VERNEDA_ERR_INVALID_ARGUMENT, "LOADS needs a positive NLI threshold.");
+        }
+        if (config->algorithm == VERNEDA_ADS)
+        {
+            for (unsigned int i = 0; i < config->n_var; i++)
+            {
+                if (!(config->tolerance[i] > 0.0))
+                {
+                    return fail(VERNEDA_ERR_INVALID_ARGUMENT, tools::string::print2string(
+                            "ADS tolerance '%u' must be positive.", i));
+                }
+            }
+        }
+
+        return VERNEDA_OK;
+    }
+
+    // Store a freshly built session
+    int store(std::unique_ptr<session> s, verneda_handle* handle)
+    {
+        *handle = session_registry::insert(std::move(s));
+        return VERNEDA_OK;
+    }
+}
+
+const char* verneda_version(void)
+{
+#ifdef CODE_VERSION
+    return CODE_VERSION;
+#else
+    return "unknown";
+#endif
+}
+
+const char* verneda_last_error(void)
+{
+    return last_error_.c_str();
+}
+
+int verneda_create_from_json(const char* json_path, verneda_handle* handle)
+{
+    // Safety checks
+    if (json_path == nullptr || handle == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_ARGUMENT, "json_path and handle must not be NULL.");
+    }
+
+    return guarded([&]()
+    {
+        auto specs = json_parser::parse_input_file(json_path);
+        return store(std::make_unique<session>(specs), handle);
+    });
+}
+
+int verneda_create(const verneda_config* config, verneda_handle* handle)
+{
+    // Safety checks
+    if (config == nullptr || handle == nullptr || config->mean == nullptr || config->stddev == nullptr ||
+        config->n_var == 0)
+    {
+        return fail(VERNEDA_ERR_INVALID_ARGUMENT, "config, handle, mean and stddev must not be NULL.");
+    }
+    if (config->problem == VERNEDA_FREE_TORQUE_MOTION && config->inertia == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_ARGUMENT, "The free torque motion problem needs the inertia matrix.");
+    }
+    if (config->algorithm == VERNEDA_ADS && config->tolerance == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_ARGUMENT, "ADS needs the tolerance vector.");
+    }
+    if (config->time_step <= 0.0 || config->final_time <= config->initial_time)
+    {
+        return fail(VERNEDA_ERR_INVALID_ARGUMENT, "Time step must be positive and final time greater than initial.");
+    }
+    if (check_config(config) != VERNEDA_OK)
+    {
+        return VERNEDA_ERR_INVALID_ARGUMENT;
+    }
+
+    return guarded([&]()
+    {
+        // Translate configuration into specifications
+        json_input specs{};
+        auto n = config->n_var;
+
+        specs.problem = config->problem == VERNEDA_TWO_BODY ? PROBLEM::TWO_BODY : PROBLEM::FREE_TORQUE_MOTION;
+        specs.algorithm =
+                config->algorithm == VERNEDA_ADS ? ALGORITHM::ADS :
+                config->algorithm == VERNEDA_LOADS ? ALGORITHM::LOADS : ALGORITHM::NONE;
+        specs.propagation.integrator =
+                config->integrator == VERNEDA_EULER ? INTEGRATOR::EULER :
+                config->integrator == VERNEDA_RK78 ? INTEGRATOR::RK78 :
+                config->integrator == VERNEDA_ANALYTIC_KEPLER ? INTEGRATOR::ANALYTIC_KEPLER :
+                config->integrator == VERNEDA_TAYLOR ? INTEGRATOR::TAYLOR : INTEGRATOR::RK4;
+        specs.algebra.order = specs.algorithm == ALGORITHM::LOADS ? 2 : (int) config->order;
+        specs.algebra.variables = (int) n;
+        specs.mu = config->mu;
+        specs.propagation.initial_time = config->initial_time;
+        specs.propagation.final_time = config->final_time;
+        specs.propagation.time_step = config->time_step;
+        specs.initial_conditions.mean.assign(config->mean, config->mean + n);
+        specs.initial_conditions.standard_deviation.assign(config->stddev, config->stddev + n);
+        specs.initial_conditions.confidence_interval = config->confidence_interval;
+        specs.loads.nli_threshold = config->nli_threshold;
+        specs.loads.max_split.assign(n, config->max_split);
+        specs.ads.max_split.assign(n, config->max_split);
+
+        // Tolerances
+        if (config->tolerance != nullptr)
+        {
+            specs.ads.tolerance.assign(config->tolerance, config->tolerance + n);
+        }
+
+        // Betas
+        for (unsigned int i = 0; i < n; i++)
+        {
+            specs.scaling.beta.push_back(config->confidence_interval * config->stddev[i]);
+        }
+
+        // Inertia
+        if (config->inertia != nullptr)
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                for (int j = 0; j < 3; j++)
+                {
+                    specs.initial_conditions.inertia[i][j] = config->inertia[i * 3 + j];
+                }
+            }
+        }
+
+        return store(std::make_unique<session>(specs), handle);
+    });
+}
+
+int verneda_propagate(verneda_handle handle)
+{
+    if (session_registry::find(handle) == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_HANDLE, "Invalid handle.");
+    }
+
+    return guarded([&]()
+    {
+        get_session(handle, false)->propagate();
+        return (int) VERNEDA_OK;
+    });
+}
+
+int verneda_extend(verneda_handle handle, double final_time)
+{
+    if (session_registry::find(handle) == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_HANDLE, "Invalid handle.");
+    }
+
+    return guarded([&]()
+    {
+        get_session(handle)->extend(final_time);
+        return (int) VERNEDA_OK;
+    });
+}
+
+int verneda_get_dimensions(verneda_handle handle, size_t* n_var, size_t* n_patches)
+{
+    if (session_registry::find(handle) == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_HANDLE, "Invalid handle.");
+    }
+
+    return guarded([&]()
+    {
+        auto s = get_session(handle);
+        if (n_var != nullptr) { *n_var = s->get_specs().algebra.variables; }
+        if (n_patches != nullptr) { *n_patches = s->get_manifold_fin()->size(); }
+        return (int) VERNEDA_OK;
+    });
+}
+
+int verneda_get_patch_info(verneda_handle handle, size_t patch, verneda_patch_info* info)
+{
+    if (session_registry::find(handle) == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_HANDLE, "Invalid handle.");
+    }
+    if (info == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_ARGUMENT, "info must not be NULL.");
+    }
+
+    return guarded([&]()
+    {
+        auto s = get_session(handle);
+        if (!patch_in_range(s, patch))
+        {
+            return fail(VERNEDA_ERR_INVALID_ARGUMENT, tools::string::print2string("Patch '%zu' out of range.", patch));
+        }
+
+        auto& p = s->get_manifold_fin()->at(patch);
+        info->id = p.id_;
+        info->t = p.t_;
+        info->nli = p.nli;
+        info->n_splits = p.get_history_int().size();
+        return (int) VERNEDA_OK;
+    });
+}
+
+int verneda_get_patch_box(verneda_handle handle, size_t patch, double* center, double* width, double* state,
+                          int* history, size_t capacity)
+{
+    if (session_registry::find(handle) == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_HANDLE, "Invalid handle.");
+    }
+
+    return guarded([&]()
+    {
+        auto s = get_session(handle);
+        if (!patch_in_range(s, patch))
+        {
+            return fail(VERNEDA_ERR_INVALID_ARGUMENT, tools::string::print2string("Patch '%zu' out of range.", patch));
+        }
+
+        auto& p = s->get_manifold_fin()->at(patch);
+
+        if (center != nullptr)
+        {
+            auto c = p.get_center();
+            std::copy(c.begin(), c.end(), center);
+        }
+        if (width != nullptr)
+        {
+            auto w = p.get_width();
+            std::copy(w.begin(), w.end(), width);
+        }
+        if (state != nullptr)
+        {
+            auto x = p.cons();
+            std::copy(x.begin(), x.end(), state);
+        }
+        if (history != nullptr)
+        {
+            auto h = p.get_history_int();
+            if (h.size() > capacity)
+            {
+                return fail(VERNEDA_ERR_INVALID_ARGUMENT, "History capacity is too small.");
+            }
+            std::copy(h.begin(), h.end(), history);
+        }
+        return (int) VERNEDA_OK;
+    });
+}
+
+int verneda_get_monomial_count(verneda_handle handle, size_t* n_mono)
+{
+    if (session_registry::find(handle) == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_HANDLE, "Invalid handle.");
+    }
+    if (n_mono == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_ARGUMENT, "n_mono must not be NULL.");
+    }
+
+    *n_mono = tools::vector::monomial_count();
+    return VERNEDA_OK;
+}
+
+int verneda_get_monomial_exponents(verneda_handle handle, unsigned int* exponents)
+{
+    if (session_registry::find(handle) == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_HANDLE, "Invalid handle.");
+    }
+    if (exponents == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_ARGUMENT, "exponents must not be NULL.");
+    }
+
+    // Column-major [n_var x n_mono] is the same memory as row-major [n_mono x n_var]
+    const auto& e = tools::vector::monomial_exponents();
+    std::copy(e.begin(), e.end(), exponents);
+    return VERNEDA_OK;
+}
+
+int verneda_get_patch_coefficients(verneda_handle handle, size_t patch, double* coeffs)
+{
+    if (session_registry::find(handle) == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_HANDLE, "Invalid handle.");
+    }
+    if (coeffs == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_ARGUMENT, "coeffs must not be NULL.");
+    }
+
+    return guarded([&]()
+    {
+        auto s = get_session(handle);
+        if (!patch_in_range(s, patch))
+        {
+            return fail(VERNEDA_ERR_INVALID_ARGUMENT, tools::string::print2string("Patch '%zu' out of range.", patch));
+        }
+
+        // Column-major [n_mono x n_var] is the same memory as row-major [n_var x n_mono]
+        tools::vector::pack_coefficients(s->get_manifold_fin()->at(patch), coeffs);
+        return (int) VERNEDA_OK;
+    });
+}
+
+int verneda_evaluate(verneda_handle handle, const double* samples, size_t n_samples, double* results)
+{
+    if (session_registry::find(handle) == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_HANDLE, "Invalid handle.");
+    }
+
+    return guarded([&]()
+    {
+        // Last segment
+        auto segment = get_session(handle)->get_segment_count() - 1;
+        return verneda_evaluate_segment(handle, segment, samples, n_samples, results);
+    });
+}
+
+int verneda_get_segment_count(verneda_handle handle, size_t* n_segments)
+{
+    if (session_registry::find(handle) == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_HANDLE, "Invalid handle.");
+    }
+    if (n_segments == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_ARGUMENT, "n_segments must not be NULL.");
+    }
+
+    return guarded([&]()
+    {
+        *n_segments = get_session(handle)->get_segment_count();
+        return (int) VERNEDA_OK;
+    });
+}
+
+int verneda_get_segment_time(verneda_handle handle, size_t segment, double* t)
+{
+    if (session_registry::find(handle) == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_HANDLE, "Invalid handle.");
+    }
+    if (t == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_ARGUMENT, "t must not be NULL.");
+    }
+
+    return guarded([&]()
+    {
+        auto s = get_session(handle);
+        if (!segment_in_range(s, segment))
+        {
+            return fail(VERNEDA_ERR_INVALID_ARGUMENT, tools::string::print2string("Segment '%zu' out of range.",
+                                                                                  segment));
+        }
+
+        *t = s->get_segment_time(segment);
+        return (int) VERNEDA_OK;
+    });
+}
+
+int verneda_evaluate_segment(verneda_handle handle, size_t segment, const double* samples, size_t n_samples,
+                             double* results)
+{
+    if (session_registry::find(handle) == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_HANDLE, "Invalid handle.");
+    }
+    if ((samples == nullptr || results == nullptr) && n_samples > 0)
+    {
+        return fail(VERNEDA_ERR_INVALID_ARGUMENT, "samples and results must not be NULL.");
+    }
+
+    return guarded([&]()
+    {
+        auto s = get_session(handle);
+        if (!segment_in_range(s, segment))
+        {
+            return fail(VERNEDA_ERR_INVALID_ARGUMENT, tools::string::print2string("Segment '%zu' out of range.",
+                                                                                  segment));
+        }
+        std::size_t n = s->get_specs().algebra.variables;
+
+        // Build samples
+        std::vector<DACE::AlgebraicVector<double>> points(n_samples, DACE::AlgebraicVector<double>(n));
+        for (std::size_t k = 0; k < n_samples; k++)
+        {
+            std::copy(samples + k * n, samples + (k + 1) * n, points[k].begin());
+        }
+
+        // Evaluate
+        auto evals = s->evaluate(points, (int) segment);
+        for (std::size_t k = 0; k < n_samples; k++)
+        {
+            std::copy(evals[k].begin(), evals[k].end(), results + k * n);
+        }
+        return (int) VERNEDA_OK;
+    });
+}
+
+int verneda_get_mixture(verneda_handle handle, size_t max_components, size_t* n_components, double* weights,
+                        double* means, double* covariances)
+{
+    if (session_registry::find(handle) == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_HANDLE, "Invalid handle.");
+    }
+    if (n_components == nullptr)
+    {
+        return fail(VERNEDA_ERR_INVALID_ARGUMENT, "n_components must not be NULL.");
+    }
+
+    return guarded([&]()
+    {
+        // Extract and merge
+        auto s = get_session(handle);
+        auto components = mixture::extract(*s->get_manifold_fin(), s->get_specs().initial_conditions.confidence_interval);
+        mixture::reduce(components, max_components);
+        *n_components = components.size();
+
+        // Copy
+        for (std::size_t c = 0; c < components.size(); c++)
+        {
+            const auto& g = components[c];
+            if (weights != nullptr) { weights[c] = g.weight; }
+            if (means != nullptr) { std::copy(g.mean.begin(), g.mean.end(), means + c * g.mean.size()); }
+            if (covariances != nullptr)
+            {
+                std::copy(g.covariance.begin(), g.covariance.end(), covariances + c * g.covariance.size());
+            }
+        }
+        return (int) VERNEDA_OK;
+    });
+}
+
+int verneda_free(verneda_handle handle)
+{
+    return session_registry::erase(handle) ? VERNEDA_OK : fail(VERNEDA_ERR_INVALID_HANDLE, "Invalid handle.");
+}
@@ -0,0 +1,173 @@
+/**
+ * VerneDA C ABI: drive the propagation engine (integrator, SuperManifold and samples evaluation) from C, ctypes or any
+ * other language with a C FFI, without MATLAB.
+ * @details:
+ *  - Scenarios are referenced by opaque handles, see session_registry.
+ *  - Every function returns a VERNEDA_STATUS code, the message of the last error of the calling thread can be
+ *    retrieved with verneda_last_error().
+ *  - Arrays are always caller-allocated and row-major: one sample/patch per row.
+ *  - DACE is global, all the scenarios alive at the same time must share the same algebra (order and variables).
+ */
+
+#ifndef VERNEDA_H
+#define VERNEDA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Opaque scenario handle, 0 is never a valid handle */
+typedef uint64_t verneda_handle;
+
+/** Status codes */
+typedef enum
+{
+    VERNEDA_OK = 0,
+    VERNEDA_ERR_INVALID_HANDLE = 1,
+    VERNEDA_ERR_INVALID_ARGUMENT = 2,
+    VERNEDA_ERR_RUNTIME = 3
+} VERNEDA_STATUS;
+
+/** Problems */
+typedef enum
+{
+    VERNEDA_TWO_BODY = 0,
+    VERNEDA_FREE_TORQUE_MOTION = 1
+} VERNEDA_PROBLEM;
+
+/** Splitting algorithms */
+typedef enum
+{
+    VERNEDA_ADS = 0,
+    VERNEDA_LOADS = 1,
+    VERNEDA_NONE = 2
+} VERNEDA_ALGORITHM;
+
+/** Integrators */
+typedef enum
+{
+    VERNEDA_RK4 = 0,
+    VERNEDA_EULER = 1,
+    VERNEDA_RK78 = 2,
+    VERNEDA_ANALYTIC_KEPLER = 3,
+    VERNEDA_TAYLOR = 4              /**< Automatic steps, default tolerance */
+} VERNEDA_INTEGRATOR;
+
+/**
+ * Scenario configuration. The mean is used as it is (i.e., a quaternion for the attitude problem), the DA box is
+ * centered on it with half-widths 'confidence_interval * stddev'.
+ */
+typedef struct
+{
+    VERNEDA_PROBLEM problem;
+    VERNEDA_ALGORITHM algorithm;
+    VERNEDA_INTEGRATOR integrator;
+    unsigned int order;             /**< DA order, forced to 2 by LOADS */
+    unsigned int n_var;             /**< Number of state variables */
+    const double* mean;             /**< [n_var] */
+    const double* stddev;           /**< [n_var] */
+    double confidence_interval;
+    double mu;                      /**< Gravitational parameter (two-body) */
+    const double* inertia;          /**< [3 x 3] row-major (free torque motion), NULL otherwise */
+    double initial_time;
+    double final_time;
+    double time_step;
+    double nli_threshold;           /**< LOADS */
+    const double* tolerance;        /**< [n_var] ADS truncation error tolerances */
+    int max_split;                  /**< Maximum number of splits per patch */
+} verneda_config;
+
+/** Patch information */
+typedef struct
+{
+    int id;
+    double t;                       /**< Time reached by the patch */
+    double nli;                     /**< NLI at the last split */
+    size_t n_splits;                /**< Length of the splitting history */
+} verneda_patch_info;
+
+/** Version of the library */
+const char* verneda_version(void);
+
+/** Message of the last error in the calling thread */
+const char* verneda_last_error(void);
+
+/** Create a scenario from a VerneDA JSON input file. The file is checked by the JSON parser, which exits the process
+ * on invalid input: validate it with dace_vsod beforehand or prefer verneda_create() */
+int verneda_create_from_json(const char* json_path, verneda_handle* handle);
+
+/** Create a scenario from a configuration structure, fully checked: VERNEDA_ERR_INVALID_ARGUMENT if it is invalid */
+int verneda_create(const verneda_config* config, verneda_handle* handle);
+
+/** Propagate the scenario up to its final time */
+int verneda_propagate(verneda_handle handle);
+
+/** Propagate an already propagated scenario further, up to a new final time */
+int verneda_extend(verneda_handle handle, double final_time);
+
+/** Number of state variables and number of patches of the propagated scenario */
+int verneda_get_dimensions(verneda_handle handle, size_t* n_var, size_t* n_patches);
+
+/** Information of one patch */
+int verneda_get_patch_info(verneda_handle handle, size_t patch, verneda_patch_info* info);
+
+/**
+ * Box of one patch in the normalized initial domain [-1, 1]^n_var, and its constant part (center image).
+ * Any output pointer can be NULL.
+ * @param center [n_var]
+ * @param width [n_var]
+ * @param state [n_var]
+ * @param history [capacity], the splitting history (see SplittingHistory)
+ */
+int verneda_get_patch_box(verneda_handle handle, size_t patch, double* center, double* width, double* state,
+                          int* history, size_t capacity);
+
+/** Number of monomials per component in the dense coefficient layout */
+int verneda_get_monomial_count(verneda_handle handle, size_t* n_mono);
+
+/** Monomial exponents: [n_mono x n_var] row-major */
+int verneda_get_monomial_exponents(verneda_handle handle, unsigned int* exponents);
+
+/** Polynomial coefficients of one patch: [n_var x n_mono] row-major */
+int verneda_get_patch_coefficients(verneda_handle handle, size_t patch, double* coeffs);
+
+/**
+ * Evaluate samples: deviations from the mean, in real units.
+ * @param samples [n_samples x n_var]
+ * @param results [n_samples x n_var]
+ */
+int verneda_evaluate(verneda_handle handle, const double* samples, size_t n_samples, double* results);
+
+/** Number of segments of a segmented propagation (1 if not segmented) */
+int verneda_get_segment_count(verneda_handle handle, size_t* n_segments);
+
+/** Final time of one segment */
+int verneda_get_segment_time(verneda_handle handle, size_t segment, double* t);
+
+/** Same as verneda_evaluate, at the final epoch of one segment */
+int verneda_evaluate_segment(verneda_handle handle, size_t segment, const double* samples, size_t n_samples,
+                             double* results);
+
+/**
+ * Gaussian mixture of the propagated manifold: one component per patch, linearized at the center of its box and
+ * weighted by its probability mass, merged down to 'max_components' (0 for one per patch). Any output array can be
+ * NULL, to query the number of components first.
+ * @param n_components [out] number of components written
+ * @param weights [max_components] or [n_patches] if 'max_components' is 0
+ * @param means [n_components x n_var]
+ * @param covariances [n_components x n_var x n_var]
+ */
+int verneda_get_mixture(verneda_handle handle, size_t max_components, size_t* n_components, double* weights,
+                        double* means, double* covariances);
+
+/** Destroy a scenario */
+int verneda_free(verneda_handle handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VERNEDA_H
@@ -4,8 +4,11 @@
 
 #include "delta.h"
 
+#include <algorithm>
 #include <utility>
 
+#include "tools/math.h"
+
 void delta::generate_deltas(DISTRIBUTION type, int n)
 {
     // Place for the all safety checks before computing HERE BELOW:
@@ -34,6 +37,9 @@ void delta::generate_deltas(DISTRIBUTION type, int n)
         this->attitude_safety_checks();
     }
 
+    // Patches of the previous deltas no longer apply
+    this->strata_.clear();
+
     // If normal distribution chosen:
     switch (type)
     {
@@ -44,6 +50,12 @@ void delta::generate_deltas(DISTRIBUTION type, int n)
             this->generate_gaussian_deltas(n);
             break;
         }
+        case DISTRIBUTION::STRATIFIED:
+        {
+            // Generate gaussian deltas patch by patch
+            this->generate_stratified_deltas(n);
+            break;
+        }
         default:
         {
             // Throw FATAL
@@ -151,8 +163,152 @@ void delta::generate_gaussian_deltas(int n)
     this->scv_deltas_ = std::make_shared<std::vector<DACE::AlgebraicVector<double>>>(deltas);
 }
 
+void delta::generate_stratified_deltas(int n)
+{
+    // Safety checks
+    if (this->sm_ == nullptr)
+    {
+        std::fprintf(stderr, "FATAL: Stratified deltas are drawn patch by patch, set the super manifold before "
+                             "generating them. Exiting program.\n");
+        std::exit(-1);
+    }
+
+    if (this->attitude_)
+    {
+        std::fprintf(stderr, "FATAL: Stratified deltas are not available for attitude: the quaternion is not sampled "
+                             "in the box of the initial domain. Exiting program.\n");
+        std::exit(-1);
+    }
+
+    // Final manifold and half widths of the initial domain
+    auto manifold = this->sm_->get_manifold_fin();
+    auto hw = this->initial_half_widths();
+
+    if (this->stddevs_.size() != hw.size())
+    {
+        std::fprintf(stderr, "FATAL: Stratified deltas need one standard deviation per variable ('%zu' given, '%zu' "
+                             "variables). Exiting program.\n", this->stddevs_.size(), hw.size());
+        std::exit(-1);
+    }
+
+    // Standard deviations in the normalized initial domain, [-1, 1] in every direction
+    std::vector<double> sigma(hw.size(), 0.0);
+    for (std::size_t k = 0; k < hw.size(); k++)
+    {
+        sigma[k] = hw[k] != 0.0 ? this->stddevs_[k] / hw[k] : 0.0;
+    }
+
+    // Confidence interval of the initial box, only needed if the final manifold has not been weighted
+    double confidence_interval = 0.0;
+    for (const auto & s : sigma)
+    {
+        if (s != 0.0)
+        {
+            confidence_interval = 1.0 / s;
+            break;
+        }
+    }
+
+    // Probability mass of every patch box, the same one written with the final manifold
+    std::vector<double> mass(manifold->size(), 0.0);
+    double total = 0.0;
+    for (std::size_t i = 0; i < manifold->size(); i++)
+    {
+        const auto & p = manifold->at(i);
+        mass[i] = p.mass_ >= 0.0 ? p.mass_ : p.probability_mass(confidence_interval);
+        total += mass[i];
+    }
+
+    if (!(total > 0.0))
+    {
+        std::fprintf(stderr, "FATAL: The patches of the final manifold hold no gaussian mass, cannot draw "
+                             "stratified deltas. Exiting program.\n");
+        std::exit(-1);
+    }
+
+    // Samples per patch: integer part of its share, then one more for the largest remainders until 'n' is reached
+    std::vector<int> count(manifold->size(), 0);
+    std::vector<std::pair<double, std::size_t>> remainders;
+    remainders.reserve(manifold->size());
+    int assigned = 0;
+    for (std::size_t i = 0; i < manifold->size(); i++)
+    {
+        double share = n * mass[i] / total;
+        count[i] = (int) std::floor(share);
+        assigned += count[i];
+        remainders.emplace_back(share - count[i], i);
+    }
+    std::stable_sort(remainders.begin(), remainders.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
+    for (int j = 0; assigned < n; j++, assigned++)
+    {
+        count[remainders[j % remainders.size()].second]++;
+    }
+
+    // Stack results here, patch by patch
+    std::vector<DACE::AlgebraicVector<double>> deltas;
+    deltas.reserve(n + 1);
+    this->strata_.reserve(n + 1);
+
+    // Call to random engine generator
+    std::default_random_engine generator;
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    for (std::size_t i = 0; i < manifold->size(); i++)
+    {
+        // Box of the patch
+        auto c = manifold->at(i).get_center();
+        auto w = manifold->at(i).get_width();
+
+        for (int s = 0; s < count[i]; s++)
+        {
+            // Gaussian truncated to the box, in standard deviations, back to physical units
+            DACE::AlgebraicVector<double> new_delta(hw.size(), 0.0);
+            for (std::size_t k = 0; k < hw.size(); k++)
+            {
+                if (sigma[k] != 0.0)
+                {
+                    new_delta[k] = this->stddevs_[k] * tools::math::truncated_normal(
+                            (c[k] - 0.5 * w[k]) / sigma[k], (c[k] + 0.5 * w[k]) / sigma[k], uniform(generator));
+                }
+            }
+
+            // Append scv in the list, with its patch
+            deltas.push_back(new_delta);
+            this->strata_.push_back((int) i);
+        }
+    }
+
+    // Make shared and save
+    this->scv_deltas_ = std::make_shared<std::vector<DACE::AlgebraicVector<double>>>(deltas);
+}
+
+DACE::AlgebraicVector<double> delta::initial_half_widths()
+{
+    // Initial domain
+    const DACE::AlgebraicVector<DACE::DA>& init_set = this->sm_->previous_->front();
+
+    // Its polynomial at the corner of the normalized box
+    DACE::AlgebraicVector<double> ones(DACE::DA::getMaxVariables(), 1.0);
+    auto hw = (init_set - init_set.cons()).eval(ones);
+
+    // Make it absolute values
+    for (double & i : hw)
+    {
+        i = std::fabs(i);
+    }
+
+    return hw;
+}
+
 void delta::evaluate_deltas()
 {
+    // Profile
+    PROFILE_SCOPE(PROFILE_SECTION::EVALUATE_DELTAS);
+    tools::trace::scoped_span trace_span("evaluate_deltas", "evaluate");
+    trace_span.set_args(tools::string::print2string("\"samples\": %zu",
+                                                    this->scv_deltas_ == nullptr ? 0 : this->scv_deltas_->size()));
+
     // Safety check
     if (!this->zeroed_inserted_)
     {
@@ -166,14 +322,48 @@ void delta::evaluate_deltas()
     // Reserve space for optimal memory management
     taylor_list.reserve(this->scv_deltas_->size());
 
+    // Stratified deltas: the patch is known, its polynomial is compiled once for all its deltas
+    auto manifold = this->sm_->get_manifold_fin();
+    DACE::AlgebraicVector<double> hw = this->strata_.empty() ? DACE::AlgebraicVector<double>() :
+                                       this->initial_half_widths();
+    std::unique_ptr<DACE::compiledDA> compiled = nullptr;
+    DACE::AlgebraicVector<double> c, w;
+    int compiled_patch = -1;
+
     // Evaluate each delta
-    for (const auto& scv_delta : *this->scv_deltas_)
+    for (std::size_t j = 0; j < this->scv_deltas_->size(); j++)
     {
-        // Evaluate and save
-        auto single_sol = this->sm_->get_manifold_fin()->pointEvaluationManifold(
-                this->sm_->previous_->front(),
-                scv_delta.cons(),
-                1);
+        const auto& scv_delta = this->scv_deltas_->at(j);
+        int stratum = j < this->strata_.size() ? this->strata_[j] : -1;
+
+        DACE::AlgebraicVector<double> single_sol;
+        if (stratum >= 0)
+        {
+            // New patch
+            if (stratum != compiled_patch)
+            {
+                compiled = std::make_unique<DACE::compiledDA>(manifold->at(stratum).compile());
+                c = manifold->at(stratum).get_center();
+                w = manifold->at(stratum).get_width();
+                compiled_patch = stratum;
+            }
+
+            // Normalize in the initial domain, then in the patch
+            DACE::AlgebraicVector<double> pt(hw.size(), 0.0);
+            for (std::size_t k = 0; k < hw.size(); k++)
+            {
+                double unit = hw[k] != 0.0 ? scv_delta[k] / hw[k] : 0.0;
+                pt[k] = 2.0 * (unit - c[k]) / w[k];
+            }
+
+            // Evaluate
+            single_sol = compiled->eval(pt);
+        }
+        else
+        {
+            // Locate it and evaluate
+            single_sol = manifold->pointEvaluationManifold(this->sm_->previous_->front(), scv_delta.cons(), 1);
+        }
         if (single_sol.empty())
         {
             continue;
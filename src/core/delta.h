@@ -66,10 +66,10 @@ public: // Set options
     void insert_nominal(const DACE::AlgebraicVector<double>& n);
 
     /**
-     * Compute the deltas. Constants need to be set for this.
+     * Compute the deltas. Constants need to be set for this. STRATIFIED also needs the super manifold, since the
+     * samples are drawn patch by patch.
      * @param type [in] [DISTRIBUTION]
      * @param n [in] [int]
-     * @param state [in] [STATE]
      */
     void generate_deltas(DISTRIBUTION type, int n);
 
@@ -112,6 +112,15 @@ public: // Getters
         return this->scv_deltas_;
     };
 
+    /**
+     * Patch of the final manifold every sample was drawn in, -1 if it has to be located (gaussian samples, nominal).
+     * @return std::vector<int>
+     */
+    [[nodiscard]] const std::vector<int>& get_strata() const
+    {
+        return this->strata_;
+    };
+
     /**
      * Return saved manifold in this class
      * @return SuperManifold
@@ -131,6 +140,8 @@ private:
     std::shared_ptr<std::vector<DACE::AlgebraicVector<double>>> scv_deltas_ = nullptr;
     // List of results:
     std::shared_ptr<std::vector<DACE::AlgebraicVector<double>>> eval_deltas_poly_ = nullptr;
+    // Patch of every delta, empty if none was drawn patch by patch
+    std::vector<int> strata_{};
 
 private:
 
@@ -169,6 +180,20 @@ private: // Class functions
      */
     void generate_gaussian_deltas(int n);
 
+    /**
+     * Stratified gaussian deltas: every patch of the final manifold gets a number of samples proportional to the
+     * gaussian mass of its box in the initial domain (largest remainders for the rounding, so that they add up to 'n'),
+     * drawn from the gaussian truncated to that box.
+     * @param n [in] [int]
+     */
+    void generate_stratified_deltas(int n);
+
+    /**
+     * Half widths of the initial domain, as 'pointEvaluationManifold' normalizes the points.
+     * @return DACE::AlgebraicVector<double>
+     */
+    DACE::AlgebraicVector<double> initial_half_widths();
+
 private: // Safety checks
 
     /**
@@ -5,6 +5,10 @@
 #include "integrator.h"
 #include "ads/Patch.h"
 
+// System libraries
+#include <cmath>
+#include <limits>
+
 integrator::integrator(INTEGRATOR integrator, ALGORITHM algorithm, double stepmax)
 {
     // Set type
@@ -48,6 +52,9 @@ DACE::AlgebraicVector<DACE::DA> integrator::Euler(DACE::AlgebraicVector<DACE::DA
                 x = x_prev;
                 break;
             }
+
+            // Order of the next step
+            this->adapt_order(x);
         }
 
         // Increase step time
@@ -62,6 +69,9 @@ DACE::AlgebraicVector<DACE::DA> integrator::Euler(DACE::AlgebraicVector<DACE::DA
 
 DACE::AlgebraicVector<DACE::DA> integrator::Euler_step(const DACE::AlgebraicVector<DACE::DA>& x, double t, double h) const
 {
+    // Profile
+    PROFILE_SCOPE(PROFILE_SECTION::STEP);
+
     return x + h * (this->problem_->solve(x, t));
 }
 
@@ -122,6 +132,9 @@ DACE::AlgebraicVector<DACE::DA> integrator::RK4(DACE::AlgebraicVector<DACE::DA>
                 x = x_prev;
                 break;
             }
+
+            // Order of the next step
+            this->adapt_order(x);
         }
 
         // Increase step time
@@ -147,6 +160,9 @@ DACE::AlgebraicVector<DACE::DA> integrator::RK4(DACE::AlgebraicVector<DACE::DA>
 
 DACE::AlgebraicVector<DACE::DA> integrator::RK4_step(const DACE::AlgebraicVector<DACE::DA>& x, double t, double h)
 {
+    // Profile
+    PROFILE_SCOPE(PROFILE_SECTION::STEP);
+
     // Compute points in between
     auto k1 = this->problem_->solve(x, t);
     auto k2 = this->problem_->solve(x + h * (k1/3), t + h/3);
@@ -157,6 +173,333 @@ DACE::AlgebraicVector<DACE::DA> integrator::RK4_step(const DACE::AlgebraicVector
     return x + h * (k1 + 3*k2 + 3*k3 + k4)/8;
 }
 
+DACE::AlgebraicVector<DACE::DA> integrator::taylor_step(const DACE::AlgebraicVector<DACE::DA>& x, double& h) const
+{
+    // Profile
+    PROFILE_SCOPE(PROFILE_SECTION::STEP);
+
+    // Order of the series: the error of a step is of the order of the tolerance
+    auto order = (unsigned int) std::max(2.0, std::ceil(1.0 - 0.5*std::log(this->tolerance_)));
+
+    // Coefficients of the series
+    auto coefficients = this->problem_->taylor_coefficients(x, order);
+
+    // Size of a coefficient: largest DA coefficient of any component
+    auto size = [](const DACE::AlgebraicVector<DACE::DA>& c)
+    {
+        double largest = 0.0;
+        for (const auto& ci : c)
+        {
+            largest = std::max(largest, ci.norm(0));
+        }
+        return largest;
+    };
+
+    // Tolerance relative to the state, absolute if small
+    double tolerance = this->tolerance_ * std::max(1.0, size(coefficients[0]));
+
+    // Step from the last two coefficients: the DA truncation drops the tiny ones, so the last two not dropped
+    int used = 0;
+    for (unsigned int j = order; j > 0 && used < 2; j--)
+    {
+        // Safety check: a dropped coefficient does not bound the step
+        double size_j = size(coefficients[j]);
+        if (size_j > 0.0)
+        {
+            h = std::min(h, std::pow(tolerance / size_j, 1.0 / j));
+            used++;
+        }
+    }
+
+    // Sum the series, Horner
+    auto result = coefficients[order];
+    for (unsigned int j = order; j-- > 0;)
+    {
+        result = coefficients[j] + h * result;
+    }
+
+    return result;
+}
+
+template<typename S>
+DACE::AlgebraicVector<DACE::DA> integrator::RK4_variational(const DACE::AlgebraicVector<DACE::DA>& x)
+{
+    // Set not end
+    this->end_ = false;
+
+    // Nominal state, STM (and STT), initial polynomials
+    S y_prev;
+    variational::from_da(x, y_prev, this->initial_linear_, this->initial_hessian_);
+    auto y = y_prev;
+
+    // Auxiliary bool
+    bool flag_interruption_errToll;
+    int i = 0;
+
+    // Iterate
+    for(i = 0; this->t_ < this->t1_; i++)
+    {
+        // Print detailed info
+        this->print_detailed_information(std::vector<double>(y_prev.x.begin(), y_prev.x.end()), i, this->t_);
+
+        // Compute the single step
+        y = variational::rk4_step(*this->problem_, y_prev, this->t_, this->h_);
+
+        // Normalize quaternion if attitude
+        if (this->problem_->get_type() == PROBLEM::FREE_TORQUE_MOTION)
+        {
+            variational::normalize_quaternion(y);
+        }
+
+        // Check ADS conditions to continue integration
+        if (this->interrupt_)
+        {
+            // Check returned flag
+            flag_interruption_errToll = this->check_variational_conditions(y);
+
+            // Break integration if needed
+            if (flag_interruption_errToll && this->interrupt_)
+            {
+                // Set result to the previous one
+                y = y_prev;
+                break;
+            }
+        }
+
+        // Increase step time
+        this->t_ += this->h_;
+
+        // Update previous for next iteration
+        y_prev = y;
+    }
+
+    // Check end condition
+    this->end_ = this->t_ >= this->t1_;
+
+    // Print info
+    if (this->end_)
+    {
+        // Print detailed info
+        this->print_detailed_information(std::vector<double>(y_prev.x.begin(), y_prev.x.end()), i, this->t_);
+    }
+
+    // Back to DA
+    return variational::to_da(y, this->initial_linear_, this->initial_hessian_);
+}
+
+template<std::size_t N>
+bool integrator::check_variational_conditions(const variational::linear_state<N>& y)
+{
+    // ADS: truncation error of the DA map
+    if (this->algorithm_ != ALGORITHM::LOADS)
+    {
+        return this->check_conditions(variational::to_da(y, this->initial_linear_, this->initial_hessian_));
+    }
+
+    // LOADS: the Jacobian of an affine map is constant, its NLI is zero and it never splits
+    this->nli_current_ = 0.0;
+    this->nonlinearity_ratio_ = 0.0;
+    this->record_check();
+
+    return false;
+}
+
+template<std::size_t N>
+bool integrator::check_variational_conditions(const variational::quadratic_state<N>& y)
+{
+    // ADS: truncation error of the DA map
+    if (this->algorithm_ != ALGORITHM::LOADS)
+    {
+        return this->check_conditions(variational::to_da(y, this->initial_linear_, this->initial_hessian_));
+    }
+
+    // LOADS: straight from the derivatives of the map
+    variational::compose(y, this->initial_linear_, this->initial_hessian_, this->map_jacobian_, this->map_hessian_);
+    bool result = this->check_loads_conditions(this->map_jacobian_, this->map_hessian_, (int) N, true);
+    this->record_check();
+
+    return result;
+}
+
+int integrator::variational_order() const
+{
+    // First or second order, every patch at it, and a state the dense kernels know
+    int order = (int) DACE::DA::getMaxOrder();
+    bool dense = (order == 1 || (order == 2 && this->min_order_ == 0)) && this->problem_->has_variational() &&
+                 (this->nvar_ == 6 || this->nvar_ == 7);
+
+    return dense ? order : 0;
+}
+
+DACE::AlgebraicVector<DACE::DA> integrator::analytic_kepler(DACE::AlgebraicVector<DACE::DA> x)
+{
+    // Set not end
+    this->end_ = false;
+
+    // Safety check: Kepler only applies to the two-body problem
+    if (this->problem_->get_type() != PROBLEM::TWO_BODY)
+    {
+        // Info
+        std::fprintf(stderr, "The analytic Kepler propagator can only be used with the two-body problem, "
+                             "got: '%s'.\n", tools::enums::PROBLEM2str(this->problem_->get_type()).c_str());
+
+        // Exit code
+        std::exit(51);
+    }
+
+    // Auxiliary previous state
+    auto x_prev = x;
+
+    // Auxiliary bool
+    bool flag_interruption_errToll;
+
+    // Gravitational parameter
+    double mu = this->problem_->get_mu();
+
+    // Sub-epoch length
+    double h;
+    int i = 0;
+
+    // Iterate through the sub-epochs
+    for(i = 0; this->t_ < this->t1_; i++)
+    {
+        // Print detailed info
+        this->print_detailed_information(x_prev, i, this->t_);
+
+        // Do not go beyond the final time
+        h = std::min(this->h_, this->t1_ - this->t_);
+
+        // Propagate from the previous sub-epoch to the next one
+        {
+            PROFILE_SCOPE(PROFILE_SECTION::STEP);
+            x = kepler::propagate<DACE::DA, double>(x_prev, h, mu);
+        }
+
+        // Check ADS conditions to continue propagation
+        if (this->interrupt_)
+        {
+            // Check returned flag
+            flag_interruption_errToll = this->check_conditions(x, true);
+
+            // Break propagation if needed
+            if (flag_interruption_errToll && this->interrupt_)
+            {
+                // Set result to the previous one
+                x = x_prev;
+                break;
+            }
+
+            // Order of the next step
+            this->adapt_order(x);
+        }
+
+        // Increase time
+        this->t_ += h;
+
+        // Update previous for next iteration
+        x_prev = x;
+    }
+
+    // Check end condition
+    this->end_ = this->t_ >= this->t1_;
+
+    // Print info
+    if (this->end_)
+    {
+        // Print detailed info
+        this->print_detailed_information(x_prev, i, this->t_);
+    }
+
+    // Return state
+    return x;
+}
+
+DACE::AlgebraicVector<DACE::DA> integrator::taylor(DACE::AlgebraicVector<DACE::DA> x)
+{
+    // Set not end
+    this->end_ = false;
+
+    // Safety check: the recurrences of the series are only known for these problems
+    if (this->problem_->get_type() != PROBLEM::TWO_BODY && this->problem_->get_type() != PROBLEM::FREE_TORQUE_MOTION)
+    {
+        // Info
+        std::fprintf(stderr, "The Taylor integrator can only be used with the two-body or the free torque motion "
+                             "problems, got: '%s'.\n", tools::enums::PROBLEM2str(this->problem_->get_type()).c_str());
+
+        // Exit code
+        std::exit(51);
+    }
+
+    // Auxiliary previous state
+    auto x_prev = x;
+
+    // Auxiliary bool
+    bool flag_interruption_errToll;
+
+    // Step length, chosen by every step
+    double h;
+    int i = 0;
+
+    // Iterate
+    for(i = 0; this->t_ < this->t1_; i++)
+    {
+        // Print detailed info
+        this->print_detailed_information(x_prev, i, this->t_);
+
+        // Compute the single step, at most up to the final time
+        h = this->t1_ - this->t_;
+        x = this->taylor_step(x_prev, h);
+
+        // Normalize quaternion if attitude
+        if (this->problem_->get_type() == PROBLEM::FREE_TORQUE_MOTION)
+        {
+            auto q = x.extract(0, 3);
+            q = q / q.vnorm().cons();
+            x[0] = q[0];
+            x[1] = q[1];
+            x[2] = q[2];
+            x[3] = q[3];
+        }
+
+        // Check ADS conditions to continue integration
+        if (this->interrupt_)
+        {
+            // Check returned flag
+            flag_interruption_errToll = this->check_conditions(x, true);
+
+            // Break integration if needed
+            if (flag_interruption_errToll && this->interrupt_)
+            {
+                // Set result to the previous one
+                x = x_prev;
+                break;
+            }
+
+            // Order of the next step
+            this->adapt_order(x);
+        }
+
+        // Increase step time: exactly the final time on the last step
+        this->t_ = h == this->t1_ - this->t_ ? this->t1_ : this->t_ + h;
+
+        // Update previous for next iteration
+        x_prev = x;
+    }
+
+    // Check end condition
+    this->end_ = this->t_ >= this->t1_;
+
+    // Print info
+    if (this->end_)
+    {
+        // Print detailed info
+        this->print_detailed_information(x_prev, i, this->t_);
+    }
+
+    // Return state
+    return x;
+}
+
 DACE::AlgebraicVector<DACE::DA> integrator::static_transformation(DACE::AlgebraicVector<DACE::DA> x)
 {
     // Set not end
@@ -194,9 +537,15 @@ DACE::AlgebraicVector<DACE::DA> integrator::static_transformation(DACE::Algebrai
 }
 
 void integrator::print_detailed_information(const DACE::AlgebraicVector<DACE::DA>& x, int i, double t)
+{
+    // Constant part only
+    this->print_detailed_information(static_cast<std::vector<double>>(x.cons()), i, t);
+}
+
+void integrator::print_detailed_information(const std::vector<double>& x_cons, int i, double t)
 {
     // Get the information of x
-    auto str2debug = tools::vector::da_cons2string(x, ", ", "%3.8f");
+    auto str2debug = tools::vector::num2string<double>(x_cons, ", ", "%3.8f");
 
     // Patch or not?
     auto str2print = this->patch_id_ > -1 ? tools::string::print2string("p: %6d | ", this->patch_id_) : "";
@@ -215,7 +564,7 @@ void integrator::print_detailed_information(const DACE::AlgebraicVector<DACE::DA
     if (this->problem_->get_type() == PROBLEM::FREE_TORQUE_MOTION)
     {
         // Extract the quaternion from here if attitude
-        auto q_cons = x.cons().extract(0, 3);
+        auto q_cons = DACE::AlgebraicVector<double>(x_cons).extract(0, 3);
 
         if (i == 4110)
         {
@@ -277,15 +626,141 @@ void integrator::set_integration_parameters(const DACE::AlgebraicVector<DACE::DA
     }
 }
 
+void integrator::extend_final_time(double t1)
+{
+    // Safety check
+    if (!this->params_set_ || t1 <= this->t1_)
+    {
+        // Info
+        std::fprintf(stderr, "Cannot extend the final time from '%.6f' to '%.6f'.\n", this->t1_, t1);
+
+        // Exit code
+        std::exit(52);
+    }
+
+    // Steps for the new interval
+    this->steps_ = std::ceil((t1 - this->t1_) / this->hmax_);
+
+    // Delta time
+    this->h_ = (t1 - this->t1_) / this->steps_;
+
+    // Set new final time
+    this->t1_ = t1;
+}
+
+void integrator::set_stop_time(double t_start, double t1)
+{
+    // Safety check
+    if (!this->params_set_ || t1 <= t_start || t1 > this->t1_)
+    {
+        // Info
+        std::fprintf(stderr, "Cannot stop the integration from '%.6f' at '%.6f', final time is '%.6f'.\n", t_start, t1,
+                     this->t1_);
+
+        // Exit code
+        std::exit(52);
+    }
+
+    // Steps for the shorter interval
+    this->steps_ = std::ceil((t1 - t_start) / this->hmax_);
+
+    // Delta time
+    this->h_ = (t1 - t_start) / this->steps_;
+
+    // Set new final time
+    this->t1_ = t1;
+}
+
+void integrator::write_checkpoint(std::ostream& os) const
+{
+    // Identification
+    tools::io::binary::write<int>(os, (int) this->type);
+    tools::io::binary::write<int>(os, (int) this->algorithm_);
+
+    // Integration settings
+    tools::io::binary::write<double>(os, this->hmax_);
+    tools::io::binary::write<double>(os, this->t0_);
+    tools::io::binary::write<double>(os, this->t1_);
+    tools::io::binary::write<double>(os, this->h_);
+    tools::io::binary::write<int>(os, this->steps_);
+    tools::io::binary::write<bool>(os, this->interrupt_);
+
+    // Splitting thresholds
+    tools::io::binary::write<double>(os, this->nli_threshold_);
+    tools::io::binary::write_vector<double>(os, this->errToll_);
+
+    // Adaptive truncation order
+    tools::io::binary::write<int>(os, this->min_order_);
+
+    // Taylor tolerance
+    tools::io::binary::write<double>(os, this->tolerance_);
+}
+
+void integrator::read_checkpoint(std::istream& is)
+{
+    // Identification
+    auto type = (INTEGRATOR) tools::io::binary::read<int>(is);
+    auto algorithm = (ALGORITHM) tools::io::binary::read<int>(is);
+
+    // Safety check
+    if (type != this->type || algorithm != this->algorithm_)
+    {
+        throw std::runtime_error(tools::string::print2string(
+                "integrator::read_checkpoint: checkpoint was written by '%s'/'%s' but this run uses '%s'/'%s'.",
+                tools::enums::INTEGRATOR2str(type).c_str(), tools::enums::ALGORITHM2str(algorithm).c_str(),
+                tools::enums::INTEGRATOR2str(this->type).c_str(),
+                tools::enums::ALGORITHM2str(this->algorithm_).c_str()));
+    }
+
+    // Integration settings
+    this->hmax_ = tools::io::binary::read<double>(is);
+    this->t0_ = tools::io::binary::read<double>(is);
+    this->t1_ = tools::io::binary::read<double>(is);
+    this->h_ = tools::io::binary::read<double>(is);
+    this->steps_ = tools::io::binary::read<int>(is);
+    this->interrupt_ = tools::io::binary::read<bool>(is);
+
+    // Splitting thresholds
+    this->nli_threshold_ = tools::io::binary::read<double>(is);
+    this->errToll_ = tools::io::binary::read_vector<double>(is);
+
+    // Adaptive truncation order
+    this->min_order_ = tools::io::binary::read<int>(is);
+
+    // Taylor tolerance
+    this->tolerance_ = tools::io::binary::read<double>(is);
+
+    // Parameters are set now
+    this->params_set_ = true;
+}
 
 DACE::AlgebraicVector<DACE::DA> integrator::integrate(const DACE::AlgebraicVector<DACE::DA>& x, int patch_id)
 {
+    // Profile
+    PROFILE_SCOPE(PROFILE_SECTION::INTEGRATE);
+    tools::profiler::begin_patch(patch_id, this->t_);
+
+    // Trace
+    double trace_t0 = this->t_;
+    auto trace_start = tools::trace::enabled() ? tools::trace::clock::now() : tools::trace::clock::time_point{};
+
     // Auxiliary variables
     DACE::AlgebraicVector<DACE::DA> result;
 
     // Set patch ID variable
     this->patch_id_ = patch_id;
 
+    // Nonlinearity growth is measured within this integration only
+    this->n_checks_ = 0;
+
+    // Adaptive order: the patch is integrated at its own truncation order. Not 'pushTO': its stack is shared by
+    // every thread, the truncation order itself is thread-local
+    unsigned int previous_order = 0;
+    if (this->min_order_ > 0)
+    {
+        previous_order = DACE::DA::setTO(this->order_);
+    }
+
     // Switch case
     switch (this->type)
     {
@@ -296,7 +771,22 @@ DACE::AlgebraicVector<DACE::DA> integrator::integrate(const DACE::AlgebraicVecto
         }
         case INTEGRATOR::RK4:
         {
-            result = this->RK4(x);
+            // First and second order: dense state transition matrix (and tensor) instead of DA
+            int order = this->variational_order();
+            if (order == 1)
+            {
+                result = this->nvar_ == 7 ? this->RK4_variational<variational::linear_state<7>>(x) :
+                         this->RK4_variational<variational::linear_state<6>>(x);
+            }
+            else if (order == 2)
+            {
+                result = this->nvar_ == 7 ? this->RK4_variational<variational::quadratic_state<7>>(x) :
+                         this->RK4_variational<variational::quadratic_state<6>>(x);
+            }
+            else
+            {
+                result = this->RK4(x);
+            }
             break;
         }
         case INTEGRATOR::RK78:
@@ -309,6 +799,16 @@ DACE::AlgebraicVector<DACE::DA> integrator::integrate(const DACE::AlgebraicVecto
             result = this->static_transformation(x);
             break;
         }
+        case INTEGRATOR::ANALYTIC_KEPLER:
+        {
+            result = this->analytic_kepler(x);
+            break;
+        }
+        case INTEGRATOR::TAYLOR:
+        {
+            result = this->taylor(x);
+            break;
+        }
         default:
         {
             // TODO: Add any fallback here.
@@ -316,6 +816,30 @@ DACE::AlgebraicVector<DACE::DA> integrator::integrate(const DACE::AlgebraicVecto
         }
     }
 
+    // Back to the previous order
+    if (this->min_order_ > 0)
+    {
+        DACE::DA::setTO(previous_order);
+    }
+
+    // Profile patch
+    if (tools::profiler::enabled())
+    {
+        std::size_t monomials = 0;
+        for (const auto& r : result) { monomials += r.size(); }
+        tools::profiler::end_patch(this->t_, this->nli_current_, monomials, !this->end_);
+    }
+
+    // Trace patch span
+    if (tools::trace::enabled())
+    {
+        tools::trace::complete(tools::string::print2string("patch %d", patch_id), "integrate", trace_start,
+                               tools::trace::clock::now(),
+                               tools::string::print2string("\"id\": %d, \"t0\": %.16f, \"t1\": %.16f, "
+                                                           "\"nli\": %.16f, \"split\": %s", patch_id, trace_t0,
+                                                           this->t_, this->nli_current_, this->end_ ? "false" : "true"));
+    }
+
     // Return result
     return result;
 }
@@ -356,18 +880,23 @@ void integrator::set_problem_ptr(problems *problem)
 
 bool integrator::check_conditions(const DACE::AlgebraicVector<DACE::DA>& scv, bool debug)
 {
+    // Result of the check
+    bool result{false};
+
     // Check the proper conditions to be checked in case ADS or LOADS
     switch (this->algorithm_)
     {
         case ALGORITHM::ADS:
         {
             // Check ADS conditions
-            return this->check_ads_conditions(scv);
+            result = this->check_ads_conditions(scv);
+            break;
         }
         case ALGORITHM::LOADS:
         {
             // Check LOADS conditions
-            return this->check_loads_conditions(scv, debug);
+            result = this->check_loads_conditions(scv, debug);
+            break;
         }
         default:
         {
@@ -379,16 +908,45 @@ bool integrator::check_conditions(const DACE::AlgebraicVector<DACE::DA>& scv, bo
         }
     }
 
-    return false;
+    // Record the nonlinearity
+    this->record_check();
+
+    return result;
+}
+
+void integrator::record_check()
+{
+    // Every check is made one step after the current time, so only differences matter
+    this->previous_check_ = this->last_check_;
+    this->last_check_ = {this->nonlinearity_ratio_, this->t_};
+    this->n_checks_++;
+}
+
+double integrator::get_nonlinearity_growth() const
+{
+    // Time between the last two checks
+    double dt = this->last_check_.t - this->previous_check_.t;
+
+    // Safety check: unknown
+    if (this->n_checks_ < 2 || dt <= 0.0 || this->previous_check_.ratio <= 0.0 || this->last_check_.ratio <= 0.0)
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    return std::log(this->last_check_.ratio / this->previous_check_.ratio) / dt;
 }
 
 bool integrator::check_ads_conditions(const DACE::AlgebraicVector<DACE::DA>& scv)
 {
+    // Profile
+    PROFILE_SCOPE(PROFILE_SECTION::CHECK_ADS);
+
     // Result of the comparison
     bool result{false};
 
     // Auxiliary variables
     std::vector<double> truncation_errors(scv.size());
+    this->nonlinearity_ratio_ = 0.0;
 
     // Iterate through every polynomial of the SCV
     for (unsigned int i = 0; i < scv.size(); ++i)
@@ -396,8 +954,8 @@ bool integrator::check_ads_conditions(const DACE::AlgebraicVector<DACE::DA>& scv
         // Safety check
         if (scv[i].size() == 0) { continue; }
 
-        // Get error
-        auto errors = scv[i].estimNorm(0, 0, DACE::DA::getMaxOrder() + 1);
+        // Get error: truncation at the current order (the algebra one unless the adaptive order lowered it)
+        auto errors = scv[i].estimNorm(0, 0, DACE::DA::getTO() + 1);
 
        //std::cout << tools::vector::num2string(err) << std::endl;
 
@@ -416,6 +974,9 @@ bool integrator::check_ads_conditions(const DACE::AlgebraicVector<DACE::DA>& scv
             // std::fprintf(stderr, "TRACE: %s\n", errmsg.c_str());
         }
 
+        // Largest error relative to its tolerance
+        this->nonlinearity_ratio_ = std::max(this->nonlinearity_ratio_, trunc_err2check / this->errToll_[i]);
+
         // Compare error
         if (trunc_err2check > this->errToll_[i])
         {
@@ -464,8 +1025,29 @@ bool integrator::check_ads_conditions(const DACE::AlgebraicVector<DACE::DA>& scv
         // Function component of maximum error
         const unsigned int pos = std::distance(relativErr.begin(), max_error);
 
-        // Get the splitting direction
-        this->pos_ = (int) Patch::getSplittingDirection(pos, scv) - 1;
+        // Truncation error of that component along every variable, as 'Patch::getSplittingDirection' does
+        auto n_var = DACE::DA::getMaxVariables();
+        this->split_contributions_.assign(n_var, 0.0);
+        for (unsigned int i = 0; i < n_var; ++i)
+        {
+            auto error = scv[pos].estimNorm(i + 1, 0, DACE::DA::getMaxOrder() + 1).back();
+
+            // No estimate if the variable does not appear
+            this->split_contributions_[i] = std::isfinite(error) ? error : 0.0;
+        }
+
+        // Get the splitting direction: the largest one, the first of them if tied
+        int dir = 0;
+        double largest = 0.0;
+        for (unsigned int i = 0; i < n_var; ++i)
+        {
+            if (this->split_contributions_[i] > largest)
+            {
+                dir = (int) i + 1;
+                largest = this->split_contributions_[i];
+            }
+        }
+        this->pos_ = dir - 1;
     }
 
     // Return the errors
@@ -474,6 +1056,9 @@ bool integrator::check_ads_conditions(const DACE::AlgebraicVector<DACE::DA>& scv
 
 bool integrator::check_loads_conditions(const DACE::AlgebraicVector<DACE::DA>& scv, bool debug)
 {
+    // Profile
+    PROFILE_SCOPE(PROFILE_SECTION::CHECK_LOADS);
+
     // Auxiliary variables
     int n_rows = (int) scv.size();
     int n_cols = (int) DACE::DA::getMaxVariables();
@@ -520,21 +1105,14 @@ bool integrator::check_loads_conditions(const DACE::AlgebraicVector<DACE::DA>& s
 
     // Compute the NLI
     this->nli_current_ = std::sqrt( upper_bound_sum / constant_sum );
+    this->nonlinearity_ratio_ = this->nli_current_ / this->nli_threshold_;
 
     // Clear sum
     upper_bound_sum = 0.0;
 
     if (debug)
     {
-        std::ofstream outfile;
-        auto time_str = std::string (__TIME__);
-        outfile.open("out/example/loads/nli_" + time_str + ".csv", std::ios_base::app); // append instead of overwrite
-
-        // String to write
-        auto str2write = tools::string::print2string(" %.16f, %.16f, %d", this->t_, this->nli_current_, this->patch_id_);
-
-        // Write
-        outfile << str2write << std::endl;
+        this->write_nli_debug();
     }
 
     if (this->nli_current_ > this->nli_threshold_ || this->patch_id_ == 0 && (this->nli_current_ > 0.004) && false)
@@ -585,12 +1163,123 @@ bool integrator::check_loads_conditions(const DACE::AlgebraicVector<DACE::DA>& s
 
         // Get the maximum
        this-> pos_ = (int) std::distance(mu_list.begin(), std::max_element(mu_list.begin(), mu_list.end()));
+
+        // Keep every contribution
+        this->split_contributions_ = mu_list;
+    }
+
+    // Return the errors
+    return result;
+}
+
+
+bool integrator::check_loads_conditions(const std::vector<double>& jacobian, const std::vector<double>& hessian,
+                                        int n_rows, bool debug)
+{
+    // Profile
+    PROFILE_SCOPE(PROFILE_SECTION::CHECK_LOADS);
+
+    // Auxiliary variables
+    int n_cols = (int) DACE::DA::getMaxVariables();
+
+    // Result of the comparison
+    bool result{false};
+
+    // Upper bounds sum
+    double upper_bound_sum = 0;
+    double constant_sum = 0;
+
+    // Jacobian of the map in the DA variables: its constant part and, as the first-order part of every component is
+    // linear, the sum of the absolute values of its coefficients as upper bound (what 'DA::bound' gives)
+    for (int i = 0; i < n_rows; i++)
+    {
+        for (int j = 0; j < n_cols; j++)
+        {
+            // Check for non-zero values in order to avoid nans
+            if (this->betas_[j] == 0.0)
+            {
+                continue;
+            }
+
+            // Constant part
+            auto comp_ij_cons = jacobian[i * n_cols + j] / this->betas_[j];
+
+            // Bounds computation
+            double bound_ij_ub = 0.0;
+            for (int k = 0; k < n_cols; k++)
+            {
+                bound_ij_ub += std::abs(hessian[(i * n_cols + j) * n_cols + k] / this->betas_[j]);
+            }
+
+            // Sum
+            upper_bound_sum += bound_ij_ub * bound_ij_ub;
+            constant_sum += comp_ij_cons * comp_ij_cons;
+        }
+    }
+
+    // Compute the NLI
+    this->nli_current_ = std::sqrt( upper_bound_sum / constant_sum );
+    this->nonlinearity_ratio_ = this->nli_current_ / this->nli_threshold_;
+
+    if (debug)
+    {
+        this->write_nli_debug();
+    }
+
+    if (this->nli_current_ > this->nli_threshold_)
+    {
+        // It means we have exceeded the threshold!
+        result = true;
+
+        // Contribution of every direction: the Jacobian along that variable only
+        std::vector<double> mu_list(n_cols);
+        for (int k = 0; k < n_cols; k++)
+        {
+            upper_bound_sum = 0.0;
+            for (int i = 0; i < n_rows; i++)
+            {
+                for (int j = 0; j < n_cols; j++)
+                {
+                    if (this->betas_[j] == 0.0)
+                    {
+                        continue;
+                    }
+
+                    // Bounds computation
+                    auto bound_ij_ub = std::abs(hessian[(i * n_cols + j) * n_cols + k] / this->betas_[j]);
+
+                    // Sum
+                    upper_bound_sum += bound_ij_ub * bound_ij_ub;
+                }
+            }
+
+            // Save result
+            mu_list[k] = std::sqrt( upper_bound_sum / constant_sum );
+        }
+
+        // Get the maximum
+        this->pos_ = (int) std::distance(mu_list.begin(), std::max_element(mu_list.begin(), mu_list.end()));
+
+        // Keep every contribution
+        this->split_contributions_ = mu_list;
     }
 
     // Return the errors
     return result;
 }
 
+void integrator::write_nli_debug() const
+{
+    std::ofstream outfile;
+    auto time_str = std::string (__TIME__);
+    outfile.open("out/example/loads/nli_" + time_str + ".csv", std::ios_base::app); // append instead of overwrite
+
+    // String to write
+    auto str2write = tools::string::print2string(" %.16f, %.16f, %d", this->t_, this->nli_current_, this->patch_id_);
+
+    // Write
+    outfile << str2write << std::endl;
+}
 
 void integrator::set_errToll(const std::vector<double> &errToll)
 {
@@ -611,6 +1300,85 @@ void integrator::set_nli_threshold(const double &nli_threshold)
     this->nli_threshold_ = nli_threshold;
 }
 
+void integrator::set_adaptive_order(int min_order)
+{
+    // Safety check
+    if (min_order < 1 || min_order > (int) DACE::DA::getMaxOrder())
+    {
+        // Info
+        std::fprintf(stderr, "Cannot set the minimum truncation order to '%d', the algebra order is '%u'.\n",
+                     min_order, DACE::DA::getMaxOrder());
+
+        // Exit code
+        std::exit(53);
+    }
+
+    // Info
+    std::fprintf(stdout, "Setting the adaptive truncation order to...: '%d' to '%u'\n", min_order,
+                 DACE::DA::getMaxOrder());
+
+    // Setting it...
+    this->min_order_ = min_order;
+    this->order_ = (int) DACE::DA::getMaxOrder();
+}
+
+void integrator::set_order(int order)
+{
+    // Only if adaptive
+    if (this->min_order_ == 0)
+    {
+        return;
+    }
+
+    // New patches start at the algebra order
+    this->order_ = order > 0 ? std::clamp(order, this->min_order_, (int) DACE::DA::getMaxOrder()) :
+                   (int) DACE::DA::getMaxOrder();
+}
+
+void integrator::adapt_order(const DACE::AlgebraicVector<DACE::DA>& x)
+{
+    // Only if adaptive
+    if (this->min_order_ == 0)
+    {
+        return;
+    }
+
+    // Nonlinearity one order lower: the NLI barely depends on it, the truncation error is estimated as the check would
+    double lowered_ratio = this->nonlinearity_ratio_;
+    if (this->algorithm_ == ALGORITHM::ADS && this->order_ > this->min_order_ &&
+        this->nonlinearity_ratio_ < integrator::order_lower_ratio_)
+    {
+        lowered_ratio = 0.0;
+        for (unsigned int i = 0; i < x.size(); ++i)
+        {
+            // Safety check
+            if (x[i].size() == 0) { continue; }
+
+            // Terms dropped and truncation error without them, relative to the tolerance
+            auto dropped = x[i].estimNorm(0, 0, this->order_).back();
+            auto estimated = x[i].trim(0, this->order_ - 1).estimNorm(0, 0, this->order_).back();
+            lowered_ratio = std::max(lowered_ratio, std::max(dropped, estimated) / this->errToll_[i]);
+        }
+    }
+
+    // Well below the threshold: drop the highest order. Growing: take it back
+    if (lowered_ratio < integrator::order_lower_ratio_ && this->order_ > this->min_order_)
+    {
+        this->order_--;
+    }
+    else if (this->nonlinearity_ratio_ > integrator::order_raise_ratio_ && this->order_ < (int) DACE::DA::getMaxOrder())
+    {
+        this->order_++;
+    }
+    else
+    {
+        return;
+    }
+
+    // Apply it to the next steps
+    DACE::DA::setTO(this->order_);
+}
+
 // Some auxiliary functions for the RK78, TODO: Can we get rid of min/max?
 double min( double a, double b)
 {
@@ -647,7 +1415,7 @@ double normtmp( int N, std::vector<double> X)
 template<typename T> DACE::AlgebraicVector<T> integrator::RK78(int N, DACE::AlgebraicVector<T> Y0)
 {
     // Auxiliary variables
-    bool flag_interruption_errToll;
+    bool flag_interruption_errToll{false};
 
     // TODO: Investigate what is this
     double ERREST;
@@ -898,6 +1666,9 @@ template<typename T> DACE::AlgebraicVector<T> integrator::RK78(int N, DACE::Alge
 
             // Update next state
             x_prev = Y1check;
+
+            // Order of the next step
+            this->adapt_order(Y1check);
         }
 
         // Update times to the class
@@ -975,6 +1746,9 @@ void integrator::summary(std::string *summary2return, bool recursive)
     *summary2return += tools::string::print2string("Integrator (%p): hmax flag set to '%.2f'\n",
                                                    this, this->hmax_);
 
+    *summary2return += tools::string::print2string("Integrator (%p): tolerance flag set to '%.2e'\n",
+                                                   this, this->tolerance_);
+
     *summary2return += tools::string::print2string("Integrator (%p): nli_current flag set to '%.2f'\n",
                                                    this, this->nli_current_);
 
@@ -12,10 +12,15 @@
 // Project libraries
 #include "base/enums.h"
 #include "problems.h"
+#include "kepler.h"
+#include "variational.h"
 
 // Project tools
 #include "tools/vo.h"
 #include "tools/ep.h"
+#include "tools/profiler.h"
+#include "tools/tracer.h"
+#include "tools/io_binary.h"
 
 // DACE libraries
 #include "dace/dace.h"
@@ -38,7 +43,7 @@ public:
 public:
     double t_{};
     bool end_{false};
-    double nli_current_;
+    double nli_current_{};
     std::vector<int> vector;
 
 public:
@@ -57,10 +62,64 @@ public:
     void set_integration_parameters(const DACE::AlgebraicVector<DACE::DA> &scv0, double t0, double t1,
                                     bool interrupt = false);
 
+    /**
+     * Move the final time forward keeping the rest of integration parameters, so that an already propagated
+     * manifold can be propagated further.
+     * @param t1 [in] [double]
+     */
+    void extend_final_time(double t1);
+
+    /**
+     * Stop the integration at an intermediate time of the current interval, so that every patch stops there. The
+     * interval is then taken up again with 'extend_final_time'.
+     * @param t_start [in] [double] start of the interval being integrated
+     * @param t1 [in] [double] intermediate stop
+     */
+    void set_stop_time(double t_start, double t1);
+
+    /**
+     * Write the integration settings (times, step, interruption, thresholds) in a binary stream.
+     * @param os [in] [std::ostream]
+     */
+    void write_checkpoint(std::ostream& os) const;
+
+    /**
+     * Restore the integration settings written by 'write_checkpoint'. Integrator type and algorithm must match.
+     * @param is [in] [std::istream]
+     */
+    void read_checkpoint(std::istream& is);
+
     void set_errToll(const std::vector<double>& errToll);
 
     void set_nli_threshold(const double &nli_threshold);
 
+    /**
+     * Enable the adaptive truncation order: every patch is integrated at its own order, lowered while its nonlinearity
+     * (NLI for LOADS, truncation error for ADS) stays well below the splitting threshold and raised again, up to the
+     * algebra order, when it grows. Needs the interruption feature, since that is where the nonlinearity is measured.
+     * @param min_order [in] [int] lowest order a patch may use
+     */
+    void set_adaptive_order(int min_order);
+
+    /**
+     * Truncation order of the next patch to be integrated, ignored if the adaptive order is disabled.
+     * @param order [in] [int] 0 for the algebra order
+     */
+    void set_order(int order);
+
+    /**
+     * Relative tolerance of the Taylor integrator: it sets the order of the series and, with the decay of its
+     * coefficients, the length of every step.
+     * @param tolerance [in] [double]
+     */
+    void set_tolerance(double tolerance) { this->tolerance_ = tolerance; }
+
+    /**
+     * Enable or disable the interruption of the integration (splitting), e.g. to finish patches unsplit.
+     * @param interrupt [in] [bool]
+     */
+    void set_interruption(bool interrupt) { this->interrupt_ = interrupt; }
+
     void set_beta(std::vector<double> &beta)
     {
         this->betas_ = beta;
@@ -85,6 +144,64 @@ public:
 
     auto get_algorithm() {return this->algorithm_;}
 
+    [[nodiscard]] double get_final_time() const
+    {
+        return this->t1_;
+    }
+
+    [[nodiscard]] double get_initial_time() const
+    {
+        return this->t0_;
+    }
+
+    [[nodiscard]] bool get_interruption() const
+    {
+        return this->interrupt_;
+    }
+
+    /**
+     * Truncation order the last patch finished with, 0 if the adaptive order is disabled.
+     * @return int
+     */
+    [[nodiscard]] int get_order() const
+    {
+        return this->order_;
+    }
+
+    /**
+     * Time step of the last integration.
+     * @return double
+     */
+    [[nodiscard]] double get_time_step() const
+    {
+        return this->h_;
+    }
+
+    /**
+     * Last nonlinearity measured by the conditions check, relative to the splitting threshold.
+     * @return double
+     */
+    [[nodiscard]] double get_nonlinearity_ratio() const
+    {
+        return this->last_check_.ratio;
+    }
+
+    /**
+     * Exponential growth rate of the nonlinearity at the end of the last integration, between its last two checks.
+     * @return double [1/time], NaN if unknown (a single check or no time in between)
+     */
+    [[nodiscard]] double get_nonlinearity_growth() const;
+
+    /**
+     * Contribution of every variable to the nonlinearity of the last failed check: NLI along each direction for LOADS,
+     * truncation error of the failing component along each variable for ADS.
+     * @return std::vector<double>&
+     */
+    [[nodiscard]] const std::vector<double>& get_split_contributions() const
+    {
+        return this->split_contributions_;
+    }
+
 public: // SAFETY CHECK FUNCTIONS
     void summary(std::string * summary2return, bool recursive);
 
@@ -103,6 +220,9 @@ private:
     // Step max
     double hmax_ = 0.1;
 
+    // Relative tolerance of the Taylor integrator
+    double tolerance_ = 1e-14;
+
 public:
     // Betas vector
     std::vector<double> betas_{};
@@ -143,6 +263,35 @@ private:
     // LOADS stuff
     double nli_threshold_;
 
+    // Adaptive truncation order: lowest order (0 if disabled), order of the current patch and last nonlinearity
+    // measured, relative to the splitting threshold
+    int min_order_{0};
+    int order_{0};
+    double nonlinearity_ratio_{};
+
+    // Nonlinearity relative to the threshold at the last two checks of the current integration, and contribution of
+    // every variable to the last failed one
+    struct nonlinearity_check
+    {
+        double ratio{};
+        double t{};
+    };
+    nonlinearity_check previous_check_{};
+    nonlinearity_check last_check_{};
+    int n_checks_{0};
+    std::vector<double> split_contributions_{};
+
+    // Initial polynomials of the patch integrated by 'RK4_variational' (linear part and Hessian in the DA variables)
+    // and derivatives of its map
+    std::vector<double> initial_linear_{};
+    std::vector<double> initial_hessian_{};
+    std::vector<double> map_jacobian_{};
+    std::vector<double> map_hessian_{};
+
+    // Ratios below which the order is lowered and above which it is raised back
+    static constexpr double order_lower_ratio_ = 0.25;
+    static constexpr double order_raise_ratio_ = 0.5;
+
 private:
     // Some auxilary class variables
     int patch_id_ = -1;
@@ -170,13 +319,89 @@ private:
     template<typename T>
     DACE::AlgebraicVector<T> RK78(int N, DACE::AlgebraicVector<T> Y0);
 
+    /**
+     * This function will propagate analytically the two-body problem (Kepler), checking the ADS/LOADS conditions
+     * at every sub-epoch, which are spaced by the configured time step.
+     * @param x             [in] [DACE::AlgebraicVector]
+     * @return DACE::AlgebraicVector<DACE::DA>
+     */
+    DACE::AlgebraicVector<DACE::DA> analytic_kepler(DACE::AlgebraicVector<DACE::DA> x);
+
+    /**
+     * This function will integrate summing the Taylor series in time of the solution, see 'taylor_step', checking the
+     * ADS/LOADS conditions after every step. The configured time step is not used, steps are as long as the tolerance
+     * allows.
+     * @param x             [in] [DACE::AlgebraicVector]
+     * @return DACE::AlgebraicVector<DACE::DA>
+     */
+    DACE::AlgebraicVector<DACE::DA> taylor(DACE::AlgebraicVector<DACE::DA> x);
+
+    /**
+     * RK4 of a first- or second-order algebra: the map is propagated as a nominal state plus its STM (and STT) in
+     * doubles, see 'variational', and rebuilt as DA at the end. Same steps, checks and stops as 'RK4'.
+     * @tparam S variational::linear_state<N> or variational::quadratic_state<N>
+     * @param x             [in] [DACE::AlgebraicVector]
+     * @return DACE::AlgebraicVector<DACE::DA>
+     */
+    template<typename S>
+    DACE::AlgebraicVector<DACE::DA> RK4_variational(const DACE::AlgebraicVector<DACE::DA>& x);
+
+    /**
+     * ADS/LOADS conditions of a state propagated by 'RK4_variational'. An affine map never splits under LOADS, a
+     * second-order one has its NLI computed from its derivatives. ADS checks the rebuilt DA.
+     * @param y [in] [variational::linear_state<N> or variational::quadratic_state<N>]
+     * @return bool
+     */
+    template<std::size_t N>
+    bool check_variational_conditions(const variational::linear_state<N>& y);
+
+    template<std::size_t N>
+    bool check_variational_conditions(const variational::quadratic_state<N>& y);
+
+    /**
+     * Order of the dense path the RK4 can take: first or second order algebra (the latter without adaptive order)
+     * and a problem with dense dynamics.
+     * @return int 0 if none
+     */
+    [[nodiscard]] int variational_order() const;
+
     void print_detailed_information(const DACE::AlgebraicVector<DACE::DA> &x, int i, double t);
 
+    void print_detailed_information(const std::vector<double> &x_cons, int i, double t);
+
+    /**
+     * Keep the nonlinearity just measured by a conditions check, for its growth rate.
+     */
+    void record_check();
+
+    /**
+     * Append the current NLI to the debug file of the LOADS checks.
+     */
+    void write_nli_debug() const;
+
+public: // Kernels: single steps and splitting checks, public so that they can be benchmarked in isolation
+
+    /**
+     * Single RK4 step.
+     * @param x             [in] [DACE::AlgebraicVector]
+     * @param t             [in] [double]
+     * @param h             [in] [double]
+     * @return DACE::AlgebraicVector<DACE::DA>
+     */
     DACE::AlgebraicVector<DACE::DA> RK4_step(const DACE::AlgebraicVector<DACE::DA>& x, double t, double h);
 
     [[nodiscard]] DACE::AlgebraicVector<DACE::DA> Euler_step(const DACE::AlgebraicVector<DACE::DA> &x, double t, double h) const;
 
-private:
+    /**
+     * Single Taylor step. The order comes from the tolerance, p = ceil(1 - ln(tol) / 2), and the step from the decay
+     * of the last two coefficients (Jorba & Zou): h = min((tol * max(1, |x_0|) / |x_j|)^(1/j)), j = p - 1 and p, with
+     * |.| the largest DA coefficient of any component. Coefficients dropped by the DA truncation are skipped. The
+     * dynamics are autonomous, so the step does not depend on the time.
+     * @param x             [in] [DACE::AlgebraicVector]
+     * @param h             [in/out] [double] longest step allowed, step taken
+     * @return DACE::AlgebraicVector<DACE::DA>
+     */
+    DACE::AlgebraicVector<DACE::DA> taylor_step(const DACE::AlgebraicVector<DACE::DA>& x, double& h) const;
 
     /**
     * Check conditons: ADS or LOADS, switch case.
@@ -201,6 +426,27 @@ private:
      */
     bool check_loads_conditions(const DACE::AlgebraicVector<DACE::DA> &x, bool debug = false);
 
+    /**
+     * Check LOADS conditions from the derivatives of the map with respect to the DA variables, as the DA version
+     * computes them for a second-order map, see 'variational::compose'.
+     * @param jacobian [in] [std::vector<double>] [n_rows x nvar]
+     * @param hessian [in] [std::vector<double>] [n_rows x nvar x nvar]
+     * @param n_rows [in] [int]
+     * @param debug
+     * @return
+     */
+    bool check_loads_conditions(const std::vector<double>& jacobian, const std::vector<double>& hessian, int n_rows,
+                                bool debug = false);
+
+    /**
+     * Adaptive truncation order: lower or raise the order of the current patch by one from the last nonlinearity
+     * measured by the conditions check.
+     * @param x [in] [DACE::AlgebraicVector] state after the step
+     */
+    void adapt_order(const DACE::AlgebraicVector<DACE::DA>& x);
+
+private:
+
     /**
      * Static transformation
      * @param x
@@ -3,19 +3,14 @@
  */
 
 #include "json/json_parser.h"
+#include "ads/SplittingHistory.h"
 
-json_input json_parser::parse_input_file(const std::string& filepath)
+std::string json_parser::read_file(const std::string& filepath)
 {
     // Auxiliary variables
     std::string json_text{};
     std::string json_line{};
 
-    // Create an empty struct to be returned
-    json_input my_specs{};
-
-    // Set name of the file
-    my_specs.filepath = filepath;
-
     if (filepath.empty())
     {
         std::fprintf(stderr, "FATAL: File parameter has not been passed... Cannot load any configuration "
@@ -47,6 +42,67 @@ json_input json_parser::parse_input_file(const std::string& filepath)
     }
     // TODO: Add fallbacks
 
+    return json_text;
+}
+
+std::vector<std::string> json_parser::split_array(const std::string& json_text)
+{
+    // Elements to be returned
+    std::vector<std::string> elements{};
+
+    // Auxiliary variables
+    int depth = 0;
+    bool in_string = false;
+    std::size_t start = 0;
+
+    for (std::size_t i = 0; i < json_text.size(); i++)
+    {
+        char c = json_text[i];
+
+        // Skip string contents (and escaped quotes inside them)
+        if (in_string)
+        {
+            if (c == '\\') { i++; }
+            else if (c == '"') { in_string = false; }
+            continue;
+        }
+
+        if (c == '"') { in_string = true; }
+        else if (c == '[' || c == '{')
+        {
+            // Outer bracket opens the first element
+            if (depth++ == 0) { start = i + 1; }
+        }
+        else if ((c == ']' || c == '}') && --depth == 0 && i > start)
+        {
+            // Outer bracket closes the last element
+            elements.push_back(json_text.substr(start, i - start));
+        }
+        else if (c == ',' && depth == 1)
+        {
+            // Next element
+            elements.push_back(json_text.substr(start, i - start));
+            start = i + 1;
+        }
+    }
+
+    return elements;
+}
+
+json_input json_parser::parse_input_file(const std::string& filepath)
+{
+    // Read and parse
+    return json_parser::parse_input_text(json_parser::read_file(filepath), filepath);
+}
+
+json_input json_parser::parse_input_text(const std::string& json_text, const std::string& filepath)
+{
+    // Create an empty struct to be returned
+    json_input my_specs{};
+
+    // Set name of the file
+    my_specs.filepath = filepath;
+
     // Build parsed object
     auto my_resource_obj = RSJresource(json_text);
 
@@ -67,6 +123,14 @@ json_input json_parser::parse_input_file(const std::string& filepath)
     my_specs.algebra.variables = algebra_rsj_obj["variables"].as<int>();
     my_specs.algebra.set = true;
 
+    // Optional adaptive truncation order, down to the lowest order the algorithm can use unless told otherwise
+    if (algebra_rsj_obj["adaptive_order"].exists())
+    {
+        my_specs.algebra.adaptive_order = algebra_rsj_obj["adaptive_order"].as<bool>();
+        my_specs.algebra.min_order = algebra_rsj_obj["min_order"].exists() ? algebra_rsj_obj["min_order"].as<int>() :
+                                     my_specs.algorithm == ALGORITHM::LOADS ? 2 : 1;
+    }
+
     // Read propagation ---------------
     auto prop_rsj_obj = json_parser::get_subsection(input_rsj_obj, json_parser::subsections::PROPAGATION);
 
@@ -108,6 +172,46 @@ json_input json_parser::parse_input_file(const std::string& filepath)
         std::fprintf(stdout, "No algorithm (ADS / LOADS) has been chosen!");
     }
 
+    // Read sweep (optional) ---------------
+    if (input_rsj_obj[json_parser::subsections::SWEEP].exists())
+    {
+        // Get SWEEP
+        auto sweep_rsj_obj = json_parser::get_subsection(input_rsj_obj, json_parser::subsections::SWEEP);
+
+        // Parse SWEEP
+        json_parser::parse_sweep_section(sweep_rsj_obj, &my_specs);
+    }
+
+    // Read coarsening (optional) ---------------
+    if (input_rsj_obj[json_parser::subsections::COARSENING].exists())
+    {
+        // Get COARSENING
+        auto coarsening_rsj_obj = json_parser::get_subsection(input_rsj_obj, json_parser::subsections::COARSENING);
+
+        // Parse COARSENING
+        json_parser::parse_coarsening_section(coarsening_rsj_obj, &my_specs);
+    }
+
+    // Read budget (optional) ---------------
+    if (input_rsj_obj[json_parser::subsections::BUDGET].exists())
+    {
+        // Get BUDGET
+        auto budget_rsj_obj = json_parser::get_subsection(input_rsj_obj, json_parser::subsections::BUDGET);
+
+        // Parse BUDGET
+        json_parser::parse_budget_section(budget_rsj_obj, &my_specs);
+    }
+
+    // Read splitting (optional) ---------------
+    if (input_rsj_obj[json_parser::subsections::SPLITTING].exists())
+    {
+        // Get SPLITTING
+        auto splitting_rsj_obj = json_parser::get_subsection(input_rsj_obj, json_parser::subsections::SPLITTING);
+
+        // Parse SPLITTING
+        json_parser::parse_splitting_section(splitting_rsj_obj, &my_specs);
+    }
+
     // Set beta, relying on which algorithm was used
     json_parser::set_betas(&my_specs);
 
@@ -120,6 +224,16 @@ json_input json_parser::parse_input_file(const std::string& filepath)
     // Read the output directory where the results will be dumped
     my_specs.output_dir = tools::string::clean_bars(output_rsj_obj["directory"].as_str());
 
+    // Read mixture (optional) ---------------
+    if (output_rsj_obj[json_parser::subsections::MIXTURE].exists())
+    {
+        // Get MIXTURE
+        auto mixture_rsj_obj = json_parser::get_subsection(output_rsj_obj, json_parser::subsections::MIXTURE);
+
+        // Parse MIXTURE
+        json_parser::parse_mixture_section(mixture_rsj_obj, &my_specs);
+    }
+
     // Check health of the inputs
     json_parser::safety_checks(&my_specs);
 
@@ -185,7 +299,22 @@ void json_parser::parse_propagation_section(RSJresource& rsj_obj, json_input * j
             integrator_str == "rk4"     ? INTEGRATOR::RK4       :
             integrator_str == "euler"   ? INTEGRATOR::EULER     :
             integrator_str == "rk78"    ? INTEGRATOR::RK78      :
-            integrator_str == "static"  ? INTEGRATOR::STATIC    : INTEGRATOR::NA;
+            integrator_str == "static"  ? INTEGRATOR::STATIC    :
+            integrator_str == "analytic_kepler" || integrator_str == "kepler" ? INTEGRATOR::ANALYTIC_KEPLER :
+            integrator_str == "taylor"  ? INTEGRATOR::TAYLOR    :
+            INTEGRATOR::NA;
+
+    // Optional tolerance of the Taylor integrator
+    if (rsj_obj["tolerance"].exists())
+    {
+        json_input_obj->propagation.tolerance = rsj_obj["tolerance"].as<double>();
+    }
+
+    // Optional intermediate epochs: the propagation stops there and keeps the manifold of each segment
+    if (rsj_obj["epochs"].exists())
+    {
+        json_input_obj->propagation.epochs = rsj_obj["epochs"].as_vector<double>();
+    }
 
     json_input_obj->propagation.set = true;
 
@@ -307,6 +436,117 @@ void json_parser::parse_scaling_section(RSJresource& rsj_obj, json_input * json_
     json_input_obj->scaling.set = true;
 }
 
+void json_parser::parse_sweep_section(RSJresource& rsj_obj, json_input * json_input_obj)
+{
+    // Every list is optional
+    if (rsj_obj["final_time"].exists())
+    {
+        json_input_obj->sweep.final_time = rsj_obj["final_time"].as_vector<double>();
+    }
+    if (rsj_obj["nli_threshold"].exists())
+    {
+        json_input_obj->sweep.nli_threshold = rsj_obj["nli_threshold"].as_vector<double>();
+    }
+    if (rsj_obj["max_split"].exists())
+    {
+        json_input_obj->sweep.max_split = rsj_obj["max_split"].as_vector<int>();
+    }
+
+    // Sweep has been set
+    json_input_obj->sweep.set = true;
+}
+
+void json_parser::parse_coarsening_section(RSJresource& rsj_obj, json_input * json_input_obj)
+{
+    // Tolerance is mandatory, interval is optional
+    json_input_obj->coarsening.tolerance = rsj_obj["tolerance"].as<double>();
+    if (rsj_obj["interval"].exists())
+    {
+        json_input_obj->coarsening.interval = rsj_obj["interval"].as<double>();
+    }
+
+    // Coarsening has been set
+    json_input_obj->coarsening.set = true;
+}
+
+void json_parser::parse_budget_section(RSJresource& rsj_obj, json_input * json_input_obj)
+{
+    // Every cap is optional
+    if (rsj_obj["max_patches"].exists())
+    {
+        json_input_obj->budget.max_patches = rsj_obj["max_patches"].as<int>();
+    }
+    if (rsj_obj["max_memory"].exists())
+    {
+        json_input_obj->budget.max_memory = rsj_obj["max_memory"].as<double>();
+    }
+    if (rsj_obj["max_time"].exists())
+    {
+        json_input_obj->budget.max_time = rsj_obj["max_time"].as<double>();
+    }
+
+    // Priority of the pending patches, probability mass by default
+    if (rsj_obj["priority"].exists())
+    {
+        auto priority_str = tools::string::clean_bars(rsj_obj["priority"].as_str());
+        std::transform(priority_str.begin(), priority_str.end(), priority_str.begin(), ::tolower);
+        json_input_obj->budget.priority =
+                priority_str == "mass"  ? BUDGET_PRIORITY::MASS :
+                priority_str == "nli"   ? BUDGET_PRIORITY::NLI  :
+                priority_str == "fifo"  ? BUDGET_PRIORITY::FIFO : BUDGET_PRIORITY::NA;
+    }
+
+    // Budget has been set
+    json_input_obj->budget.set = true;
+}
+
+void json_parser::parse_splitting_section(RSJresource& rsj_obj, json_input * json_input_obj)
+{
+    // Mode, predictive by default
+    if (rsj_obj["mode"].exists())
+    {
+        auto mode_str = tools::string::clean_bars(rsj_obj["mode"].as_str());
+        std::transform(mode_str.begin(), mode_str.end(), mode_str.begin(), ::tolower);
+        json_input_obj->splitting.mode =
+                mode_str == "predictive"    ? SPLIT_MODE::PREDICTIVE :
+                mode_str == "single"        ? SPLIT_MODE::SINGLE     : SPLIT_MODE::NA;
+    }
+
+    // Limits of the predictive splitting
+    if (rsj_obj["max_pieces"].exists())
+    {
+        json_input_obj->splitting.max_pieces = rsj_obj["max_pieces"].as<int>();
+    }
+    if (rsj_obj["min_steps"].exists())
+    {
+        json_input_obj->splitting.min_steps = rsj_obj["min_steps"].as<int>();
+    }
+
+    // Splitting has been set
+    json_input_obj->splitting.set = true;
+}
+
+void json_parser::parse_mixture_section(RSJresource& rsj_obj, json_input * json_input_obj)
+{
+    // Components after merging, one per patch by default
+    if (rsj_obj["components"].exists())
+    {
+        json_input_obj->mixture.components = rsj_obj["components"].as<int>();
+    }
+
+    // Output files, binary by default
+    if (rsj_obj["format"].exists())
+    {
+        auto format_str = tools::string::clean_bars(rsj_obj["format"].as_str());
+        std::transform(format_str.begin(), format_str.end(), format_str.begin(), ::tolower);
+        json_input_obj->mixture.binary = format_str == "binary" || format_str == "both";
+        json_input_obj->mixture.json = format_str == "json" || format_str == "both";
+    }
+
+    // Mixture has been set
+    json_input_obj->mixture.set = true;
+}
+
 // Navigation functions here
 RSJresource json_parser::get_subsection(RSJresource& rsj_obj, const std::string & subsection_name)
 {
@@ -351,8 +591,20 @@ void json_parser::safety_checks(json_input * json_input_obj)
             std::exit(10);
         }
 
-        // Check order loads
-        if (json_input_obj->algebra.order > 2 || json_input_obj->algebra.order == 0)
+        // Check order loads: higher orders are only worth it with the adaptive order, the NLI needs at least 2
+        if (json_input_obj->algebra.adaptive_order && json_input_obj->algebra.min_order < 2)
+        {
+            // Info
+            std::fprintf(stdout, "LOADS has been configured. Minimum DA order parsed is '%d'. Nonetheless, "
+                                 "it will be overriden to 2, since the NLI needs it.\n",
+                                 json_input_obj->algebra.min_order);
+
+            // Set it
+            json_input_obj->algebra.min_order = 2;
+        }
+
+        if ((json_input_obj->algebra.order > 2 && !json_input_obj->algebra.adaptive_order) ||
+            json_input_obj->algebra.order == 0)
         {
             // Info
             std::fprintf(stdout, "LOADS has been configured. DA order parsed is '%d'. Nonetheless, "
@@ -364,6 +616,201 @@ void json_parser::safety_checks(json_input * json_input_obj)
         }
     }
 
+    // The analytic Kepler propagator is only valid for the two-body problem
+    if (json_input_obj->propagation.integrator == INTEGRATOR::ANALYTIC_KEPLER &&
+        json_input_obj->problem != PROBLEM::TWO_BODY)
+    {
+        // Info and exit program
+        std::fprintf(stderr, "The 'analytic_kepler' integrator can only be used with the 'two_body_problem'. "
+                             "JSON file: '%s'\n", json_input_obj->filepath.c_str());
+
+        // Exit program
+        std::exit(10);
+    }
+
+    // The Taylor integrator needs the recurrences of the problem, and a tolerance it can reach
+    if (json_input_obj->propagation.integrator == INTEGRATOR::TAYLOR &&
+        ((json_input_obj->problem != PROBLEM::TWO_BODY && json_input_obj->problem != PROBLEM::FREE_TORQUE_MOTION) ||
+         !(json_input_obj->propagation.tolerance > 0.0 && json_input_obj->propagation.tolerance < 1.0)))
+    {
+        // Info and exit program
+        std::fprintf(stderr, "The 'taylor' integrator can only be used with the 'two_body_problem' or the "
+                             "'free_torque_motion' problem, with a 'tolerance' between 0 and 1, got '%.3e'. "
+                             "JSON file: '%s'\n", json_input_obj->propagation.tolerance,
+                     json_input_obj->filepath.c_str());
+
+        // Exit program
+        std::exit(10);
+    }
+
+    // Adaptive order: the minimum cannot be above the algebra order
+    if (json_input_obj->algebra.adaptive_order &&
+        (json_input_obj->algebra.min_order < 1 || json_input_obj->algebra.min_order > json_input_obj->algebra.order))
+    {
+        // Info and exit program
+        std::fprintf(stderr, "Algebra 'min_order' must be between 1 and 'order' ('%d'), got '%d'. JSON file: '%s'\n",
+                     json_input_obj->algebra.order, json_input_obj->algebra.min_order,
+                     json_input_obj->filepath.c_str());
+
+        // Exit program
+        std::exit(10);
+    }
+
+    // Intermediate epochs must be sorted and strictly within the propagation interval
+    const auto& epochs = json_input_obj->propagation.epochs;
+    for (std::size_t i = 0; i < epochs.size(); i++)
+    {
+        bool epoch_error = epochs[i] <= json_input_obj->propagation.initial_time ||
+                epochs[i] >= json_input_obj->propagation.final_time || (i > 0 && epochs[i] <= epochs[i - 1]);
+
+        if (epoch_error)
+        {
+            // Info and exit program
+            std::fprintf(stderr, "Propagation 'epochs' must be increasing and between 'initial_time' and "
+                                 "'final_time'. Wrong epoch: '%.6f'. JSON file: '%s'\n",
+                                 epochs[i], json_input_obj->filepath.c_str());
+
+            // Exit program
+            std::exit(10);
+        }
+    }
+
+    // Sweep checks
+    if (json_input_obj->sweep.set)
+    {
+        const auto& sweep = json_input_obj->sweep;
+
+        // Thresholds only exist in LOADS
+        bool threshold_error = !sweep.nli_threshold.empty() && json_input_obj->algorithm != ALGORITHM::LOADS;
+
+        // Final times must be after the initial time, and cannot be mixed with epochs (they are the epochs)
+        bool time_error = !sweep.final_time.empty() && !json_input_obj->propagation.epochs.empty();
+        for (const auto& t : sweep.final_time)
+        {
+            time_error |= t <= json_input_obj->propagation.initial_time;
+        }
+
+        // Split settings must be positive
+        bool split_error = false;
+        for (const auto& val : sweep.nli_threshold) { split_error |= val <= 0.0; }
+        for (const auto& val : sweep.max_split) { split_error |= val <= 0; }
+
+        if (threshold_error || time_error || split_error)
+        {
+            // Info and exit program
+            std::fprintf(stderr, "There was a problem when parsing the sweep section. 'nli_threshold' is only valid "
+                                 "for LOADS, 'final_time' values must be after 'initial_time' and cannot be combined "
+                                 "with 'epochs', thresholds and splits must be positive. JSON file: '%s'\n",
+                                 json_input_obj->filepath.c_str());
+
+            // Exit program
+            std::exit(10);
+        }
+    }
+
+    // Splits per patch, of the scenario and of every sweep case: they must fit in its history
+    const auto& max_split = json_input_obj->algorithm == ALGORITHM::ADS ? json_input_obj->ads.max_split :
+                            json_input_obj->loads.max_split;
+    std::vector<int> requested_splits = json_input_obj->sweep.max_split;
+    if (!max_split.empty())
+    {
+        requested_splits.push_back(max_split[0]);
+    }
+    for (const auto& requested : requested_splits)
+    {
+        if ((json_input_obj->algorithm == ALGORITHM::ADS || json_input_obj->algorithm == ALGORITHM::LOADS) &&
+            requested > (int) SplittingHistory::capacity)
+        {
+            // Info and exit program
+            std::fprintf(stderr, "There was a problem when parsing 'max_split': '%d' splits per patch requested, no "
+                                 "more than '%u' fit in its splitting history. JSON file: '%s'\n", requested,
+                                 SplittingHistory::capacity, json_input_obj->filepath.c_str());
+
+            // Exit program
+            std::exit(10);
+        }
+    }
+
+    // Coarsening checks: only splitting algorithms have siblings
+    if (json_input_obj->coarsening.set)
+    {
+        bool coarsening_error = json_input_obj->coarsening.tolerance <= 0.0 ||
+                json_input_obj->coarsening.interval < 0.0 ||
+                (json_input_obj->algorithm != ALGORITHM::ADS && json_input_obj->algorithm != ALGORITHM::LOADS);
+
+        if (coarsening_error)
+        {
+            // Info and exit program
+            std::fprintf(stderr, "There was a problem when parsing the coarsening section. 'tolerance' must be "
+                                 "positive, 'interval' cannot be negative and it is only valid for ADS and LOADS. "
+                                 "JSON file: '%s'\n", json_input_obj->filepath.c_str());
+
+            // Exit program
+            std::exit(10);
+        }
+    }
+
+    // Budget checks: only splitting algorithms split, caps cannot be negative
+    if (json_input_obj->budget.set)
+    {
+        const auto& budget = json_input_obj->budget;
+        bool budget_error = budget.max_patches < 0 || budget.max_memory < 0.0 || budget.max_time < 0.0 ||
+                budget.priority == BUDGET_PRIORITY::NA ||
+                (json_input_obj->algorithm != ALGORITHM::ADS && json_input_obj->algorithm != ALGORITHM::LOADS);
+
+        if (budget_error)
+        {
+            // Info and exit program
+            std::fprintf(stderr, "There was a problem when parsing the budget section. 'max_patches', 'max_memory' "
+                                 "and 'max_time' cannot be negative, 'priority' must be 'mass', 'nli' or 'fifo' and "
+                                 "it is only valid for ADS and LOADS. JSON file: '%s'\n",
+                                 json_input_obj->filepath.c_str());
+
+            // Exit program
+            std::exit(10);
+        }
+    }
+
+    // Splitting checks: only splitting algorithms split, a cut makes two (ADS) or three (LOADS) pieces
+    if (json_input_obj->splitting.set)
+    {
+        const auto& splitting = json_input_obj->splitting;
+        bool splitting_error = splitting.mode == SPLIT_MODE::NA || splitting.max_pieces < 2 ||
+                splitting.min_steps < 1 ||
+                (json_input_obj->algorithm != ALGORITHM::ADS && json_input_obj->algorithm != ALGORITHM::LOADS);
+
+        if (splitting_error)
+        {
+            // Info and exit program
+            std::fprintf(stderr, "There was a problem when parsing the splitting section. 'mode' must be "
+                                 "'predictive' or 'single', 'max_pieces' at least 2, 'min_steps' at least 1 and it "
+                                 "is only valid for ADS and LOADS. JSON file: '%s'\n",
+                                 json_input_obj->filepath.c_str());
+
+            // Exit program
+            std::exit(10);
+        }
+    }
+
+    // Mixture checks: components cannot be negative, at least one file, and the initial box must be finite
+    if (json_input_obj->mixture.set)
+    {
+        const auto& mixture = json_input_obj->mixture;
+        bool mixture_error = mixture.components < 0 || (!mixture.binary && !mixture.json) ||
+                json_input_obj->initial_conditions.confidence_interval <= 0.0;
+
+        if (mixture_error)
+        {
+            // Info and exit program
+            std::fprintf(stderr, "There was a problem when parsing the mixture section. 'components' cannot be "
+                                 "negative, 'format' must be 'binary', 'json' or 'both' and the confidence interval "
+                                 "must be positive. JSON file: '%s'\n", json_input_obj->filepath.c_str());
+
+            // Exit program
+            std::exit(10);
+        }
+    }
+
     // TODO: Do ADS safety checks
 }
 
@@ -26,6 +26,11 @@ namespace json_parser
         const std::string ADS = "ads";
         const std::string LOADS = "loads";
         const std::string SCALING = "scaling";
+        const std::string SWEEP = "sweep";
+        const std::string COARSENING = "coarsening";
+        const std::string BUDGET = "budget";
+        const std::string SPLITTING = "splitting";
+        const std::string MIXTURE = "mixture";
     }
 
     /**
@@ -34,6 +39,27 @@ namespace json_parser
      */
     json_input parse_input_file(const std::string& filepath);
 
+    /**
+     * Parses an input already read in memory
+     * @param json_text [in] [std::string]
+     * @param filepath [in] [std::string] origin of the text, used in messages
+     */
+    json_input parse_input_text(const std::string& json_text, const std::string& filepath);
+
+    /**
+     * Read a JSON file without whitespaces
+     * @param filepath [in] [std::string]
+     * @return std::string
+     */
+    std::string read_file(const std::string& filepath);
+
+    /**
+     * Split the text of a JSON array into the text of its elements
+     * @param json_text [in] [std::string]
+     * @return std::vector<std::string>
+     */
+    std::vector<std::string> split_array(const std::string& json_text);
+
     /**
      * Parse input section
      * @param rsj_obj
@@ -56,6 +82,16 @@ namespace json_parser
 
     void parse_scaling_section(RSJresource &rsj_obj, json_input *json_input_obj);
 
+    void parse_sweep_section(RSJresource &rsj_obj, json_input *json_input_obj);
+
+    void parse_coarsening_section(RSJresource &rsj_obj, json_input *json_input_obj);
+
+    void parse_budget_section(RSJresource &rsj_obj, json_input *json_input_obj);
+
+    void parse_splitting_section(RSJresource &rsj_obj, json_input *json_input_obj);
+
+    void parse_mixture_section(RSJresource &rsj_obj, json_input *json_input_obj);
+
     void set_betas(json_input *json_input_obj);
 
     void set_betas_loads(json_input *json_input_obj);
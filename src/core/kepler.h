@@ -0,0 +1,37 @@
+/**
+ * Analytic Keplerian propagation by means of the Lagrange coefficients (F, G, Ft, Gt).
+ * @details:
+ *  - Templated so that it works with both doubles and DACE::DA polynomials.
+ *  - Elliptic orbits are solved through Newton iterations on the eccentric anomaly, hyperbolic ones on the
+ *    hyperbolic anomaly.
+ */
+
+#pragma once
+
+// System libraries
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+// DACE libraries
+#include "dace/dace.h"
+
+namespace kepler {
+
+    // Newton iterations allowed before giving up (e.g. near-parabolic orbits)
+    constexpr int max_iterations = 100;
+
+    /**
+     * Propagate a cartesian state (position and velocity) a given elapsed time under the two-body dynamics. Throws
+     * std::runtime_error if the Newton iterations do not converge within 'max_iterations'.
+     * @param rv [in] [DACE::AlgebraicVector<T>] Initial state: [x, y, z, vx, vy, vz]
+     * @param t [in] [U] Elapsed time
+     * @param mu [in] [double] Gravitational parameter
+     * @return DACE::AlgebraicVector<T> Final state: [x, y, z, vx, vy, vz]
+     */
+    template<typename T, typename U> DACE::AlgebraicVector<T> propagate(const DACE::AlgebraicVector<T>& rv, U t,
+                                                                       double mu);
+}
+
+// Include templates implementation
+#include "kepler_temp.cpp"
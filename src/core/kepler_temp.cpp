@@ -0,0 +1,129 @@
+/**
+ * KEPLER TEMPLATE FILE
+ */
+
+template<typename T, typename U> DACE::AlgebraicVector<T> kepler::propagate(const DACE::AlgebraicVector<T>& rv, U t,
+                                                                           double mu)
+{
+    // Get the maximum order at which DACE have been initialized
+    int ord = DACE::DA::getMaxOrder();
+
+    // Set DACE final state vector
+    DACE::AlgebraicVector<T> rv_fin(6);
+
+    // Set initial position and initial velocity
+    DACE::AlgebraicVector<T> rr0(3), vv0(3);
+
+    // Get position and velocity
+    for (int i = 0; i < 3; i++)
+    {
+        rr0[i] = rv[i];
+        vv0[i] = rv[i + 3];
+    }
+
+    // Angular momentum per unit mass
+    DACE::AlgebraicVector<T> hh = DACE::cross(rr0, vv0);
+
+    // Get the norm of all the vectors
+    auto h  = DACE::vnorm(hh);
+    auto r0 = DACE::vnorm(rr0);
+    auto v0 = DACE::vnorm(vv0);
+
+    // Semi-major axis
+    T a = mu / (2 * mu / r0 - v0*v0);
+
+    // Semi-latus rectum
+    T p = h*h / mu;
+
+    // Radial velocity parameter
+    T sigma0 = DACE::dot(rr0, vv0) / std::sqrt(mu);
+
+    // Tolerance and iterator
+    double tol = 1.0;
+    int iter = 0;
+
+    // Lagrange coefficients
+    T F, Ft, G, Gt;
+
+    // Elliptic or hyperbolic orbit
+    if (DACE::cons(a) > 0)
+    {
+        // Mean anomaly increment and first guess of the eccentric anomaly increment
+        T MmM0 = t * sqrt(mu/a/a/a);
+        T EmE0 = DACE::cons(MmM0);
+
+        // Newton iterations: at least one per order so that all the polynomial terms converge
+        while ((tol > 1e-13 || iter < ord + 1) && iter < kepler::max_iterations)
+        {
+            iter++;
+            T fx0 = -(MmM0) + (EmE0) + (sigma0)/sqrt((a))*(1 - cos((EmE0))) - (1-(r0)/(a)) * sin((EmE0));
+            T fxp = 1 + (sigma0)/sqrt((a)) * sin((EmE0)) - (1-(r0)/(a)) * cos((EmE0));
+            tol = std::abs(DACE::cons(fx0/fxp));
+            EmE0 = EmE0 - fx0/fxp;
+        }
+
+        // Safety check: not converged (NaN included)
+        if (!(tol <= 1e-13))
+        {
+            throw std::runtime_error("kepler::propagate: eccentric anomaly did not converge after " +
+                                     std::to_string(iter) + " iterations, last correction " + std::to_string(tol));
+        }
+
+        // True anomaly increment and final radius
+        T theta = 2*atan2(sqrt(a*p)*tan(EmE0/2), r0 + sigma0*sqrt(a)*tan(EmE0/2));
+        T r = p*r0 / (r0 + (p-r0)*cos(theta) - sqrt(p)*sigma0*sin(theta));
+
+        // Compute the Lagrangian coefficients
+        F = 1 - a/r0 * (1 - cos(EmE0));
+        G = a*sigma0/std::sqrt(mu)*(1 - cos(EmE0)) + r0 * sqrt(a/mu) * sin(EmE0);
+        Ft = - sqrt(mu*a)/(r*r0) * sin(EmE0);
+        Gt = 1 - a/r * (1-cos(EmE0));
+    }
+    else
+    {
+        // Hyperbolic mean anomaly increment and first guess of the hyperbolic anomaly increment
+        T NmN0 = t*sqrt(mu/(-a)/(-a)/(-a));
+        T HmH0 = 0.0;
+
+        // Newton iterations
+        while ((tol > 1e-14 || iter < ord + 1) && iter < kepler::max_iterations)
+        {
+            iter++;
+            T fx0 = - (NmN0) - (HmH0) + (sigma0)/sqrt((-a)) * (-1 + cosh((HmH0))) + (1-(r0)/(a)) * sinh((HmH0));
+            T fxp = -1 + (sigma0)/sqrt((-a))*sinh((HmH0)) + (1-(r0)/(a))*cosh((HmH0));
+            tol = std::abs(DACE::cons(fx0/fxp));
+            HmH0 = HmH0 - fx0/fxp;
+        }
+
+        // Safety check: not converged (NaN included)
+        if (!(tol <= 1e-14))
+        {
+            throw std::runtime_error("kepler::propagate: hyperbolic anomaly did not converge after " +
+                                     std::to_string(iter) + " iterations, last correction " + std::to_string(tol));
+        }
+
+        // Compute the Lagrangian coefficients
+        F = 1 - a/r0 * (1 - cosh(HmH0));
+        G = a*sigma0/std::sqrt(mu)*(1 - cosh(HmH0)) + r0 * sqrt(-a/mu) * sinh(HmH0);
+
+        // Final radius is needed for the time derivatives
+        DACE::AlgebraicVector<T> rv_temp(3);
+        for (int i = 0; i < 3; i++)
+        {
+            rv_temp[i] = F * rr0[i] + G * vv0[i];
+        }
+        T r = vnorm(rv_temp);
+
+        Ft = - sqrt(mu*(-a))/(r*r0) * sinh(HmH0);
+        Gt = 1 - a/r*(1-cosh(HmH0));
+    }
+
+    // Build final state
+    for (int i = 0; i < 3; i++)
+    {
+        rv_fin[i] = F * rr0[i] + G * vv0[i];
+        rv_fin[i+3] = Ft * rr0[i] + Gt * vv0[i];
+    }
+
+    return rv_fin;
+}
@@ -5,6 +5,24 @@
 
 #include "problems.h"
 
+// System libraries
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Kinematics, as 'FreeTorqueMotion': q_dot[i] = 0.5 * sum(kinematics[i][j][k] * q[j] * w[k])
+    constexpr double kinematics[4][4][3] = {
+            {{ 0.0,  0.0,  0.0}, {-1.0,  0.0,  0.0}, { 0.0, -1.0,  0.0}, { 0.0,  0.0, -1.0}},
+            {{ 1.0,  0.0,  0.0}, { 0.0,  0.0,  0.0}, { 0.0,  0.0,  1.0}, { 0.0, -1.0,  0.0}},
+            {{ 0.0,  1.0,  0.0}, { 0.0,  0.0, -1.0}, { 0.0,  0.0,  0.0}, { 1.0,  0.0,  0.0}},
+            {{ 0.0,  0.0,  1.0}, { 0.0,  1.0,  0.0}, { 0.0,  0.0, -1.0}, { 0.0,  0.0,  0.0}}};
+
+    // Cross product, as 'get_cross_product': c[i] = sum(sign * w[p] * b[r]) over its terms {i, sign, p, r}, b = I*omega
+    constexpr int cross_terms[6][4] = {{0, 1, 1, 2}, {0, -1, 2, 1}, {1, -1, 0, 2}, {1, 1, 2, 2},
+                                       {2, 1, 0, 1}, {2, -1, 1, 0}};
+}
+
 problems::problems(PROBLEM type, double mu)
 {
     // Set problem type
@@ -177,6 +195,241 @@ DACE::AlgebraicVector<DACE::DA> problems::get_cross_product(DACE::AlgebraicVecto
     return c;
 }
 
+void problems::TwoBodyVariational(const double* x, double* f, double* a, double* h) const
+{
+    // Distance to the central body
+    double r = std::sqrt(x[0]*x[0] + x[1]*x[1] + x[2]*x[2]);
+    double r3 = r*r*r;
+
+    // Derivative: velocity and gravity, as 'TwoBodyProblem'
+    for (int i = 0; i < 3; i++)
+    {
+        f[i] = x[i + 3];
+        f[i + 3] = -this->mu_*x[i]/r3;
+    }
+
+    // Jacobian: [0, I; G, 0], G = -mu/r^3 (I - 3 r r^T / r^2)
+    std::fill(a, a + 36, 0.0);
+    for (int i = 0; i < 3; i++)
+    {
+        a[i*6 + i + 3] = 1.0;
+        for (int j = 0; j < 3; j++)
+        {
+            a[(i + 3)*6 + j] = -this->mu_/r3 * ((i == j ? 1.0 : 0.0) - 3.0*x[i]*x[j]/(r*r));
+        }
+    }
+
+    // Hessian: only gravity depends nonlinearly on the state, and only through the position
+    if (h == nullptr)
+    {
+        return;
+    }
+    std::fill(h, h + 216, 0.0);
+    double r5 = r3*r*r;
+    double r7 = r5*r*r;
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                h[(i + 3)*36 + j*6 + k] = 3.0*this->mu_/r5 * ((i == j ? x[k] : 0.0) + (i == k ? x[j] : 0.0) +
+                                                              (j == k ? x[i] : 0.0))
+                                          - 15.0*this->mu_*x[i]*x[j]*x[k]/r7;
+            }
+        }
+    }
+}
+
+void problems::FreeTorqueVariational(const double* x, double* f, double* a, double* h) const
+{
+    // Quaternion and angular velocity
+    const double* q = x;
+    const double* w = x + 4;
+
+    // Cross product: b = I*omega
+    double b[3], c[3] = {0.0, 0.0, 0.0};
+    for (int i = 0; i < 3; i++)
+    {
+        b[i] = this->inertia_[i][0]*w[0] + this->inertia_[i][1]*w[1] + this->inertia_[i][2]*w[2];
+    }
+    for (const auto& term : cross_terms)
+    {
+        c[term[0]] += term[1] * w[term[2]] * b[term[3]];
+    }
+
+    // Derivative, Jacobian and Hessian start empty
+    std::fill(f, f + 7, 0.0);
+    std::fill(a, a + 49, 0.0);
+    if (h != nullptr)
+    {
+        std::fill(h, h + 343, 0.0);
+    }
+
+    // Kinematics: bilinear in q and omega
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                // Safety check: most terms are zero
+                double coefficient = 0.5 * kinematics[i][j][k];
+                if (coefficient == 0.0) { continue; }
+
+                f[i] += coefficient * q[j] * w[k];
+                a[i*7 + j] += coefficient * w[k];
+                a[i*7 + k + 4] += coefficient * q[j];
+                if (h != nullptr)
+                {
+                    h[i*49 + j*7 + k + 4] = coefficient;
+                    h[i*49 + (k + 4)*7 + j] = coefficient;
+                }
+            }
+        }
+    }
+
+    // Dynamics: derivatives of the cross product with respect to omega, first and second
+    double dc[3][3] = {}, ddc[3][3][3] = {};
+    for (const auto& term : cross_terms)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            dc[term[0]][j] += term[1] * ((term[2] == j ? b[term[3]] : 0.0) + w[term[2]] * this->inertia_[term[3]][j]);
+            for (int k = 0; k < 3; k++)
+            {
+                ddc[term[0]][j][k] += term[1] * ((term[2] == j ? this->inertia_[term[3]][k] : 0.0) +
+                                                 (term[2] == k ? this->inertia_[term[3]][j] : 0.0));
+            }
+        }
+    }
+
+    // Then through the inverse inertia
+    for (int i = 0; i < 3; i++)
+    {
+        for (int l = 0; l < 3; l++)
+        {
+            f[i + 4] += this->inverse_[i][l] * c[l];
+            for (int j = 0; j < 3; j++)
+            {
+                a[(i + 4)*7 + j + 4] += this->inverse_[i][l] * dc[l][j];
+                if (h == nullptr) { continue; }
+                for (int k = 0; k < 3; k++)
+                {
+                    h[(i + 4)*49 + (j + 4)*7 + k + 4] += this->inverse_[i][l] * ddc[l][j][k];
+                }
+            }
+        }
+    }
+}
+
+std::vector<DACE::AlgebraicVector<DACE::DA>> problems::TwoBodyTaylor(const DACE::AlgebraicVector<DACE::DA>& scv,
+                                                                    unsigned int order) const
+{
+    // Coefficients of the state, and of the auxiliary series s = |r|^2 and u = s^alpha
+    std::vector<DACE::AlgebraicVector<DACE::DA>> x(order + 1, DACE::AlgebraicVector<DACE::DA>(6));
+    std::vector<DACE::DA> s(order + 1), u(order + 1);
+    const double alpha = -1.5;
+    DACE::DA inverse_s0;
+    x[0] = scv;
+
+    for (unsigned int k = 0; k < order; k++)
+    {
+        // Squared distance: Cauchy product of the position with itself
+        s[k] = 0.0;
+        for (unsigned int j = 0; j <= k; j++)
+        {
+            s[k] += x[j][0]*x[k - j][0] + x[j][1]*x[k - j][1] + x[j][2]*x[k - j][2];
+        }
+
+        // Its power: k s_0 u_k = sum((alpha (k - j) - j) s_(k-j) u_j), j < k
+        if (k == 0)
+        {
+            auto r = DACE::sqrt(s[0]);
+            u[0] = 1.0/(r*r*r);
+            inverse_s0 = 1.0/s[0];
+        }
+        else
+        {
+            u[k] = 0.0;
+            for (unsigned int j = 0; j < k; j++)
+            {
+                u[k] += (alpha*(k - j) - j) * s[k - j]*u[j];
+            }
+            u[k] *= inverse_s0/k;
+        }
+
+        // Next coefficients: velocity and gravity, -mu r u
+        for (int i = 0; i < 3; i++)
+        {
+            DACE::DA a = 0.0;
+            for (unsigned int j = 0; j <= k; j++)
+            {
+                a += x[j][i]*u[k - j];
+            }
+            x[k + 1][i] = x[k][i + 3]/(k + 1);
+            x[k + 1][i + 3] = -this->mu_*a/(k + 1);
+        }
+    }
+
+    return x;
+}
+
+std::vector<DACE::AlgebraicVector<DACE::DA>> problems::FreeTorqueTaylor(const DACE::AlgebraicVector<DACE::DA>& scv,
+                                                                       unsigned int order) const
+{
+    // Coefficients of the state, quaternion and angular velocity, and of the angular momentum b = I*omega
+    std::vector<DACE::AlgebraicVector<DACE::DA>> x(order + 1, DACE::AlgebraicVector<DACE::DA>(7));
+    std::vector<DACE::AlgebraicVector<DACE::DA>> b(order + 1, DACE::AlgebraicVector<DACE::DA>(3));
+    x[0] = scv;
+
+    for (unsigned int k = 0; k < order; k++)
+    {
+        // Angular momentum
+        for (int i = 0; i < 3; i++)
+        {
+            b[k][i] = this->inertia_[i][0]*x[k][4] + this->inertia_[i][1]*x[k][5] + this->inertia_[i][2]*x[k][6];
+        }
+
+        // Kinematics: Cauchy products of the quaternion and the angular velocity
+        for (int i = 0; i < 4; i++)
+        {
+            DACE::DA q_dot = 0.0;
+            for (int j = 0; j < 4; j++)
+            {
+                for (int l = 0; l < 3; l++)
+                {
+                    // Safety check: most terms are zero
+                    if (kinematics[i][j][l] == 0.0) { continue; }
+
+                    for (unsigned int m = 0; m <= k; m++)
+                    {
+                        q_dot += kinematics[i][j][l] * x[m][j]*x[k - m][l + 4];
+                    }
+                }
+            }
+            x[k + 1][i] = 0.5*q_dot/(k + 1);
+        }
+
+        // Dynamics: Cauchy products of the angular velocity and momentum, then through the inverse inertia
+        DACE::AlgebraicVector<DACE::DA> c(3, 0.0);
+        for (const auto& term : cross_terms)
+        {
+            for (unsigned int m = 0; m <= k; m++)
+            {
+                c[term[0]] += term[1] * x[m][term[2] + 4]*b[k - m][term[3]];
+            }
+        }
+        for (int i = 0; i < 3; i++)
+        {
+            x[k + 1][i + 4] = (this->inverse_[i][0]*c[0] + this->inverse_[i][1]*c[1] +
+                               this->inverse_[i][2]*c[2])/(k + 1);
+        }
+    }
+
+    return x;
+}
+
 void problems::set_inertia_matrix(double inertia[3][3])
 {
     // Show info to the user
@@ -326,6 +579,47 @@ DACE::AlgebraicVector<DACE::DA> problems::solve(const DACE::AlgebraicVector<DACE
 }
 
 
+bool problems::solve_variational(const double* x, double /* t */, double* f, double* a, double* h) const
+{
+    switch (this->type_)
+    {
+        case PROBLEM::TWO_BODY:
+        {
+            this->TwoBodyVariational(x, f, a, h);
+            return true;
+        }
+        case PROBLEM::FREE_TORQUE_MOTION:
+        {
+            this->FreeTorqueVariational(x, f, a, h);
+            return true;
+        }
+        default:
+        {
+            return false;
+        }
+    }
+}
+
+std::vector<DACE::AlgebraicVector<DACE::DA>> problems::taylor_coefficients(const DACE::AlgebraicVector<DACE::DA>& scv,
+                                                                          unsigned int order) const
+{
+    switch (this->type_)
+    {
+        case PROBLEM::TWO_BODY:
+        {
+            return this->TwoBodyTaylor(scv, order);
+        }
+        case PROBLEM::FREE_TORQUE_MOTION:
+        {
+            return this->FreeTorqueTaylor(scv, order);
+        }
+        default:
+        {
+            return {};
+        }
+    }
+}
+
 void problems::summary(std::string * summary2return, bool recursive)
 {
     // Check if this module is summary to be launched
@@ -5,6 +5,7 @@
 
 // System libraries
 #include <cstdlib>
+#include <vector>
 
 // DACE libraries
 #include "dace/dace.h"
@@ -35,12 +36,54 @@ public:
     // Solve problems
     DACE::AlgebraicVector<DACE::DA> solve(const DACE::AlgebraicVector<DACE::DA>& scv, double t);
 
+    /**
+     * Dense dynamics for the variational equations: derivative of the state, its Jacobian and, if asked for, its
+     * Hessian, in doubles. Available for the two-body and the free torque motion problems.
+     * @param x [in] [double*] state, [n]
+     * @param t [in] [double] unused, the dynamics are autonomous. Same signature as 'solve'
+     * @param f [out] [double*] derivative, [n]
+     * @param a [out] [double*] Jacobian of the derivative, row-major [n x n]
+     * @param h [out] [double*] Hessian of the derivative, row-major [n x n x n], nullptr to skip it
+     * @return bool false if the problem has no dense dynamics
+     */
+    bool solve_variational(const double* x, double t, double* f, double* a, double* h = nullptr) const;
+
+    /**
+     * Taylor coefficients in time of the solution through a state: x(t + tau) = sum(coefficients[k] * tau^k), k from
+     * 0 to 'order'. Built with the recurrences of the products and powers of the equations, term by term as 'solve'.
+     * Available for the two-body and the free torque motion problems.
+     * @param scv [in] [DACE::AlgebraicVector<DACE::DA>] state at t
+     * @param order [in] [unsigned int]
+     * @return std::vector<DACE::AlgebraicVector<DACE::DA>> order + 1 coefficients, empty if not available
+     */
+    [[nodiscard]] std::vector<DACE::AlgebraicVector<DACE::DA>> taylor_coefficients(
+            const DACE::AlgebraicVector<DACE::DA>& scv, unsigned int order) const;
+
+    /**
+     * Whether 'solve_variational' is available for the problem type.
+     * @return bool
+     */
+    [[nodiscard]] bool has_variational() const
+    {
+        return this->type_ == PROBLEM::TWO_BODY || this->type_ == PROBLEM::FREE_TORQUE_MOTION;
+    }
+
 private:
     // Problems
     DACE::AlgebraicVector<DACE::DA> TwoBodyProblem(DACE::AlgebraicVector<DACE::DA> scv, double t) const;
     static DACE::AlgebraicVector<DACE::DA> FreeFallObject(DACE::AlgebraicVector<DACE::DA> scv, double t);
     DACE::AlgebraicVector<DACE::DA> FreeTorqueMotion(DACE::AlgebraicVector<DACE::DA> scv, double t);
 
+    // Taylor coefficients of the problems
+    [[nodiscard]] std::vector<DACE::AlgebraicVector<DACE::DA>> TwoBodyTaylor(const DACE::AlgebraicVector<DACE::DA>& scv,
+                                                                           unsigned int order) const;
+    [[nodiscard]] std::vector<DACE::AlgebraicVector<DACE::DA>> FreeTorqueTaylor(
+            const DACE::AlgebraicVector<DACE::DA>& scv, unsigned int order) const;
+
+    // Dense problems: derivative, Jacobian and Hessian
+    void TwoBodyVariational(const double* x, double* f, double* a, double* h) const;
+    void FreeTorqueVariational(const double* x, double* f, double* a, double* h) const;
+
     // Static transformations
     /**
      * Polar to cartesian coordinates in 2D
@@ -56,6 +99,7 @@ public:
 public:
     // Getters
     PROBLEM get_type(){return this->type_;}
+    [[nodiscard]] double get_mu() const {return this->mu_;}
 
 private:
     // Attributes
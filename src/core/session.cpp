@@ -0,0 +1,371 @@
+/**
+ * Propagation session: owns every object needed to propagate a scenario (problem, integrator and super manifold) and
+ * keeps them alive so that the result can be queried several times.
+ */
+
+#include "session.h"
+
+session::session(const json_input& specs)
+{
+    // Save specifications
+    this->specs_ = specs;
+
+    // Auxiliary variables
+    auto order = (unsigned int) this->specs_.algebra.order;
+    auto nvar = (unsigned int) this->specs_.algebra.variables;
+
+    // Safety check
+    if (this->specs_.initial_conditions.mean.size() < nvar || this->specs_.scaling.beta.size() < nvar)
+    {
+        throw std::runtime_error(tools::string::print2string(
+                "Session: mean and betas must have at least '%d' components.", nvar));
+    }
+
+    // Initialize DACE only if needed: re-initializing invalidates every DA alive in other sessions
+    bool same_algebra = DACE::DA::isInitialized() && DACE::DA::getMaxOrder() == order &&
+            DACE::DA::getMaxVariables() == nvar;
+
+    if (!same_algebra)
+    {
+        // Safety check
+        if (session_registry::size() > 0)
+        {
+            throw std::runtime_error(tools::string::print2string(
+                    "Session: cannot initialize DACE with order '%d' and '%d' variables while other sessions "
+                    "are alive with a different algebra.", order, nvar));
+        }
+
+        // Initialize DACE
+        tools::da_context::pin(order, nvar);
+    }
+
+    // Set initial state
+    this->scv0_ = DACE::AlgebraicVector<DACE::DA>(nvar);
+    for (unsigned int i = 0; i < nvar; i++)
+    {
+        this->scv0_[i] = this->specs_.initial_conditions.mean[i] + this->specs_.scaling.beta[i] * DACE::DA((int) i + 1);
+    }
+
+    // Build integrator
+    this->integrator_ = std::make_unique<integrator>(this->specs_.propagation.integrator, this->specs_.algorithm,
+                                                     this->specs_.propagation.time_step);
+
+    // Adaptive truncation order if requested
+    if (this->specs_.algebra.adaptive_order)
+    {
+        this->integrator_->set_adaptive_order(this->specs_.algebra.min_order);
+    }
+
+    // Tolerance of the Taylor integrator
+    this->integrator_->set_tolerance(this->specs_.propagation.tolerance);
+
+    // Build problem
+    this->problem_ = std::make_unique<problems>(this->specs_.problem, this->specs_.mu);
+
+    // Set inertia matrix if attitude
+    if (this->specs_.problem == PROBLEM::FREE_TORQUE_MOTION)
+    {
+        this->problem_->set_inertia_matrix(this->specs_.initial_conditions.inertia);
+    }
+
+    // Build super manifold
+    switch (this->specs_.algorithm)
+    {
+        case ALGORITHM::ADS:
+        {
+            this->super_manifold_ = std::make_unique<SuperManifold>(this->specs_.ads.tolerance,
+                                                                    this->specs_.ads.max_split[0], ALGORITHM::ADS);
+            break;
+        }
+        case ALGORITHM::LOADS:
+        {
+            this->super_manifold_ = std::make_unique<SuperManifold>(this->specs_.loads.nli_threshold,
+                                                                    this->specs_.loads.max_split[0], ALGORITHM::LOADS);
+
+            // Set beta constant in integrator
+            this->integrator_->set_beta(this->specs_.scaling.beta);
+            break;
+        }
+        case ALGORITHM::NONE:
+        {
+            this->super_manifold_ = std::make_unique<SuperManifold>(ALGORITHM::NONE);
+            break;
+        }
+        default:
+        {
+            throw std::runtime_error("Session: algorithm should be ADS, LOADS or NONE.");
+        }
+    }
+
+    // Merge siblings back if requested
+    if (this->specs_.coarsening.set)
+    {
+        this->super_manifold_->set_coarsening(this->specs_.coarsening.tolerance, this->specs_.coarsening.interval);
+    }
+
+    // Predictive splitting if requested
+    if (this->specs_.splitting.set)
+    {
+        this->super_manifold_->set_split_plan({this->specs_.splitting.mode, this->specs_.splitting.max_pieces,
+                                               this->specs_.splitting.min_steps});
+    }
+
+    // Weight the final patches by the probability mass of their box
+    this->super_manifold_->set_confidence_interval(this->specs_.initial_conditions.confidence_interval);
+
+    // Set problem ptr in the integrator
+    this->integrator_->set_problem_ptr(this->problem_.get());
+}
+
+void session::propagate(std::string* propagation_summary)
+{
+    // Prepare integrator and super manifold
+    this->prepare();
+
+    // Cached: every segment is restored
+    if (this->cache_.enabled() &&
+        cache::fetch(this->cache_, this->specs_, *this->super_manifold_, propagation_summary))
+    {
+        this->propagated_ = true;
+        this->t1_ = this->specs_.propagation.final_time;
+        return;
+    }
+
+    // Apply main algorithm: ADS / LOADS. And integration algorithm
+    this->super_manifold_->split_domain(propagation_summary);
+
+    // Remaining segments
+    this->finish();
+
+    // Keep it for the next session with the same inputs
+    if (this->cache_.enabled())
+    {
+        cache::store(this->cache_, this->specs_, *this->super_manifold_);
+    }
+}
+
+void session::resume(const std::filesystem::path& file_path, std::string* propagation_summary)
+{
+    // Prepare integrator and super manifold
+    this->prepare();
+
+    // Apply main algorithm from the checkpoint
+    this->super_manifold_->resume_domain(file_path, propagation_summary);
+
+    // Remaining segments
+    this->finish();
+}
+
+void session::propagate_from(const Manifold& pending, const Manifold& finished, int split_count)
+{
+    // Prepare integrator and super manifold
+    this->prepare();
+
+    // Apply main algorithm from the given state
+    this->super_manifold_->continue_domain(pending, finished, split_count);
+
+    // Remaining segments
+    this->finish();
+}
+
+void session::prepare()
+{
+    // Propagate only once, use extend afterwards
+    if (this->propagated_)
+    {
+        throw std::runtime_error("Session: already propagated, use 'extend' to propagate further.");
+    }
+
+    // Only once
+    if (this->prepared_)
+    {
+        return;
+    }
+
+    // Deduce whether interruption feature shall be made or not
+    bool interruption =
+            this->specs_.algorithm == ALGORITHM::ADS ? !this->specs_.ads.max_split.empty() && this->specs_.ads.max_split[0] > 0 :
+            this->specs_.algorithm == ALGORITHM::LOADS ? !this->specs_.loads.max_split.empty() && this->specs_.loads.max_split[0] > 0 :
+            false;
+
+    // Setting integrator parameters: up to the first epoch if the propagation is segmented
+    const auto& epochs = this->specs_.propagation.epochs;
+    double t1 = epochs.empty() ? this->specs_.propagation.final_time : epochs.front();
+    this->integrator_->set_integration_parameters(this->scv0_, this->specs_.propagation.initial_time, t1,
+                                                  interruption);
+
+    // Set integrator in the super manifold
+    this->super_manifold_->set_integrator_ptr(this->integrator_.get());
+
+    // Budget of the splitting
+    this->start_budget();
+
+    // Set new truncation error
+    tools::da_context::set_eps(1e-40);
+
+    // Update status
+    this->prepared_ = true;
+}
+
+void session::finish()
+{
+    // Segmented propagation: continue through the remaining epochs up to the final time
+    const auto& epochs = this->specs_.propagation.epochs;
+    if (!epochs.empty())
+    {
+        auto segment_ends = epochs;
+        segment_ends.push_back(this->specs_.propagation.final_time);
+        this->super_manifold_->extend_domain(segment_ends);
+    }
+
+    // Update status
+    this->propagated_ = true;
+    this->t1_ = this->specs_.propagation.final_time;
+}
+
+void session::start_budget()
+{
+    // Only if requested
+    if (!this->specs_.budget.set)
+    {
+        return;
+    }
+
+    this->super_manifold_->set_budget({(std::size_t) this->specs_.budget.max_patches, this->specs_.budget.max_memory,
+                                       this->specs_.budget.max_time, this->specs_.budget.priority,
+                                       this->specs_.initial_conditions.confidence_interval});
+}
+
+void session::extend(double t1)
+{
+    // Safety checks
+    if (!this->propagated_)
+    {
+        throw std::runtime_error("Session: cannot extend before propagating.");
+    }
+
+    if (t1 <= this->t1_)
+    {
+        throw std::runtime_error(tools::string::print2string(
+                "Session: new final time '%.6f' must be greater than the current one '%.6f'.", t1, this->t1_));
+    }
+
+    // Propagate the current patches further, with a new time budget
+    this->start_budget();
+    this->super_manifold_->extend_domain(t1);
+
+    // Update final time
+    this->t1_ = t1;
+}
+
+std::vector<DACE::AlgebraicVector<double>> session::evaluate(const std::vector<DACE::AlgebraicVector<double>>& samples,
+                                                             int segment) const
+{
+    // Safety check
+    if (!this->propagated_)
+    {
+        throw std::runtime_error("Session: cannot evaluate before propagating.");
+    }
+
+    // Manifold to evaluate: last one by default
+    auto n_segments = this->super_manifold_->get_segment_count();
+    auto manifold = this->super_manifold_->get_segment(segment < 0 ? n_segments - 1 : (std::size_t) segment);
+
+    // Trace
+    tools::trace::scoped_span trace_span("session::evaluate", "evaluate");
+    trace_span.set_args(tools::string::print2string("\"samples\": %zu", samples.size()));
+
+    // Result to be returned
+    std::vector<DACE::AlgebraicVector<double>> result;
+    result.reserve(samples.size());
+
+    // Initial domain
+    const auto& init_set = this->super_manifold_->previous_->front();
+
+    // Evaluate each sample
+    for (const auto& sample : samples)
+    {
+        result.push_back(manifold->pointEvaluationManifold(init_set, sample, 1));
+    }
+
+    return result;
+}
+
+namespace session_registry
+{
+    // Registry storage
+    std::mutex mutex_;
+    std::map<std::uint64_t, std::unique_ptr<session>> sessions_;
+    std::uint64_t next_handle_ = 1;
+}
+
+std::uint64_t session_registry::insert(std::unique_ptr<session> s)
+{
+    // Lock registry
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Assign handle
+    auto handle = next_handle_++;
+    sessions_[handle] = std::move(s);
+
+    return handle;
+}
+
+session* session_registry::find(std::uint64_t handle)
+{
+    // Lock registry
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Look for it
+    auto it = sessions_.find(handle);
+
+    return it == sessions_.end() ? nullptr : it->second.get();
+}
+
+bool session_registry::erase(std::uint64_t handle)
+{
+    // Session to be destroyed out of the lock
+    std::unique_ptr<session> s;
+
+    {
+        // Lock registry
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // Look for it
+        auto it = sessions_.find(handle);
+        if (it == sessions_.end())
+        {
+            return false;
+        }
+
+        // Take ownership and remove entry
+        s = std::move(it->second);
+        sessions_.erase(it);
+    }
+
+    return true;
+}
+
+std::vector<std::uint64_t> session_registry::handles()
+{
+    // Lock registry
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Collect handles
+    std::vector<std::uint64_t> result;
+    result.reserve(sessions_.size());
+    for (const auto& entry : sessions_)
+    {
+        result.push_back(entry.first);
+    }
+
+    return result;
+}
+
+std::size_t session_registry::size()
+{
+    // Lock registry
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return sessions_.size();
+}
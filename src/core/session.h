@@ -0,0 +1,171 @@
+/**
+ * Propagation session: owns every object needed to propagate a scenario (problem, integrator and super manifold) and
+ * keeps them alive so that the result can be queried several times (evaluate samples, extend the propagation, fetch
+ * patch data) without propagating again.
+ */
+
+#pragma once
+
+// System libraries
+#include <memory>
+#include <mutex>
+#include <map>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+// Project libraries
+#include "ads/SuperManifold.h"
+#include "ads/cache.h"
+#include "tools/da_context.h"
+#include "specs/json_input.h"
+
+class session
+{
+public: // Constructors
+
+    /**
+     * Build a session from the resolved specifications (means and betas already set). DACE is initialized here if it
+     * was not initialized with the same algebra already.
+     * @param specs [in] [json_input]
+     */
+    explicit session(const json_input& specs);
+
+public: // Methods
+
+    /**
+     * Propagate the scenario from the initial time to the final time set in the specifications, stopping at every
+     * intermediate epoch (if any) to keep the manifold of each segment.
+     * @param propagation_summary [out] [std::string*] summary of the splitting, if not nullptr
+     */
+    void propagate(std::string* propagation_summary = nullptr);
+
+    /**
+     * Same as 'propagate', but continuing the splitting from a checkpoint file. The cache is not used.
+     * @param file_path [in] [std::filesystem::path]
+     * @param propagation_summary [out] [std::string*] summary of the splitting, if not nullptr
+     */
+    void resume(const std::filesystem::path& file_path, std::string* propagation_summary = nullptr);
+
+    /**
+     * Reuse propagations of identical inputs: 'propagate' looks the result up in the cache first, and stores it there
+     * when it had to propagate.
+     * @param settings [in] [cache::settings]
+     */
+    void set_cache(const cache::settings& settings) { this->cache_ = settings; }
+
+    /**
+     * Same as 'propagate', but starting the splitting from an intermediate state (e.g. shared with another session of
+     * the same initial conditions). DACE must keep the algebra the patches were built with.
+     * @param pending [in] [Manifold] patches still to be integrated and/or split
+     * @param finished [in] [Manifold] patches already finished
+     * @param split_count [in] [int] identifier of the next patch to be created
+     */
+    void propagate_from(const Manifold& pending, const Manifold& finished, int split_count);
+
+    /**
+     * Set the integration parameters (up to the first epoch) and the integrator in the super manifold, without
+     * propagating. The initial domain is then the current manifold. Called by the propagate methods.
+     */
+    void prepare();
+
+    /**
+     * Extend the propagation of the current manifold up to a new final time.
+     * @param t1 [in] [double]
+     */
+    void extend(double t1);
+
+    /**
+     * Evaluate samples (deviations from the mean, real units) in the propagated manifold.
+     * @param samples [in] [std::vector<DACE::AlgebraicVector<double>>]
+     * @param segment [in] [int] segment whose final epoch is evaluated, the last one if negative
+     * @return std::vector<DACE::AlgebraicVector<double>>
+     */
+    std::vector<DACE::AlgebraicVector<double>> evaluate(const std::vector<DACE::AlgebraicVector<double>>& samples,
+                                                        int segment = -1) const;
+
+public: // Getters
+
+    [[nodiscard]] SuperManifold* get_super_manifold() const { return this->super_manifold_.get(); }
+    [[nodiscard]] integrator* get_integrator() const { return this->integrator_.get(); }
+    [[nodiscard]] const DACE::AlgebraicVector<DACE::DA>& get_initial_state() const { return this->scv0_; }
+    [[nodiscard]] Manifold* get_manifold_fin() const { return this->super_manifold_->get_manifold_fin(); }
+    [[nodiscard]] const json_input& get_specs() const { return this->specs_; }
+    [[nodiscard]] bool is_propagated() const { return this->propagated_; }
+    [[nodiscard]] double get_final_time() const { return this->t1_; }
+    [[nodiscard]] std::size_t get_segment_count() const { return this->super_manifold_->get_segment_count(); }
+    [[nodiscard]] double get_segment_time(std::size_t k) const { return this->super_manifold_->get_segment_time(k); }
+
+private: // Methods
+
+    /**
+     * Propagate the remaining segments, if any, and update the status.
+     */
+    void finish();
+
+    /**
+     * Set the budget of the splitting, if any: the wall time is counted from this call.
+     */
+    void start_budget();
+
+private: // Attributes
+
+    // Resolved specifications
+    json_input specs_{};
+
+    // Initial state
+    DACE::AlgebraicVector<DACE::DA> scv0_{};
+
+    // Owned objects
+    std::unique_ptr<problems> problem_ = nullptr;
+    std::unique_ptr<integrator> integrator_ = nullptr;
+    std::unique_ptr<SuperManifold> super_manifold_ = nullptr;
+
+    // Propagation cache, disabled by default
+    cache::settings cache_{};
+
+    // Propagation status
+    bool prepared_{false};
+    bool propagated_{false};
+    double t1_{};
+};
+
+/**
+ * Process-wide registry of sessions, accessed through opaque handles. Handles are never reused within a process.
+ */
+namespace session_registry
+{
+    /**
+     * Insert a session in the registry.
+     * @param s [in] [std::unique_ptr<session>]
+     * @return std::uint64_t handle
+     */
+    std::uint64_t insert(std::unique_ptr<session> s);
+
+    /**
+     * Find a session by its handle.
+     * @param handle [in] [std::uint64_t]
+     * @return session* or nullptr if not found
+     */
+    session* find(std::uint64_t handle);
+
+    /**
+     * Remove (and destroy) a session.
+     * @param handle [in] [std::uint64_t]
+     * @return true if the handle existed
+     */
+    bool erase(std::uint64_t handle);
+
+    /**
+     * Get the alive handles.
+     * @return std::vector<std::uint64_t>
+     */
+    std::vector<std::uint64_t> handles();
+
+    /**
+     * Number of alive sessions.
+     * @return std::size_t
+     */
+    std::size_t size();
+}
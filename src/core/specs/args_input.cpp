@@ -25,6 +25,41 @@ args_input::args_input(int argc, char **argv)
             this->silent = true;
             continue;
         }
+        else if (argv_str == "--profile") // Profile the run: dumps profile.json in the output directory
+        {
+            this->profile = true;
+            continue;
+        }
+        else if (argv_str == "--trace" && i + 1 < argc) // Timeline of the run: Trace Event Format file
+        {
+            this->trace_filepath = argv[++i];
+            continue;
+        }
+        else if (argv_str == "--checkpoint" && i + 1 < argc) // Periodic checkpoints of the splitting state
+        {
+            this->checkpoint_filepath = argv[++i];
+            continue;
+        }
+        else if (argv_str == "--checkpoint-interval" && i + 1 < argc) // Minimum seconds between checkpoints
+        {
+            this->checkpoint_interval = std::stod(argv[++i]);
+            continue;
+        }
+        else if (argv_str == "--resume" && i + 1 < argc) // Resume from a checkpoint
+        {
+            this->resume_filepath = argv[++i];
+            continue;
+        }
+        else if (argv_str == "--spill-segments" && i + 1 < argc) // Keep the segments of a segmented run on disk
+        {
+            this->spill_dir = argv[++i];
+            continue;
+        }
+        else if (argv_str == "--cache-dir" && i + 1 < argc) // Reuse propagations of identical inputs
+        {
+            this->cache_dir = argv[++i];
+            continue;
+        }
         else if (argv_str == "--config") // Input: config file
         {
             this->json_filepath = argv[i + 1];
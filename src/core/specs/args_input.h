@@ -37,9 +37,28 @@ public:
     // Show comilation info
     bool compilation_info{false};
 
+    // Profile the run
+    bool profile{false};
+
     // Input file
     std::string json_filepath{};
 
+    // Trace file (Trace Event Format), empty if not requested
+    std::string trace_filepath{};
+
+    // Periodic checkpoint file, empty if not requested, and minimum wall time between checkpoints [s]
+    std::string checkpoint_filepath{};
+    double checkpoint_interval{300.0};
+
+    // Checkpoint to resume from, empty if not requested
+    std::string resume_filepath{};
+
+    // Directory where the segments of a segmented propagation are spilled, kept in memory if empty
+    std::string spill_dir{};
+
+    // Propagation cache directory, disabled if empty
+    std::string cache_dir{};
+
 public:
     // Methods
     /**
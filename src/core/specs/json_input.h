@@ -32,6 +32,10 @@ public:// Attributes
          int order{};
          int variables{};
 
+         // Adaptive truncation order: patches may go down to 'min_order' while nearly linear
+         bool adaptive_order{false};
+         int min_order{};
+
          // Algebra set?
          bool set{false};
     };
@@ -44,6 +48,12 @@ public:// Attributes
          double time_step{};
          INTEGRATOR integrator{INTEGRATOR::NA};
 
+         // Relative tolerance of the Taylor integrator, which picks its own steps
+         double tolerance{1e-14};
+
+         // Optional intermediate epochs of a segmented propagation, sorted and within (initial_time, final_time)
+         std::vector<double> epochs{};
+
          // Propagation set?
          bool set{false};
      };
@@ -98,6 +108,61 @@ public:// Attributes
          bool set{false};
      };
 
+     // Parameter sweep: every combination is a case, empty lists keep the single value of the input
+     struct sweep
+     {
+         std::vector<double> final_time{};
+         std::vector<double> nli_threshold{}; // LOADS
+         std::vector<int> max_split{};
+
+         // Sweep set?
+         bool set{false};
+     };
+
+     // Coarsening: siblings are merged back when their parent polynomial reproduces them within the tolerance
+     struct coarsening
+     {
+         double tolerance{};
+         double interval{}; // Time between merging stops, zero for the end of each segment only
+
+         // Coarsening set?
+         bool set{false};
+     };
+
+     // Budget: caps of the splitting (zero for unlimited) and order of the pending patches
+     struct budget
+     {
+         int max_patches{};
+         double max_memory{}; // [MB]
+         double max_time{};   // [s]
+         BUDGET_PRIORITY priority{BUDGET_PRIORITY::MASS};
+
+         // Budget set?
+         bool set{false};
+     };
+
+     // Splitting: how the patches violating the threshold are cut
+     struct splitting
+     {
+         SPLIT_MODE mode{SPLIT_MODE::PREDICTIVE};
+         int max_pieces{9};
+         int min_steps{5}; // Steps the pieces should last before splitting again
+
+         // Splitting set?
+         bool set{false};
+     };
+
+     // Gaussian mixture output: components after merging (zero for one per patch) and files
+     struct mixture
+     {
+         int components{0};
+         bool binary{true};
+         bool json{false};
+
+         // Mixture set?
+         bool set{false};
+     };
+
      // Initialize them all
      algebra algebra;
      propagation propagation;
@@ -105,6 +170,11 @@ public:// Attributes
      ads ads;
      loads loads;
      scaling scaling;
+     sweep sweep;
+     coarsening coarsening;
+     budget budget;
+     splitting splitting;
+     mixture mixture;
 
      // Auxiliary for this class attributes
      std::string filepath;
@@ -0,0 +1,212 @@
+/**
+ * Parameter sweeps with shared-prefix reuse.
+ */
+
+#include "sweep.h"
+
+// System libraries
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+namespace sweep
+{
+    /**
+     * One line of the summary
+     */
+    struct summary_entry
+    {
+        std::string name{};
+        double nli_threshold{};
+        int max_split{};
+        double final_time{};
+        std::size_t patches{};
+        double case_s{};
+    };
+
+    /**
+     * Sorted values without duplicates.
+     * @tparam T [in] [template]
+     * @param v [in] [std::vector<T>]
+     * @return std::vector<T>
+     */
+    template<typename T>
+    std::vector<T> sorted_unique(std::vector<T> v)
+    {
+        std::sort(v.begin(), v.end());
+        v.erase(std::unique(v.begin(), v.end()), v.end());
+        return v;
+    }
+}
+
+json_input sweep::case_specs(const json_input& base, double nli_threshold, int max_split)
+{
+    // Copy of the input without sweep
+    auto specs = base;
+    specs.sweep = {};
+
+    // Split settings
+    if (specs.algorithm == ALGORITHM::LOADS)
+    {
+        specs.loads.nli_threshold = nli_threshold;
+        std::fill(specs.loads.max_split.begin(), specs.loads.max_split.end(), max_split);
+    }
+    else if (specs.algorithm == ALGORITHM::ADS)
+    {
+        std::fill(specs.ads.max_split.begin(), specs.ads.max_split.end(), max_split);
+    }
+
+    // Final times: the last one is the final time, the rest are epochs
+    if (!base.sweep.final_time.empty())
+    {
+        auto final_times = sweep::sorted_unique(base.sweep.final_time);
+        specs.propagation.final_time = final_times.back();
+        specs.propagation.epochs.assign(final_times.begin(), final_times.end() - 1);
+    }
+
+    return specs;
+}
+
+std::string sweep::case_name(const json_input& case_specs, double final_time)
+{
+    // Maximum split of the case
+    const auto& max_split = case_specs.algorithm == ALGORITHM::LOADS ? case_specs.loads.max_split : case_specs.ads.max_split;
+    int n = max_split.empty() ? 0 : max_split[0];
+
+    return case_specs.algorithm == ALGORITHM::LOADS ?
+           tools::string::print2string("nli_%g_split_%d_tf_%g", case_specs.loads.nli_threshold, n, final_time) :
+           tools::string::print2string("split_%d_tf_%g", n, final_time);
+}
+
+void sweep::run(const json_input& base, const case_callback& on_case)
+{
+    // Auxiliary variables
+    using clock = std::chrono::steady_clock;
+    bool loads = base.algorithm == ALGORITHM::LOADS;
+    const auto& base_max_split = loads ? base.loads.max_split : base.ads.max_split;
+
+    // Values of the sweep, the input ones if not swept
+    auto thresholds = sweep::sorted_unique(base.sweep.nli_threshold.empty() ?
+                                           std::vector<double>{base.loads.nli_threshold} : base.sweep.nli_threshold);
+    auto splits = sweep::sorted_unique(base.sweep.max_split.empty() ?
+                                       std::vector<int>{base_max_split.empty() ? 0 : base_max_split[0]} :
+                                       base.sweep.max_split);
+
+    // Summary
+    std::vector<sweep::summary_entry> entries;
+    double prefix_s = 0.0;
+
+    // Shared prefix: the initial patch, integrated unsplit up to each threshold crossing (only if several thresholds)
+    std::unique_ptr<session> prefix = nullptr;
+    std::unique_ptr<Manifold> root = nullptr;
+    if (loads && thresholds.size() > 1)
+    {
+        // Same first segment as every case
+        auto t0 = clock::now();
+        prefix = std::make_unique<session>(sweep::case_specs(base, thresholds.front(), splits.back()));
+        prefix->prepare();
+        root = std::make_unique<Manifold>(*prefix->get_manifold_fin());
+        prefix_s += std::chrono::duration<double>(clock::now() - t0).count();
+    }
+
+    for (const auto& threshold : thresholds)
+    {
+        // Move the shared patch up to the crossing of this threshold: a zero split limit keeps it unsplit
+        if (prefix)
+        {
+            auto t0 = clock::now();
+            prefix->get_integrator()->set_nli_threshold(threshold);
+            auto advanced = root->getSplitDomain(ALGORITHM::LOADS, 0);
+            root->assign(advanced->begin(), advanced->end());
+            prefix_s += std::chrono::duration<double>(clock::now() - t0).count();
+
+            // Info
+            std::fprintf(stdout, "Sweep: shared patch forked at t = '%.6f' for threshold '%g'.\n",
+                         root->front().t_, threshold);
+        }
+
+        // Cases of this threshold, fewer splits first
+        std::unique_ptr<session> previous = nullptr;
+        int previous_split = 0;
+        for (const auto& split : splits)
+        {
+            // Build
+            auto t0 = clock::now();
+            auto specs = sweep::case_specs(base, threshold, split);
+            auto s = std::make_unique<session>(specs);
+
+            if (previous)
+            {
+                // Continue the first segment of the case with fewer splits: patches stopped at its limit are pending
+                auto first = previous->get_super_manifold()->get_segment(0);
+                auto t_first = previous->get_super_manifold()->get_segment_time(0);
+                Manifold pending;
+                Manifold finished;
+                int split_count = 0;
+                for (auto& p : *first)
+                {
+                    bool stopped = p.get_history_count() == previous_split && p.t_ < t_first;
+                    (stopped ? pending : finished).push_back(p);
+                    split_count = std::max(split_count, p.id_ + 1);
+                }
+                s->propagate_from(pending, finished, split_count);
+            }
+            else if (prefix)
+            {
+                // Continue from the forked shared patch
+                s->propagate_from(*root, Manifold(), 1);
+            }
+            else
+            {
+                // Nothing to reuse
+                s->propagate();
+            }
+
+            double case_s = std::chrono::duration<double>(clock::now() - t0).count();
+
+            // Summary: one entry per final time
+            auto sm = s->get_super_manifold();
+            for (std::size_t k = 0; k < sm->get_segment_count(); k++)
+            {
+                auto t = sm->get_segment_time(k);
+                entries.push_back({sweep::case_name(specs, t), threshold, split, t, sm->get_segment(k)->size(), case_s});
+            }
+
+            // Outputs
+            on_case(specs, *s);
+
+            // Keep it for the next split limit
+            previous = std::move(s);
+            previous_split = split;
+        }
+    }
+
+    // Write summary
+    std::filesystem::create_directories(base.output_dir);
+    auto summary_path = std::filesystem::path(base.output_dir) / "sweep_summary.json";
+    std::ofstream file(summary_path);
+
+    // Safety check
+    if (!file.is_open())
+    {
+        throw std::runtime_error(tools::string::print2string("Sweep: cannot open '%s'.", summary_path.c_str()));
+    }
+
+    file << "{" << std::endl;
+    file << tools::string::print2string("  \"input\": \"%s\",", base.filepath.c_str()) << std::endl;
+    file << tools::string::print2string("  \"shared_prefix_s\": %.6f,", prefix_s) << std::endl;
+    file << "  \"cases\": [" << std::endl;
+    for (std::size_t k = 0; k < entries.size(); k++)
+    {
+        const auto& e = entries[k];
+        file << tools::string::print2string(
+                "    {\"name\": \"%s\", \"nli_threshold\": %.16g, \"max_split\": %d, \"final_time\": %.16g, "
+                "\"patches\": %zu, \"case_s\": %.6f}%s", e.name.c_str(), e.nli_threshold, e.max_split, e.final_time,
+                e.patches, e.case_s, k + 1 < entries.size() ? "," : "") << std::endl;
+    }
+    file << "  ]" << std::endl;
+    file << "}" << std::endl;
+
+    // Info
+    std::fprintf(stdout, "Sweep: '%zu' cases, summary written in '%s'.\n", entries.size(), summary_path.c_str());
+}
@@ -0,0 +1,50 @@
+/**
+ * Parameter sweeps with shared-prefix reuse. The cases of a sweep share the initial conditions, so their work is
+ * organized as a tree:
+ *  - Final times: one propagation per split setting, every final time is a segment of it.
+ *  - NLI thresholds (LOADS): the initial patch is integrated once; at each threshold crossing its state is forked to
+ *    the case of that threshold, while the rest keep integrating it unsplit towards the next threshold.
+ *  - Maximum splits: the case with more splits continues from the first segment of the case with fewer ones, only the
+ *    patches that stopped at the split limit are integrated again.
+ */
+
+#pragma once
+
+// System libraries
+#include <functional>
+
+// Project libraries
+#include "session.h"
+
+namespace sweep
+{
+    /**
+     * Callback called once per split setting, when its propagation has finished. Every final time of the sweep is a
+     * segment of the session.
+     */
+    using case_callback = std::function<void(const json_input& case_specs, session& s)>;
+
+    /**
+     * Specifications of one split setting: threshold, maximum split and segments set from the sweep.
+     * @param base [in] [json_input]
+     * @param nli_threshold [in] [double] ignored if not LOADS
+     * @param max_split [in] [int]
+     * @return json_input
+     */
+    json_input case_specs(const json_input& base, double nli_threshold, int max_split);
+
+    /**
+     * Name of a case, used as its output sub-directory.
+     * @param case_specs [in] [json_input]
+     * @param final_time [in] [double]
+     * @return std::string
+     */
+    std::string case_name(const json_input& case_specs, double final_time);
+
+    /**
+     * Run every case of the sweep and write 'sweep_summary.json' in the output directory of the input.
+     * @param base [in] [json_input] with the sweep section set
+     * @param on_case [in] [case_callback]
+     */
+    void run(const json_input& base, const case_callback& on_case);
+}
@@ -0,0 +1,24 @@
+/**
+ * ARENA: owner of the objects of one run. Namespace dedicated to tools.
+ */
+
+#include "arena.h"
+
+tools::arena::~arena()
+{
+    // Release everything
+    this->release();
+}
+
+void tools::arena::release()
+{
+    // Objects may point to the ones built before them: last built first
+    for (auto it = this->objects_.rbegin(); it != this->objects_.rend(); ++it)
+    {
+        it->second(it->first);
+    }
+    this->objects_.clear();
+
+    // Buffers back
+    this->resource_.release();
+}
@@ -0,0 +1,76 @@
+/**
+ * ARENA: owner of the objects of one run. Namespace dedicated to tools.
+ * @details Objects are built in a monotonic buffer and destroyed all together, in reverse order of creation, when the
+ * arena is released (or destroyed). Meant for the handful of long-lived objects of a run (problem, integrator, super
+ * manifold) that point to each other, so that a process running many scenarios gives every byte back after each one.
+ */
+
+#pragma once
+
+// System libraries
+#include <cstddef>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace tools
+{
+    class arena
+    {
+    public: // Constructors
+
+        /**
+         * Build an empty arena.
+         * @param initial_size [in] [std::size_t] size of the first buffer, in bytes
+         */
+        explicit arena(std::size_t initial_size = 4096) : resource_(initial_size) {};
+
+        /**
+         * Destructor, releases every object.
+         */
+        ~arena();
+
+        arena(const arena&) = delete;
+        arena& operator=(const arena&) = delete;
+
+    public: // Methods
+
+        /**
+         * Build an object owned by the arena. It lives until the arena is released.
+         * @tparam T object type
+         * @param args [in] constructor arguments
+         * @return T*
+         */
+        template<typename T, typename... Args>
+        T* make(Args&&... args)
+        {
+            // Storage from the buffer, given back only on release
+            void* storage = this->resource_.allocate(sizeof(T), alignof(T));
+            T* object = new (storage) T(std::forward<Args>(args)...);
+
+            // Remember how to destroy it
+            this->objects_.push_back({object, [](void* p) { static_cast<T*>(p)->~T(); }});
+
+            return object;
+        }
+
+        /**
+         * Destroy every object, last built first, and give the buffers back. The arena can be used again.
+         */
+        void release();
+
+        /**
+         * Number of objects alive.
+         * @return std::size_t
+         */
+        [[nodiscard]] std::size_t size() const { return this->objects_.size(); }
+
+    private: // Attributes
+
+        // Buffers of the objects
+        std::pmr::monotonic_buffer_resource resource_;
+
+        // Objects alive and their destructors, in order of creation
+        std::vector<std::pair<void*, void (*)(void*)>> objects_{};
+    };
+}
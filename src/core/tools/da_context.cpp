@@ -0,0 +1,227 @@
+/**
+ * DA_CONTEXT: execution context of the differential algebra. Namespace dedicated to tools.
+ */
+
+#include "da_context.h"
+
+// System libraries
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// DACE libraries
+#include "dace/config.h"
+#include "dace/dacebase.h"
+
+// Project libraries
+#include "tools/profiler.h"
+#include "tools/str.h"
+
+namespace tools::da_context
+{
+    // Pinned configuration, written only while no worker is alive
+    std::mutex mutex_;
+    algebra pinned_{};
+    bool is_pinned_{false};
+
+    // Workers alive
+    std::atomic<std::size_t> workers_{0};
+}
+
+bool tools::da_context::thread_safe()
+{
+#ifdef WITH_PTHREAD
+    return true;
+#else
+    return false;
+#endif
+}
+
+void tools::da_context::pin(unsigned int order, unsigned int variables)
+{
+    // Lock configuration
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Already initialized with the same algebra: nothing to do
+    if (DACE::DA::isInitialized() && DACE::DA::getMaxOrder() == order && DACE::DA::getMaxVariables() == variables)
+    {
+        pinned_.order = order;
+        pinned_.variables = variables;
+        is_pinned_ = true;
+        return;
+    }
+
+    // Safety check
+    if (workers_ > 0)
+    {
+        throw std::runtime_error(tools::string::print2string(
+                "DA context: cannot initialize DACE with order '%d' and '%d' variables while '%zu' workers are alive.",
+                order, variables, workers_.load()));
+    }
+
+    // Initialize DACE: the epsilon and truncation order of this thread are reset too
+    DACE::DA::init(order, variables);
+    pinned_ = {order, variables, 0.0};
+    is_pinned_ = true;
+}
+
+double tools::da_context::set_eps(double eps)
+{
+    // Lock configuration
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Safety check
+    if (workers_ > 0)
+    {
+        throw std::runtime_error("DA context: cannot change the epsilon while workers are alive.");
+    }
+
+    // Set it here and keep it for the workers
+    pinned_.eps = eps;
+
+    return DACE::DA::setEps(eps);
+}
+
+tools::da_context::algebra tools::da_context::pinned()
+{
+    // Lock configuration
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return pinned_;
+}
+
+std::size_t tools::da_context::workers()
+{
+    return workers_;
+}
+
+void tools::da_context::validate()
+{
+    // Pinned configuration
+    auto config = tools::da_context::pinned();
+
+    // Algebra
+    if (!DACE::DA::isInitialized() || DACE::DA::getMaxOrder() != config.order ||
+        DACE::DA::getMaxVariables() != config.variables)
+    {
+        throw std::runtime_error(tools::string::print2string(
+                "DA context: DACE algebra differs from the pinned one (order '%d', '%d' variables).",
+                config.order, config.variables));
+    }
+
+    // Epsilon: 'setEps' returns the previous value, so it is set back right away
+    double eps = DACE::DA::setEps(config.eps);
+    DACE::DA::setEps(eps);
+    if (eps != config.eps)
+    {
+        throw std::runtime_error(tools::string::print2string(
+                "DA context: epsilon '%g' differs from the pinned one '%g'.", eps, config.eps));
+    }
+
+    // Truncation order
+    if (DACE::DA::getTO() != config.order)
+    {
+        throw std::runtime_error(tools::string::print2string(
+                "DA context: truncation order '%d' left below the algebra order '%d'.", DACE::DA::getTO(),
+                config.order));
+    }
+}
+
+tools::da_context::worker::worker()
+{
+    // Safety checks
+    if (!tools::da_context::thread_safe())
+    {
+        throw std::runtime_error("DA context: DACE was built without 'WITH_PTHREAD', DA cannot be used from several "
+                                 "threads.");
+    }
+
+    if (tools::profiler::enabled())
+    {
+        throw std::runtime_error("DA context: the profiler is not thread-safe, disable it to run workers.");
+    }
+
+    // Lock configuration: no pinning while the worker starts
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!is_pinned_ || !DACE::DA::isInitialized())
+    {
+        throw std::runtime_error("DA context: pin the algebra before starting workers.");
+    }
+
+    // Thread-local DACE state: full truncation order and pinned epsilon
+    daceInitializeThread();
+    DACE::DA::setEps(pinned_.eps);
+
+    // Count it
+    workers_++;
+}
+
+tools::da_context::worker::~worker()
+{
+    // Release thread-local DACE state
+    daceCleanupThread();
+
+    // Uncount it
+    workers_--;
+}
+
+void tools::da_context::parallel_for(std::size_t n, unsigned int n_threads,
+                                     const std::function<void(std::size_t, unsigned int)>& f)
+{
+    // Number of threads
+    if (n_threads == 0)
+    {
+        n_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Work is taken in order by whichever worker is free
+    std::atomic<std::size_t> next{0};
+
+    // First exception
+    std::mutex error_mutex;
+    std::exception_ptr error{};
+
+    // Launch workers
+    std::vector<std::thread> threads;
+    threads.reserve(n_threads);
+    for (unsigned int w = 0; w < n_threads; w++)
+    {
+        threads.emplace_back([&, w]()
+        {
+            try
+            {
+                // DACE state of this thread
+                worker scope{};
+
+                for (auto i = next++; i < n; i = next++)
+                {
+                    f(i, w);
+                }
+            }
+            catch (...)
+            {
+                // Keep the first one and stop the others
+                std::lock_guard<std::mutex> error_lock(error_mutex);
+                if (!error) { error = std::current_exception(); }
+                next = n;
+            }
+        });
+    }
+
+    // Wait for them
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    // Rethrow
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
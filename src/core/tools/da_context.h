@@ -0,0 +1,92 @@
+/**
+ * DA_CONTEXT: execution context of the differential algebra. Namespace dedicated to tools.
+ * @details DACE keeps its configuration in globals: the algebra (order and variables) is shared by every thread, while
+ * the truncation order, the epsilon cutoff and the multiplication scratch are thread-local only if DACE was built with
+ * 'WITH_PTHREAD'. This layer pins the algebra and the epsilon once, from the main thread, and gives every worker thread
+ * its own DACE state initialized from them. Nothing pinned may change while workers are alive.
+ */
+
+#pragma once
+
+// System libraries
+#include <cstddef>
+#include <functional>
+
+// DACE libraries
+#include "dace/dace.h"
+
+namespace tools::da_context
+{
+    /**
+     * Pinned configuration
+     */
+    struct algebra
+    {
+        unsigned int order{};
+        unsigned int variables{};
+        double eps{};
+    };
+
+    /**
+     * Was DACE built with thread-local state ('WITH_PTHREAD')?
+     * @return bool
+     */
+    bool thread_safe();
+
+    /**
+     * Pin the algebra: initialize DACE, unless it is already initialized with the same one. Throws if it has to be
+     * re-initialized while workers are alive, since that would invalidate every DA they hold.
+     * @param order [in] [unsigned int]
+     * @param variables [in] [unsigned int]
+     */
+    void pin(unsigned int order, unsigned int variables);
+
+    /**
+     * Set the epsilon cutoff in the calling thread and pin it for the workers. Throws while workers are alive.
+     * @param eps [in] [double]
+     * @return previous epsilon of the calling thread
+     */
+    double set_eps(double eps);
+
+    /**
+     * Pinned configuration.
+     * @return algebra
+     */
+    algebra pinned();
+
+    /**
+     * Number of workers alive.
+     * @return std::size_t
+     */
+    std::size_t workers();
+
+    /**
+     * Check that the DACE state of the calling thread is the pinned one (algebra, epsilon and full truncation order).
+     * Throws a 'std::runtime_error' describing the first mismatch.
+     */
+    void validate();
+
+    /**
+     * DACE state of a worker thread: to be built at the beginning of the thread, before any DA is created, and
+     * destroyed after the last one is. Throws if DACE is not thread-safe, nothing is pinned or the profiler (not
+     * thread-safe) is enabled.
+     */
+    class worker
+    {
+    public:
+        worker();
+        ~worker();
+
+        worker(const worker&) = delete;
+        worker& operator=(const worker&) = delete;
+    };
+
+    /**
+     * Run 'f(i, w)' for every 'i' in [0, n) on 'n_threads' workers; 'w' is the worker index, to select scratch
+     * objects owned by the caller. The first exception thrown by a worker is rethrown here once all have finished.
+     * @param n [in] [std::size_t]
+     * @param n_threads [in] [unsigned int] 0 for the hardware concurrency
+     * @param f [in] [std::function<void(std::size_t, unsigned int)>]
+     */
+    void parallel_for(std::size_t n, unsigned int n_threads, const std::function<void(std::size_t, unsigned int)>& f);
+}
@@ -56,7 +56,8 @@ std::string tools::enums::DISTRIBUTION2str(DISTRIBUTION distribution)
     // Fill the value...
     result =
             DISTRIBUTION::GAUSSIAN == distribution ? "GAUSSIAN" :
-            DISTRIBUTION::UNIFORM == distribution ? "UNIFORM" : "UNK";
+            DISTRIBUTION::UNIFORM == distribution ? "UNIFORM" :
+            DISTRIBUTION::STRATIFIED == distribution ? "STRATIFIED" : "UNK";
 
     // Check returned value
     if (result == "UNK")
@@ -80,6 +81,8 @@ std::string tools::enums::INTEGRATOR2str(INTEGRATOR integrator)
             INTEGRATOR::STATIC == integrator ? "STATIC" :
             INTEGRATOR::EULER == integrator ? "EULER" :
             INTEGRATOR::RK78 == integrator ? "RK78" :
+            INTEGRATOR::ANALYTIC_KEPLER == integrator ? "ANALYTIC_KEPLER" :
+            INTEGRATOR::TAYLOR == integrator ? "TAYLOR" :
             INTEGRATOR::NA == integrator ? "NA" : "UNK";
 
     // Check returned value
@@ -157,4 +160,75 @@ VELOCITY tools::enums::STATE2VELOCITY(STATE state)
             state == STATE::VZ ? VELOCITY::Z : VELOCITY::NA;
 
     return result;
-}
\ No newline at end of file
+}
+
+std::string tools::enums::PROFILE_SECTION2str(PROFILE_SECTION section)
+{
+    // Value to be returned
+    std::string result;
+
+    // Fill the value...
+    result =
+            PROFILE_SECTION::INTEGRATE          == section ? "integrate" :
+            PROFILE_SECTION::STEP               == section ? "step" :
+            PROFILE_SECTION::CHECK_ADS          == section ? "check_ads_conditions" :
+            PROFILE_SECTION::CHECK_LOADS        == section ? "check_loads_conditions" :
+            PROFILE_SECTION::SPLIT              == section ? "split" :
+            PROFILE_SECTION::COARSEN            == section ? "coarsen" :
+            PROFILE_SECTION::GET_SPLIT_DOMAIN   == section ? "get_split_domain" :
+            PROFILE_SECTION::EVALUATE_DELTAS    == section ? "evaluate_deltas" :
+            PROFILE_SECTION::WRITE_FILES        == section ? "write_files" :
+            PROFILE_SECTION::NA                 == section ? "NA" : "UNK";
+
+    // Check returned value
+    if (result == "UNK")
+    {
+        printf("WARNING: Could not parse PROFILE_SECTION enum. Returning '%s'\n", result.c_str());
+    }
+
+    // Return found value
+    return result;
+}
+
+std::string tools::enums::BUDGET_PRIORITY2str(BUDGET_PRIORITY priority)
+{
+    // Value to be returned
+    std::string result;
+
+    // Fill the value...
+    result =
+            BUDGET_PRIORITY::FIFO   == priority ? "fifo" :
+            BUDGET_PRIORITY::MASS   == priority ? "mass" :
+            BUDGET_PRIORITY::NLI    == priority ? "nli" :
+            BUDGET_PRIORITY::NA     == priority ? "NA" : "UNK";
+
+    // Check returned value
+    if (result == "UNK")
+    {
+        printf("WARNING: Could not parse BUDGET_PRIORITY enum. Returning '%s'\n", result.c_str());
+    }
+
+    // Return found value
+    return result;
+}
+
+std::string tools::enums::SPLIT_MODE2str(SPLIT_MODE mode)
+{
+    // Value to be returned
+    std::string result;
+
+    // Fill the value...
+    result =
+            SPLIT_MODE::SINGLE      == mode ? "single" :
+            SPLIT_MODE::PREDICTIVE  == mode ? "predictive" :
+            SPLIT_MODE::NA          == mode ? "NA" : "UNK";
+
+    // Check returned value
+    if (result == "UNK")
+    {
+        printf("WARNING: Could not parse SPLIT_MODE enum. Returning '%s'\n", result.c_str());
+    }
+
+    // Return found value
+    return result;
+}
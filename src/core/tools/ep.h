@@ -53,4 +53,10 @@ namespace tools::enums
     std::string INTEGRATOR2str(INTEGRATOR integrator);
 
     std::string ALGORITHM2str(ALGORITHM algorithm);
+
+    std::string PROFILE_SECTION2str(PROFILE_SECTION section);
+
+    std::string BUDGET_PRIORITY2str(BUDGET_PRIORITY priority);
+
+    std::string SPLIT_MODE2str(SPLIT_MODE mode);
 };
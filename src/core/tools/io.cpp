@@ -6,6 +6,10 @@
 
 void tools::io::dace::dump_eval_deltas(delta* delta, const std::filesystem::path &file_path, EVAL_TYPE eval_type)
 {
+    // Trace
+    tools::trace::scoped_span trace_span("dump_eval_deltas", "io");
+    trace_span.set_args("\"file\": \"" + file_path.filename().string() + "\"");
+
     // Get directory
     auto out_dir = file_path.parent_path();
 
@@ -37,7 +41,7 @@ void tools::io::dace::dump_eval_deltas(delta* delta, const std::filesystem::path
                        (
                                problem_type == PROBLEM::FREE_TORQUE_MOTION ?
                                delta->get_SuperManifold()->get_att6dof_ini()->wallsPointEvaluationManifold() :
-                               delta->get_SuperManifold()->get_manifold_ini()->wallsPointEvaluationManifold()
+                               delta->get_SuperManifold()->get_manifold_ini().wallsPointEvaluationManifold()
                                )
                        ;
 
@@ -58,7 +62,7 @@ void tools::io::dace::dump_eval_deltas(delta* delta, const std::filesystem::path
                            (
                                    problem_type == PROBLEM::FREE_TORQUE_MOTION ?
                                    delta->get_SuperManifold()->get_att6dof_ini()->centerPointEvaluationManifold() :
-                                   delta->get_SuperManifold()->get_manifold_ini()->centerPointEvaluationManifold()
+                                   delta->get_SuperManifold()->get_manifold_ini().centerPointEvaluationManifold()
                             ):
                 eval_type == EVAL_TYPE::FINAL_DELTA ?
                 *delta->get_eval_deltas_poly() : *delta->get_non_eval_deltas_poly();
@@ -75,8 +79,11 @@ void tools::io::dace::dump_eval_deltas(delta* delta, const std::filesystem::path
 
 void tools::io::dace::dump_splitting_history(delta *delta, const std::filesystem::path &file_path)
 {
+    // Trace
+    tools::trace::scoped_span trace_span("dump_splitting_history", "io");
+
     // Get current manifold
-    auto current_manifold = delta->get_SuperManifold()->current_;
+    auto current_manifold = delta->get_SuperManifold()->get_manifold_fin();
 
     // Get directory
     auto out_dir = file_path.parent_path();
@@ -99,7 +106,7 @@ void tools::io::dace::dump_splitting_history(delta *delta, const std::filesystem
     std::string line2write{};
 
     // Write the header
-    file2write << "PATCH_ID, HISTORY, SPLIT_NLI, BIRTH_TIME, SPLITTING_TIME" << std::endl;
+    file2write << "PATCH_ID, HISTORY, SPLIT_NLI, BIRTH_TIME, SPLITTING_TIME, BUDGET_LIMITED, PROBABILITY_MASS" << std::endl;
     int i = 0;
     for (auto & patch : *current_manifold)
     {
@@ -113,8 +120,9 @@ void tools::io::dace::dump_splitting_history(delta *delta, const std::filesystem
         history = tools::vector::num2string(patch.get_history_int(), ", ", "%3d");
         times = tools::vector::num2string(patch.get_times_doubles(), ", ", "%3.16f");
         nlis = tools::vector::num2string(patch.get_nlis_doubles(), ", ", "%3.16f");
-        line2write = tools::string::print2string( "%3d, %s, %2.16f, %2.16f, %s, %s",
-                                                  i, history.c_str(), patch.nli, patch.t_split_, times.c_str(), nlis.c_str());
+        line2write = tools::string::print2string( "%3d, %s, %2.16f, %2.16f, %s, %s, %d, %.16e",
+                                                  i, history.c_str(), patch.nli, patch.t_split_, times.c_str(), nlis.c_str(),
+                                                  patch.budget_limited_ ? 1 : 0, patch.mass_);
 
         // Write line
         file2write << line2write << std::endl;
@@ -128,13 +136,51 @@ void tools::io::dace::dump_splitting_history(delta *delta, const std::filesystem
 
 }
 
+bool tools::io::dace::dump_weighted_moments(delta *delta, const std::filesystem::path &file_path)
+{
+    // Trace
+    tools::trace::scoped_span trace_span("dump_weighted_moments", "io");
+
+    // Moments of the current manifold
+    auto current_manifold = delta->get_SuperManifold()->get_manifold_fin();
+    DACE::AlgebraicVector<double> mean;
+    std::vector<DACE::AlgebraicVector<double>> covariance;
+    if (!current_manifold->weighted_center_moments(mean, covariance))
+    {
+        return false;
+    }
+
+    // Check that the output path is existing
+    if (!std::filesystem::is_directory(file_path.parent_path()))
+    {
+        std::filesystem::create_directories(file_path.parent_path());
+    }
+
+    // Create the file stream
+    std::ofstream file2write;
+    file2write.open(file_path);
+
+    // Write the header, then one line per variable: mean and its row of the covariance
+    file2write << "VARIABLE, MEAN, COVARIANCE" << std::endl;
+    for (std::size_t k = 0; k < mean.size(); k++)
+    {
+        auto row = tools::vector::num2string(covariance[k], ", ", "%.16e");
+        file2write << tools::string::print2string("%3zu, %.16e, %s", k, mean[k], row.c_str()) << std::endl;
+    }
+
+    // Close file
+    file2write.close();
+
+    return true;
+}
+
 void tools::io::dace::print_manifold_evolution(delta* delta, const std::filesystem::path &dir_path, EVAL_TYPE eval_type)
 {
     // Auxiliary variable
     std::filesystem::path file_path{};
 
     // From each manifold, print centers, walls and deltas if available
-    auto domain_record =  eval_type == EVAL_TYPE::INITIAL_WALLS ? delta->get_SuperManifold()->get_manifold_fin()->get_ini_domain_record() :
+    auto& domain_record =  eval_type == EVAL_TYPE::INITIAL_WALLS ? delta->get_SuperManifold()->get_manifold_fin()->get_ini_domain_record() :
                           delta->get_SuperManifold()->get_manifold_fin()->get_fin_domain_record();
 
     // Check directory exists
@@ -145,12 +191,12 @@ void tools::io::dace::print_manifold_evolution(delta* delta, const std::filesyst
     }
 
     // Iterate through every domain record
-    for (unsigned int i = 0; i < domain_record->size(); i++)
+    for (unsigned int i = 0; i < domain_record.size(); i++)
     {
         // Evaluate walls
         auto intermediate_manifold_patches =
-                eval_type == EVAL_TYPE::INITIAL_WALLS ? domain_record->at(i)->get_initial_split_domain()->wallsPointEvaluationManifold() :
-                domain_record->at(i)->wallsPointEvaluationManifold() ;
+                eval_type == EVAL_TYPE::INITIAL_WALLS ? domain_record.at(i).get_initial_split_domain().wallsPointEvaluationManifold() :
+                domain_record.at(i).wallsPointEvaluationManifold() ;
 
         // Build file path from dir
         file_path = dir_path / tools::string::print2string("%s_eval_walls-%06d.walls", eval_type == EVAL_TYPE::INITIAL_WALLS ? "ini" : "fin", i);
@@ -36,6 +36,15 @@ namespace tools::io::dace
     */
     void dump_splitting_history(delta* delta, const std::filesystem::path &file_path);
 
+    /**
+     * Dump the mean and covariance of the final centers weighted by the probability mass of their patch. Nothing is
+     * written if the patches have not been weighted.
+     * @param delta [in] [delta]
+     * @param file_path [in] [std::filesystem::path]
+     * @return true if written
+     */
+    bool dump_weighted_moments(delta* delta, const std::filesystem::path &file_path);
+
     /**
      * Print all the evolution (evolution of manifolds)
      * @param delta [in] [delta*]
@@ -0,0 +1,78 @@
+/**
+ * IO BINARY: compact binary (de)serialization helpers. Namespace dedicated to tools.
+ */
+
+#include "io_binary.h"
+
+void tools::io::binary::write_string(std::ostream& os, const std::string& s)
+{
+    tools::io::binary::write_vector(os, std::vector<char>(s.begin(), s.end()));
+}
+
+std::string tools::io::binary::read_string(std::istream& is)
+{
+    auto v = tools::io::binary::read_vector<char>(is);
+    return {v.begin(), v.end()};
+}
+
+void tools::io::binary::write_da_vector(std::ostream& os, const DACE::AlgebraicVector<DACE::DA>& v)
+{
+    // Auxiliary variables
+    auto nvar = DACE::DA::getMaxVariables();
+    DACE::Monomial m;
+
+    // Header: components and variables
+    tools::io::binary::write<std::uint32_t>(os, v.size());
+    tools::io::binary::write<std::uint32_t>(os, nvar);
+
+    for (const auto& da : v)
+    {
+        // Number of non-zero monomials
+        tools::io::binary::write<std::uint32_t>(os, da.size());
+
+        for (unsigned int k = 1; k <= da.size(); k++)
+        {
+            // Exponents (order is always far below 256) and coefficient
+            da.getMonomial(k, m);
+            for (unsigned int j = 0; j < nvar; j++)
+            {
+                tools::io::binary::write<std::uint8_t>(os, m.m_jj[j]);
+            }
+            tools::io::binary::write<double>(os, m.m_coeff);
+        }
+    }
+}
+
+DACE::AlgebraicVector<DACE::DA> tools::io::binary::read_da_vector(std::istream& is)
+{
+    // Header
+    auto n_comp = tools::io::binary::read<std::uint32_t>(is);
+    auto nvar = tools::io::binary::read<std::uint32_t>(is);
+
+    // Safety check
+    if (nvar != DACE::DA::getMaxVariables())
+    {
+        throw std::runtime_error(tools::string::print2string(
+                "tools::io::binary::read_da_vector: stored DA has '%d' variables but DACE was initialized with '%d'.",
+                nvar, DACE::DA::getMaxVariables()));
+    }
+
+    // Result to be returned
+    DACE::AlgebraicVector<DACE::DA> result(n_comp);
+    std::vector<unsigned int> jj(nvar);
+
+    for (std::uint32_t i = 0; i < n_comp; i++)
+    {
+        auto n_mono = tools::io::binary::read<std::uint32_t>(is);
+        for (std::uint32_t k = 0; k < n_mono; k++)
+        {
+            for (std::uint32_t j = 0; j < nvar; j++)
+            {
+                jj[j] = tools::io::binary::read<std::uint8_t>(is);
+            }
+            result[i].setCoefficient(jj, tools::io::binary::read<double>(is));
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,93 @@
+/**
+ * IO BINARY: compact binary (de)serialization helpers. Namespace dedicated to tools.
+ * @details Native endianness, meant for checkpoints and caches read back by the same build. Every read throws
+ * std::runtime_error on a truncated stream.
+ */
+
+#pragma once
+
+// System libraries
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// DACE libraries
+#include "dace/dace.h"
+
+// Project libraries
+#include "tools/str.h"
+
+namespace tools::io::binary
+{
+    /**
+     * Write a trivially copyable value.
+     * @tparam T [in] [template]
+     * @param os [in] [std::ostream]
+     * @param value [in] [T]
+     */
+    template<typename T>
+    void write(std::ostream& os, const T& value);
+
+    /**
+     * Read a trivially copyable value.
+     * @tparam T [in] [template]
+     * @param is [in] [std::istream]
+     * @return T
+     */
+    template<typename T>
+    T read(std::istream& is);
+
+    /**
+     * Write a vector of trivially copyable values, prefixed by its size.
+     * @tparam T [in] [template]
+     * @param os [in] [std::ostream]
+     * @param v [in] [std::vector<T>]
+     */
+    template<typename T>
+    void write_vector(std::ostream& os, const std::vector<T>& v);
+
+    /**
+     * Read a vector written by 'write_vector'.
+     * @tparam T [in] [template]
+     * @param is [in] [std::istream]
+     * @return std::vector<T>
+     */
+    template<typename T>
+    std::vector<T> read_vector(std::istream& is);
+
+    /**
+     * Write a string, prefixed by its size.
+     * @param os [in] [std::ostream]
+     * @param s [in] [std::string]
+     */
+    void write_string(std::ostream& os, const std::string& s);
+
+    /**
+     * Read a string written by 'write_string'.
+     * @param is [in] [std::istream]
+     * @return std::string
+     */
+    std::string read_string(std::istream& is);
+
+    /**
+     * Write a DA vector sparsely: per component, the number of non-zero monomials and then each monomial as its
+     * exponents (one byte per variable) and its coefficient.
+     * @param os [in] [std::ostream]
+     * @param v [in] [DACE::AlgebraicVector<DACE::DA>]
+     */
+    void write_da_vector(std::ostream& os, const DACE::AlgebraicVector<DACE::DA>& v);
+
+    /**
+     * Read a DA vector written by 'write_da_vector'. DACE must be initialized with the same number of variables.
+     * @param is [in] [std::istream]
+     * @return DACE::AlgebraicVector<DACE::DA>
+     */
+    DACE::AlgebraicVector<DACE::DA> read_da_vector(std::istream& is);
+}
+
+// Include templates implementation
+#include "io_binary_temp.cpp"
@@ -0,0 +1,57 @@
+/**
+ * IO BINARY: compact binary (de)serialization helpers. Namespace dedicated to tools. -> Templates place
+ */
+
+template<typename T>
+void tools::io::binary::write(std::ostream& os, const T& value)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be written.");
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+T tools::io::binary::read(std::istream& is)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be read.");
+
+    // Value to be returned
+    T value{};
+    is.read(reinterpret_cast<char*>(&value), sizeof(T));
+
+    // Safety check
+    if (!is)
+    {
+        throw std::runtime_error("tools::io::binary::read: unexpected end of stream.");
+    }
+
+    return value;
+}
+
+template<typename T>
+void tools::io::binary::write_vector(std::ostream& os, const std::vector<T>& v)
+{
+    tools::io::binary::write<std::uint64_t>(os, v.size());
+    if (!v.empty())
+    {
+        os.write(reinterpret_cast<const char*>(v.data()), (std::streamsize) (v.size() * sizeof(T)));
+    }
+}
+
+template<typename T>
+std::vector<T> tools::io::binary::read_vector(std::istream& is)
+{
+    // Get size and fill
+    std::vector<T> v(tools::io::binary::read<std::uint64_t>(is));
+    if (!v.empty())
+    {
+        is.read(reinterpret_cast<char*>(v.data()), (std::streamsize) (v.size() * sizeof(T)));
+    }
+
+    // Safety check
+    if (!is)
+    {
+        throw std::runtime_error("tools::io::binary::read_vector: unexpected end of stream.");
+    }
+
+    return v;
+}
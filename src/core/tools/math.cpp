@@ -16,6 +16,10 @@
 
 #include "tools/math.h"
 
+// System libraries
+#include <algorithm>
+#include <cmath>
+
 std::vector<int> tools::math::range(const int a, const int b, const int s) {
     std::vector<int> r((b - a) / s);
     for (int i = 0; i < r.size(); i++) {
@@ -26,4 +30,93 @@ std::vector<int> tools::math::range(const int a, const int b, const int s) {
 
 std::vector<std::vector<double>> tools::math::hypercubeEdges(const int ndim, const int ns, const std::vector<int>& sweep, const std::vector<bool>& path) {
     return tools::math::hypercubeEdges2(-1.0, 1.0, ndim, ns, sweep, path);
-}
\ No newline at end of file
+}
+
+double tools::math::normal_cdf(const double x) {
+    // Complementary error function: accurate in the lower tail too
+    return 0.5 * std::erfc(-x / std::sqrt(2.0));
+}
+
+double tools::math::normal_quantile(const double p) {
+    // Limits
+    if (p <= 0.0) {
+        return -INFINITY;
+    }
+    if (p >= 1.0) {
+        return INFINITY;
+    }
+
+    // Rational approximation of Acklam, relative error below 1.15e-9
+    const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                        1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                        6.680131188771972e+01, -1.328068155288572e+01};
+    const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                        -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                        3.754408661907416e+00};
+    const double p_low = 0.02425;
+
+    double x;
+    if (p < p_low) {
+        // Lower tail
+        double q = std::sqrt(-2.0 * std::log(p));
+        x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+            ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    } else if (p <= 1.0 - p_low) {
+        // Central region
+        double q = p - 0.5;
+        double r = q * q;
+        x = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+            (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+    } else {
+        // Upper tail
+        double q = std::sqrt(-2.0 * std::log(1.0 - p));
+        x = -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+            ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+
+    // One Halley step to full double precision
+    double e = tools::math::normal_cdf(x) - p;
+    double u = e * std::sqrt(2.0 * M_PI) * std::exp(0.5 * x * x);
+    return x - u / (1.0 + 0.5 * x * u);
+}
+
+double tools::math::truncated_normal(const double a, const double b, const double u) {
+    // Upper half: mirror it, so that the probabilities are taken from the accurate lower tail
+    if (a > 0.0) {
+        return -tools::math::truncated_normal(-b, -a, 1.0 - u);
+    }
+
+    // Invert the cumulative distribution function between the limits
+    double p_a = tools::math::normal_cdf(a);
+    double p_b = tools::math::normal_cdf(b);
+    double x = tools::math::normal_quantile(p_a + u * (p_b - p_a));
+
+    // Round-off may leave it just outside
+    return std::clamp(x, a, b);
+}
+
+void tools::math::truncated_normal_moments(const double a, const double b, double &mean, double &variance) {
+    // Upper half: mirror it, so that the probabilities are taken from the accurate lower tail
+    if (a > 0.0) {
+        tools::math::truncated_normal_moments(-b, -a, mean, variance);
+        mean = -mean;
+        return;
+    }
+
+    // Mass between the limits
+    double z = tools::math::normal_cdf(b) - tools::math::normal_cdf(a);
+    if (!(z > 1e-300)) {
+        mean = 0.5 * (a + b);
+        variance = (b - a) * (b - a) / 12.0;
+        return;
+    }
+
+    // Density at the limits
+    double pdf_a = std::exp(-0.5 * a * a) / std::sqrt(2.0 * M_PI);
+    double pdf_b = std::exp(-0.5 * b * b) / std::sqrt(2.0 * M_PI);
+
+    mean = (pdf_a - pdf_b) / z;
+    variance = std::max(0.0, 1.0 + (a * pdf_a - b * pdf_b) / z - mean * mean);
+}
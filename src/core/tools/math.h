@@ -106,6 +106,39 @@ namespace tools::math {
      */
     template<typename T>
     int sgn(T val);
+
+    /**
+     * Cumulative distribution function of the standard normal distribution.
+     * @param x abscissa
+     * @return P(X <= x)
+     */
+    double normal_cdf(double x);
+
+    /**
+     * Quantile (inverse of the cumulative distribution function) of the standard normal distribution.
+     * @param p probability in (0, 1)
+     * @return x such that P(X <= x) = p
+     */
+    double normal_quantile(double p);
+
+    /**
+     * Sample of the standard normal distribution truncated to [a, b], by inversion.
+     * @param a lower limit
+     * @param b upper limit
+     * @param u uniform sample in [0, 1)
+     * @return sample in [a, b]
+     */
+    double truncated_normal(double a, double b, double u);
+
+    /**
+     * Mean and variance of the standard normal distribution truncated to [a, b]. Falls back to the uniform ones if
+     * the interval holds no mass in double precision.
+     * @param a lower limit
+     * @param b upper limit
+     * @param mean [out] mean
+     * @param variance [out] variance
+     */
+    void truncated_normal_moments(double a, double b, double &mean, double &variance);
 }
 
 
@@ -46,6 +46,73 @@ std::vector<std::string> mex_aux::convertMatlabStrVector2NormalStrVector(const m
     return result;
 }
 
+matlab::data::TypedArray<uint32_t> mex_aux::packMonomialExponents(matlab::data::ArrayFactory& factory)
+{
+    // Get basis
+    const auto& exponents = tools::vector::monomial_exponents();
+    auto n_mono = tools::vector::monomial_count();
+    std::size_t nvar = DACE::DA::getMaxVariables();
+
+    // Fill buffer: both are column-major
+    auto buffer = factory.createBuffer<uint32_t>(exponents.size());
+    std::copy(exponents.begin(), exponents.end(), buffer.get());
+
+    return factory.createArrayFromBuffer<uint32_t>({nvar, n_mono}, std::move(buffer));
+}
+
+matlab::data::TypedArray<double> mex_aux::packDAVectors(matlab::data::ArrayFactory& factory,
+                                                        const std::vector<DACE::AlgebraicVector<DACE::DA>>& vectors)
+{
+    // Auxiliary variables
+    auto n_mono = tools::vector::monomial_count();
+    std::size_t n_comp = vectors.empty() ? 0 : vectors[0].size();
+
+    // Pack every vector straight into the MATLAB buffer
+    auto buffer = factory.createBuffer<double>(n_mono * n_comp * vectors.size());
+    for (std::size_t j = 0; j < vectors.size(); j++)
+    {
+        tools::vector::pack_coefficients(vectors[j], buffer.get() + j * n_mono * n_comp);
+    }
+
+    return factory.createArrayFromBuffer<double>({n_mono, n_comp, vectors.size()}, std::move(buffer));
+}
+
+std::vector<DACE::AlgebraicVector<DACE::DA>> mex_aux::unpackDAVectors(const matlab::data::TypedArray<double>& coeffs,
+                                                                      const matlab::data::TypedArray<uint32_t>& exponents)
+{
+    // Dimensions
+    auto dims = coeffs.getDimensions();
+    std::size_t n_mono = dims[0];
+    std::size_t n_comp = dims.size() > 1 ? dims[1] : 1;
+    std::size_t n_vectors = dims.size() > 2 ? dims[2] : 1;
+
+    // Copy to contiguous memory: MATLAB arrays are column-major
+    std::vector<double> coeffs_v(coeffs.begin(), coeffs.end());
+    std::vector<unsigned int> exponents_v(exponents.begin(), exponents.end());
+
+    // Safety check
+    if (!exponents_v.empty() && exponents_v.size() != n_mono * DACE::DA::getMaxVariables())
+    {
+        throw std::runtime_error("unpackDAVectors: exponents must be [n_var x n_mono].");
+    }
+    if (exponents_v.empty() && n_mono != tools::vector::monomial_count())
+    {
+        throw std::runtime_error("unpackDAVectors: coefficients do not match the current algebra.");
+    }
+
+    // Unpack
+    std::vector<DACE::AlgebraicVector<DACE::DA>> result;
+    result.reserve(n_vectors);
+    for (std::size_t j = 0; j < n_vectors; j++)
+    {
+        result.push_back(tools::vector::unpack_coefficients(coeffs_v.data() + j * n_mono * n_comp, n_comp,
+                                                            exponents_v.empty() ? nullptr : exponents_v.data(),
+                                                            n_mono));
+    }
+
+    return result;
+}
+
 /*
 void mex_aux::checkArguments(matlab::mex::ArgumentList outputs, matlab::mex::ArgumentList inputs, MEX_FILE_TYPE type)
 {
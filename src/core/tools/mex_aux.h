@@ -16,6 +16,7 @@
 
 // Project libraries
 #include "tools/str.h"
+#include "tools/vo.h"
 #include "base/enums.h"
 
 namespace mex_aux
@@ -80,6 +81,32 @@ namespace mex_aux
     // void checkArguments(matlab::mex::ArgumentList outputs, matlab::mex::ArgumentList inputs, MEX_FILE_TYPE type);
     std::vector<std::string>
     convertMatlabStrVector2NormalStrVector(const matlab::data::TypedArray<matlab::data::MATLABString> &str2convert);
+
+    /**
+     * Monomial exponents of the current algebra as a MATLAB array.
+     * @param factory [in] [matlab::data::ArrayFactory]
+     * @return matlab::data::TypedArray<uint32_t> [n_var x n_mono]
+     */
+    matlab::data::TypedArray<uint32_t> packMonomialExponents(matlab::data::ArrayFactory& factory);
+
+    /**
+     * Pack DA vectors (i.e., the patches of a manifold) into a single numeric array, built in place so that it
+     * crosses the MEX boundary without any further copy.
+     * @param factory [in] [matlab::data::ArrayFactory]
+     * @param vectors [in] [std::vector<DACE::AlgebraicVector<DACE::DA>>]
+     * @return matlab::data::TypedArray<double> [n_mono x n_comp x n_vectors]
+     */
+    matlab::data::TypedArray<double> packDAVectors(matlab::data::ArrayFactory& factory,
+                                                   const std::vector<DACE::AlgebraicVector<DACE::DA>>& vectors);
+
+    /**
+     * Unpack DA vectors from a numeric array.
+     * @param coeffs [in] [matlab::data::TypedArray<double>] [n_mono x n_comp (x n_vectors)]
+     * @param exponents [in] [matlab::data::TypedArray<uint32_t>] [n_var x n_mono], empty for the default basis
+     * @return std::vector<DACE::AlgebraicVector<DACE::DA>>
+     */
+    std::vector<DACE::AlgebraicVector<DACE::DA>> unpackDAVectors(const matlab::data::TypedArray<double>& coeffs,
+                                                                 const matlab::data::TypedArray<uint32_t>& exponents);
 }
 
 // Include template
@@ -0,0 +1,141 @@
+/**
+ * PROFILER: hot-path instrumentation. Namespace dedicated to tools.
+ */
+
+#include "profiler.h"
+
+// System libraries
+#include <fstream>
+
+// Project libraries
+#include "tools/ep.h"
+#include "tools/str.h"
+
+namespace tools::profiler
+{
+    // Global flag
+    bool enabled_ = false;
+
+    // Records
+    section_stats sections_[(int) PROFILE_SECTION::NA + 1]{};
+    std::vector<patch_stats> patches_{};
+
+    // Current patch
+    patch_stats current_{};
+    clock::time_point current_start_{};
+    bool current_open_{false};
+}
+
+void tools::profiler::set_enabled(bool enabled)
+{
+    enabled_ = enabled;
+}
+
+void tools::profiler::reset()
+{
+    // Clear sections
+    for (auto& s : sections_) { s = section_stats{}; }
+
+    // Clear patches
+    patches_.clear();
+    current_open_ = false;
+}
+
+void tools::profiler::add(PROFILE_SECTION section, double dt)
+{
+    // Accumulate
+    auto& s = sections_[(int) section];
+    s.calls++;
+    s.total_s += dt;
+    s.max_s = std::max(s.max_s, dt);
+}
+
+void tools::profiler::begin_patch(int id, double t0)
+{
+    // Cheap exit
+    if (!enabled_) { return; }
+
+    // Snapshot counters so that the patch gets only its own ones
+    current_ = patch_stats{};
+    current_.id = id;
+    current_.t0 = t0;
+    current_.steps = sections_[(int) PROFILE_SECTION::STEP].calls;
+    current_.checks = sections_[(int) PROFILE_SECTION::CHECK_ADS].calls +
+                      sections_[(int) PROFILE_SECTION::CHECK_LOADS].calls;
+    current_start_ = clock::now();
+    current_open_ = true;
+}
+
+void tools::profiler::end_patch(double t1, double nli, std::size_t monomials, bool split)
+{
+    // Cheap exit
+    if (!enabled_ || !current_open_) { return; }
+
+    // Close record
+    current_.t1 = t1;
+    current_.wall_s = std::chrono::duration<double>(clock::now() - current_start_).count();
+    current_.steps = sections_[(int) PROFILE_SECTION::STEP].calls - current_.steps;
+    current_.checks = sections_[(int) PROFILE_SECTION::CHECK_ADS].calls +
+                      sections_[(int) PROFILE_SECTION::CHECK_LOADS].calls - current_.checks;
+    current_.nli = nli;
+    current_.monomials = monomials;
+    current_.split = split;
+
+    // Save it
+    patches_.push_back(current_);
+    current_open_ = false;
+}
+
+tools::profiler::section_stats tools::profiler::get_section(PROFILE_SECTION section)
+{
+    return sections_[(int) section];
+}
+
+const std::vector<tools::profiler::patch_stats>& tools::profiler::get_patches()
+{
+    return patches_;
+}
+
+void tools::profiler::dump(const std::filesystem::path& file_path)
+{
+    // Open file
+    std::ofstream file(file_path);
+
+    // Safety check
+    if (!file.is_open())
+    {
+        std::fprintf(stderr, "Profiler: could not open '%s' to dump the profile.\n", file_path.c_str());
+        return;
+    }
+
+    // Sections
+    file << "{" << std::endl;
+    file << "  \"sections\": {" << std::endl;
+    for (int k = 0; k < (int) PROFILE_SECTION::NA; k++)
+    {
+        const auto& s = sections_[k];
+        file << tools::string::print2string(
+                "    \"%s\": {\"calls\": %lu, \"total_s\": %.9f, \"mean_us\": %.6f, \"max_us\": %.6f}%s",
+                tools::enums::PROFILE_SECTION2str((PROFILE_SECTION) k).c_str(), (unsigned long) s.calls, s.total_s,
+                s.calls > 0 ? s.total_s / (double) s.calls * 1e6 : 0.0, s.max_s * 1e6,
+                k + 1 < (int) PROFILE_SECTION::NA ? "," : "") << std::endl;
+    }
+    file << "  }," << std::endl;
+
+    // Patches
+    file << "  \"patches\": [" << std::endl;
+    for (std::size_t k = 0; k < patches_.size(); k++)
+    {
+        const auto& p = patches_[k];
+        file << tools::string::print2string(
+                "    {\"id\": %d, \"t0\": %.16f, \"t1\": %.16f, \"steps\": %lu, \"checks\": %lu, \"wall_s\": %.9f, "
+                "\"nli\": %.16f, \"monomials\": %zu, \"split\": %s}%s",
+                p.id, p.t0, p.t1, (unsigned long) p.steps, (unsigned long) p.checks, p.wall_s, p.nli, p.monomials,
+                p.split ? "true" : "false", k + 1 < patches_.size() ? "," : "") << std::endl;
+    }
+    file << "  ]" << std::endl;
+    file << "}" << std::endl;
+
+    // Info
+    std::fprintf(stdout, "Profiler: profile dumped in '%s'.\n", file_path.c_str());
+}
@@ -0,0 +1,148 @@
+/**
+ * PROFILER: hot-path instrumentation. Namespace dedicated to tools.
+ * @details Scoped timers and call counters per engine section plus per-patch statistics. Everything is a single
+ * branch on a global flag when disabled (default).
+ */
+
+#pragma once
+
+// System libraries
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+// Project libraries
+#include "base/enums.h"
+
+// Helpers to build unique variable names
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+// Time the enclosing scope
+#define PROFILE_SCOPE(section) tools::profiler::scoped_timer PROFILE_CONCAT(profile_scope_, __LINE__)(section)
+
+namespace tools::profiler
+{
+    // Clock to be used
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * Accumulated statistics of a section
+     */
+    struct section_stats
+    {
+        std::uint64_t calls{};
+        double total_s{};
+        double max_s{};
+    };
+
+    /**
+     * Statistics of a single patch integration (one call to integrator::integrate)
+     */
+    struct patch_stats
+    {
+        int id{-1};
+        double t0{};
+        double t1{};
+        std::uint64_t steps{};
+        std::uint64_t checks{};
+        double wall_s{};
+        double nli{};
+        std::size_t monomials{};
+        bool split{false};
+    };
+
+    // Global flag, read it through 'enabled()'
+    extern bool enabled_;
+
+    /**
+     * Is the profiler enabled?
+     * @return bool
+     */
+    inline bool enabled() { return enabled_; }
+
+    /**
+     * Enable or disable the profiler.
+     * @param enabled [in] [bool]
+     */
+    void set_enabled(bool enabled);
+
+    /**
+     * Clear every record.
+     */
+    void reset();
+
+    /**
+     * Add a measurement to a section.
+     * @param section [in] [PROFILE_SECTION]
+     * @param dt [in] [double] seconds
+     */
+    void add(PROFILE_SECTION section, double dt);
+
+    /**
+     * Start recording the integration of a patch.
+     * @param id [in] [int]
+     * @param t0 [in] [double]
+     */
+    void begin_patch(int id, double t0);
+
+    /**
+     * Finish recording the integration of the current patch.
+     * @param t1 [in] [double] time reached
+     * @param nli [in] [double] last NLI computed
+     * @param monomials [in] [std::size_t] monomials of the resulting DA vector
+     * @param split [in] [bool] whether the integration was interrupted to split
+     */
+    void end_patch(double t1, double nli, std::size_t monomials, bool split);
+
+    /**
+     * Get statistics of a section.
+     * @param section [in] [PROFILE_SECTION]
+     * @return section_stats
+     */
+    section_stats get_section(PROFILE_SECTION section);
+
+    /**
+     * Get per-patch statistics.
+     * @return std::vector<patch_stats>
+     */
+    const std::vector<patch_stats>& get_patches();
+
+    /**
+     * Dump the profile in JSON format.
+     * @param file_path [in] [std::filesystem::path]
+     */
+    void dump(const std::filesystem::path& file_path);
+
+    /**
+     * Times its own life, only when the profiler is enabled.
+     */
+    class scoped_timer
+    {
+    public:
+        explicit scoped_timer(PROFILE_SECTION section) : section_(section), active_(enabled_)
+        {
+            if (this->active_) { this->start_ = clock::now(); }
+        }
+
+        ~scoped_timer() { this->stop(); }
+
+        /**
+         * Stop the timer before the end of the scope.
+         */
+        void stop()
+        {
+            if (this->active_)
+            {
+                add(this->section_, std::chrono::duration<double>(clock::now() - this->start_).count());
+                this->active_ = false;
+            }
+        }
+
+    private:
+        PROFILE_SECTION section_;
+        bool active_;
+        clock::time_point start_{};
+    };
+}
@@ -33,7 +33,7 @@ std::string tools::string::print2string(const std::string &fmt_str, ...)
     va_start(ap, fmt_str);
     vasprintf(&fp, fmt_str.c_str(), ap);
     va_end(ap);
-    std::unique_ptr<char[]> formatted(fp);
+    std::unique_ptr<char, decltype(&std::free)> formatted(fp, &std::free);
     std::string message = std::string(formatted.get());
     return message;
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include <string>
 #include <vector>
 #include <cstdarg>
+#include <cstdlib>
 #include <memory>
 #include <algorithm>
 
@@ -0,0 +1,121 @@
+/**
+ * TRACER: timeline export of a run in the Trace Event Format. Namespace dedicated to tools.
+ */
+
+#include "tracer.h"
+
+// System libraries
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Project libraries
+#include "tools/str.h"
+
+namespace tools::trace
+{
+    // Global flag
+    bool enabled_ = false;
+
+    // Records
+    std::mutex mutex_;
+    std::vector<std::string> events_{};
+    std::filesystem::path file_path_{};
+    clock::time_point origin_{};
+    bool atexit_registered_{false};
+
+    // Microseconds since the trace was opened
+    double micros(clock::time_point t)
+    {
+        return std::chrono::duration<double, std::micro>(t - origin_).count();
+    }
+
+    // Thread identifier, small so that the viewer shows one row per thread
+    unsigned long thread_id()
+    {
+        return (unsigned long) (std::hash<std::thread::id>{}(std::this_thread::get_id()) % 100000);
+    }
+}
+
+void tools::trace::open(const std::filesystem::path& file_path)
+{
+    // Lock
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Start recording
+    file_path_ = file_path;
+    events_.clear();
+    origin_ = clock::now();
+    enabled_ = true;
+
+    // Write the trace even if the program exits abruptly (std::exit)
+    if (!atexit_registered_)
+    {
+        std::atexit([]() { tools::trace::close(); });
+        atexit_registered_ = true;
+    }
+}
+
+void tools::trace::close()
+{
+    // Lock
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Nothing to be done
+    if (!enabled_) { return; }
+
+    // Stop recording
+    enabled_ = false;
+
+    // Open file
+    std::ofstream file(file_path_);
+
+    // Safety check
+    if (!file.is_open())
+    {
+        std::fprintf(stderr, "Tracer: could not open '%s' to write the trace.\n", file_path_.c_str());
+        return;
+    }
+
+    // Write events
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [" << std::endl;
+    for (std::size_t k = 0; k < events_.size(); k++)
+    {
+        file << events_[k] << (k + 1 < events_.size() ? "," : "") << std::endl;
+    }
+    file << "]}" << std::endl;
+
+    // Info
+    std::fprintf(stdout, "Tracer: %zu events written in '%s'.\n", events_.size(), file_path_.c_str());
+    events_.clear();
+}
+
+void tools::trace::complete(const std::string& name, const std::string& category, clock::time_point start,
+                            clock::time_point end, const std::string& args)
+{
+    // Build event
+    auto event = tools::string::print2string(
+            "{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, "
+            "\"tid\": %lu, \"args\": {%s}}",
+            name.c_str(), category.c_str(), micros(start), micros(end) - micros(start), thread_id(), args.c_str());
+
+    // Lock and save
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (enabled_) { events_.push_back(event); }
+}
+
+void tools::trace::instant(const std::string& name, const std::string& category, const std::string& args)
+{
+    // Build event
+    auto event = tools::string::print2string(
+            "{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"i\", \"s\": \"t\", \"ts\": %.3f, \"pid\": 1, "
+            "\"tid\": %lu, \"args\": {%s}}",
+            name.c_str(), category.c_str(), micros(clock::now()), thread_id(), args.c_str());
+
+    // Lock and save
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (enabled_) { events_.push_back(event); }
+}
@@ -0,0 +1,88 @@
+/**
+ * TRACER: timeline export of a run in the Trace Event Format (chrome://tracing, Perfetto). Namespace dedicated to
+ * tools.
+ * @details Events are buffered in memory and written when the trace is closed (or at exit). Nothing is recorded
+ * while no trace file is open, every probe is a single branch on a global flag then.
+ */
+
+#pragma once
+
+// System libraries
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+namespace tools::trace
+{
+    // Clock to be used
+    using clock = std::chrono::steady_clock;
+
+    // Global flag, read it through 'enabled()'
+    extern bool enabled_;
+
+    /**
+     * Is a trace open?
+     * @return bool
+     */
+    inline bool enabled() { return enabled_; }
+
+    /**
+     * Open a trace: events will be recorded from now on and written to the given file when closed.
+     * @param file_path [in] [std::filesystem::path]
+     */
+    void open(const std::filesystem::path& file_path);
+
+    /**
+     * Write the recorded events and stop recording.
+     */
+    void close();
+
+    /**
+     * Record a complete event (span).
+     * @param name [in] [std::string]
+     * @param category [in] [std::string]
+     * @param start [in] [clock::time_point]
+     * @param end [in] [clock::time_point]
+     * @param args [in] [std::string] JSON object members, i.e. "\"id\": 3, \"nli\": 0.1" (may be empty)
+     */
+    void complete(const std::string& name, const std::string& category, clock::time_point start,
+                  clock::time_point end, const std::string& args = "");
+
+    /**
+     * Record an instant event.
+     * @param name [in] [std::string]
+     * @param category [in] [std::string]
+     * @param args [in] [std::string] JSON object members (may be empty)
+     */
+    void instant(const std::string& name, const std::string& category, const std::string& args = "");
+
+    /**
+     * Records a span covering its own life, only when a trace is open.
+     */
+    class scoped_span
+    {
+    public:
+        scoped_span(const char* name, const char* category) : name_(name), category_(category), active_(enabled_)
+        {
+            if (this->active_) { this->start_ = clock::now(); }
+        }
+
+        ~scoped_span()
+        {
+            if (this->active_) { complete(this->name_, this->category_, this->start_, clock::now(), this->args_); }
+        }
+
+        /**
+         * Set the span arguments, shown by the viewer.
+         * @param args [in] [std::string] JSON object members
+         */
+        void set_args(const std::string& args) { if (this->active_) { this->args_ = args; } }
+
+    private:
+        const char* name_;
+        const char* category_;
+        bool active_;
+        clock::time_point start_{};
+        std::string args_{};
+    };
+}
@@ -4,6 +4,12 @@
 
 #include "vo.h"
 
+// System libraries
+#include <limits>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
 std::string tools::vector::da_cons2string(const DACE::AlgebraicVector<DACE::DA>& v, const std::string& separator,
                                           const std::string& precision, bool close)
 {
@@ -12,4 +18,169 @@ std::string tools::vector::da_cons2string(const DACE::AlgebraicVector<DACE::DA>&
 
     // Call to already built template
     return tools::vector::num2string<double>(v_cte, separator, precision, close);
-}
\ No newline at end of file
+}
+
+namespace
+{
+    /**
+     * Dense monomial basis of one algebra.
+     */
+    struct monomial_basis
+    {
+        unsigned int order{0};
+        unsigned int nvar{0};
+        std::vector<unsigned int> exponents{};
+        std::unordered_map<std::uint64_t, std::size_t> index{};
+    };
+
+    // Encode exponents as a single key: base (order + 1)
+    std::uint64_t encode_exponents(const unsigned int* jj, unsigned int nvar, unsigned int order)
+    {
+        std::uint64_t key = 0;
+        for (unsigned int k = 0; k < nvar; k++)
+        {
+            key = key * (order + 1) + jj[k];
+        }
+        return key;
+    }
+
+    // Bases built so far, by algebra (order and variables). Shared by every thread and never erased, so that the
+    // references handed out stay valid
+    std::mutex bases_mutex;
+    std::map<std::pair<unsigned int, unsigned int>, monomial_basis> bases;
+
+    // Get the basis of the current algebra
+    const monomial_basis& current_basis()
+    {
+        // Auxiliary variables
+        auto order = DACE::DA::getMaxOrder();
+        auto nvar = DACE::DA::getMaxVariables();
+
+        // Lock bases
+        std::lock_guard<std::mutex> lock(bases_mutex);
+
+        // Already built
+        auto it = bases.find({order, nvar});
+        if (it != bases.end())
+        {
+            return it->second;
+        }
+
+        // Safety check: the keys, (order + 1)^nvar of them, must fit in 64 bits
+        std::uint64_t n_keys = 1;
+        for (unsigned int k = 0; k < nvar; k++)
+        {
+            if (n_keys > std::numeric_limits<std::uint64_t>::max() / (order + 1))
+            {
+                throw std::runtime_error(tools::string::print2string(
+                        "tools::vector: the dense monomial basis is not available for order '%d' with '%d' "
+                        "variables.", order, nvar));
+            }
+            n_keys *= order + 1;
+        }
+
+        // Build it
+        auto& basis = bases[{order, nvar}];
+        basis.order = order;
+        basis.nvar = nvar;
+
+        // Enumerate exponents order by order
+        std::vector<unsigned int> jj(nvar, 0);
+        for (unsigned int o = 0; o <= order; o++)
+        {
+            // First composition of 'o' in reverse lexicographic order
+            std::fill(jj.begin(), jj.end(), 0);
+            if (nvar > 0) { jj[0] = o; }
+
+            while (true)
+            {
+                // Save monomial
+                basis.index[encode_exponents(jj.data(), nvar, order)] = basis.exponents.size() / nvar;
+                basis.exponents.insert(basis.exponents.end(), jj.begin(), jj.end());
+
+                // Next composition: move one unit from the last non-zero entry (not the last one) to the right
+                int k = (int) nvar - 2;
+                while (k >= 0 && jj[k] == 0) { k--; }
+                if (k < 0) { break; }
+                jj[k]--;
+                unsigned int tail = jj[nvar - 1] + 1;
+                jj[nvar - 1] = 0;
+                jj[k + 1] = tail;
+            }
+        }
+
+        return basis;
+    }
+}
+
+const std::vector<unsigned int>& tools::vector::monomial_exponents()
+{
+    return current_basis().exponents;
+}
+
+std::size_t tools::vector::monomial_count()
+{
+    const auto& basis = current_basis();
+    return basis.nvar == 0 ? 0 : basis.exponents.size() / basis.nvar;
+}
+
+void tools::vector::pack_coefficients(const DACE::AlgebraicVector<DACE::DA>& v, double* coeffs)
+{
+    // Auxiliary variables
+    const auto& basis = current_basis();
+    auto n_mono = tools::vector::monomial_count();
+    DACE::Monomial m;
+
+    // Clean output
+    std::fill(coeffs, coeffs + n_mono * v.size(), 0.0);
+
+    // Place every non-zero coefficient
+    for (std::size_t i = 0; i < v.size(); i++)
+    {
+        for (unsigned int k = 1; k <= v[i].size(); k++)
+        {
+            v[i].getMonomial(k, m);
+            coeffs[i * n_mono + basis.index.at(encode_exponents(m.m_jj.data(), basis.nvar, basis.order))] = m.m_coeff;
+        }
+    }
+}
+
+DACE::AlgebraicVector<DACE::DA> tools::vector::unpack_coefficients(const double* coeffs, std::size_t n_comp,
+                                                                   const unsigned int* exponents, std::size_t n_mono)
+{
+    // Default basis
+    if (exponents == nullptr)
+    {
+        exponents = tools::vector::monomial_exponents().data();
+        n_mono = tools::vector::monomial_count();
+    }
+
+    // Auxiliary variables
+    auto nvar = DACE::DA::getMaxVariables();
+    auto order = DACE::DA::getMaxOrder();
+    std::vector<unsigned int> jj(nvar);
+
+    // Result to be returned
+    DACE::AlgebraicVector<DACE::DA> result(n_comp);
+
+    for (std::size_t i = 0; i < n_comp; i++)
+    {
+        for (std::size_t k = 0; k < n_mono; k++)
+        {
+            // Skip zeros
+            auto c = coeffs[i * n_mono + k];
+            if (c == 0.0) { continue; }
+
+            // Get exponents and check they fit in the algebra
+            std::copy(exponents + k * nvar, exponents + (k + 1) * nvar, jj.begin());
+            unsigned int o = 0;
+            for (auto e : jj) { o += e; }
+            if (o > order) { continue; }
+
+            // Set coefficient
+            result[i].setCoefficient(jj, c);
+        }
+    }
+
+    return result;
+}
@@ -8,6 +8,8 @@
 #include <string>
 #include <vector>
 #include <typeinfo>
+#include <unordered_map>
+#include <cstdint>
 
 // Include 3rd party library
 #include "dace/dace.h"
@@ -47,6 +49,39 @@ namespace tools::vector
     template<typename T>
     std::string unwrapMxN(int M, int N, T** matrix, const std::string& separator = ",",
                           const std::string& precision = "", bool close = true);
+
+    /**
+     * Exponents of every monomial of the current DACE algebra, sorted by order. This is the dense basis used by the
+     * numeric coefficient-array layout. Built once per algebra, thread-safe. Throws std::runtime_error if the algebra
+     * is too large for its keys ((order + 1)^n_var must fit in 64 bits).
+     * @return std::vector<unsigned int> column-major [n_var x n_mono]
+     */
+    const std::vector<unsigned int>& monomial_exponents();
+
+    /**
+     * Number of monomials of the current DACE algebra.
+     * @return std::size_t
+     */
+    std::size_t monomial_count();
+
+    /**
+     * Pack a DA vector into a dense coefficient array following the 'monomial_exponents' basis.
+     * @param v [in] [DACE::AlgebraicVector<DACE::DA>]
+     * @param coeffs [out] [double*] column-major [n_mono x v.size()], must be already allocated
+     */
+    void pack_coefficients(const DACE::AlgebraicVector<DACE::DA>& v, double* coeffs);
+
+    /**
+     * Unpack a DA vector from a dense coefficient array.
+     * @param coeffs [in] [double*] column-major [n_mono x n_comp]
+     * @param n_comp [in] [std::size_t]
+     * @param exponents [in] [unsigned int*] column-major [n_var x n_mono], nullptr for the 'monomial_exponents' basis
+     * @param n_mono [in] [std::size_t] number of monomials in 'exponents', ignored if nullptr
+     * @return DACE::AlgebraicVector<DACE::DA>
+     */
+    DACE::AlgebraicVector<DACE::DA> unpack_coefficients(const double* coeffs, std::size_t n_comp,
+                                                        const unsigned int* exponents = nullptr,
+                                                        std::size_t n_mono = 0);
 }
 
 // Include templates implementation
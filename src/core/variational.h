@@ -0,0 +1,148 @@
+/**
+ * Propagation of first- and second-order maps through their variational equations: the nominal state, its state
+ * transition matrix (STM) and, for second order, its state transition tensor (STT) are integrated in dense,
+ * fixed-size arrays instead of DA polynomials.
+ * @details:
+ *  - Templated on the size of the state so that every loop has a compile-time trip count.
+ *  - The scheme is the same RK4 (3/8 rule) as 'integrator::RK4_step': a DA of the same order integrated by it gives
+ *    the same map, up to round-off.
+ *  - The STM and STT are derivatives with respect to the initial state. The map in the DA variables is their
+ *    composition with the initial polynomials, kept as dense linear part and Hessian.
+ */
+
+#pragma once
+
+// System libraries
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// DACE libraries
+#include "dace/dace.h"
+
+// Project libraries
+#include "problems.h"
+#include "tools/profiler.h"
+
+namespace variational {
+
+    /**
+     * Nominal state and its state transition matrix, row-major.
+     * @tparam N size of the state
+     */
+    template<std::size_t N> struct linear_state
+    {
+        std::array<double, N> x{};
+        std::array<double, N * N> phi{};
+    };
+
+    /**
+     * Nominal state, its state transition matrix and tensor, row-major. The tensor is the Hessian of every component
+     * with respect to the initial state, [N x N x N], symmetric in its last two indices.
+     * @tparam N size of the state
+     */
+    template<std::size_t N> struct quadratic_state
+    {
+        std::array<double, N> x{};
+        std::array<double, N * N> phi{};
+        std::array<double, N * N * N> psi{};
+    };
+
+    /**
+     * Start from the constant part of an affine DA state, with the identity as STM. Its linear part, [N x nvar], is
+     * kept so that the map can be rebuilt afterwards.
+     * @param x [in] [DACE::AlgebraicVector<DACE::DA>] state, of size N
+     * @param y [out] [linear_state<N>]
+     * @param linear [out] [std::vector<double>]
+     * @param hessian [out] [std::vector<double>] emptied, first order has none
+     */
+    template<std::size_t N> void from_da(const DACE::AlgebraicVector<DACE::DA>& x, linear_state<N>& y,
+                                         std::vector<double>& linear, std::vector<double>& hessian);
+
+    /**
+     * Start from the constant part of a second-order DA state, with the identity as STM and no STT. Its linear part,
+     * [N x nvar], and its Hessian, [N x nvar x nvar], are kept so that the map can be rebuilt afterwards.
+     * @param x [in] [DACE::AlgebraicVector<DACE::DA>] state, of size N
+     * @param y [out] [quadratic_state<N>]
+     * @param linear [out] [std::vector<double>]
+     * @param hessian [out] [std::vector<double>]
+     */
+    template<std::size_t N> void from_da(const DACE::AlgebraicVector<DACE::DA>& x, quadratic_state<N>& y,
+                                         std::vector<double>& linear, std::vector<double>& hessian);
+
+    /**
+     * Derivatives of a propagated state with respect to the DA variables: the initial polynomials composed with the
+     * STM and STT. Jacobian = phi * linear, Hessian = phi * hessian + psi[linear, linear].
+     * @param y [in] [quadratic_state<N>]
+     * @param linear [in] [std::vector<double>] from 'from_da'
+     * @param hessian [in] [std::vector<double>] from 'from_da'
+     * @param jacobian_out [out] [std::vector<double>] [N x nvar]
+     * @param hessian_out [out] [std::vector<double>] [N x nvar x nvar]
+     */
+    template<std::size_t N> void compose(const quadratic_state<N>& y, const std::vector<double>& linear,
+                                         const std::vector<double>& hessian, std::vector<double>& jacobian_out,
+                                         std::vector<double>& hessian_out);
+
+    /**
+     * Affine DA map of a propagated state: x + phi * linear * DA.
+     * @param y [in] [linear_state<N>]
+     * @param linear [in] [std::vector<double>] from 'from_da'
+     * @param hessian [in] [std::vector<double>] unused, same signature as the second-order map for 'RK4_variational'
+     * @return DACE::AlgebraicVector<DACE::DA>
+     */
+    template<std::size_t N> DACE::AlgebraicVector<DACE::DA> to_da(const linear_state<N>& y,
+                                                                  const std::vector<double>& linear,
+                                                                  const std::vector<double>& hessian);
+
+    /**
+     * Second-order DA map of a propagated state, see 'compose'.
+     * @param y [in] [quadratic_state<N>]
+     * @param linear [in] [std::vector<double>] from 'from_da'
+     * @param hessian [in] [std::vector<double>] from 'from_da'
+     * @return DACE::AlgebraicVector<DACE::DA>
+     */
+    template<std::size_t N> DACE::AlgebraicVector<DACE::DA> to_da(const quadratic_state<N>& y,
+                                                                  const std::vector<double>& linear,
+                                                                  const std::vector<double>& hessian);
+
+    /**
+     * Single RK4 step of the state and its variational equations: d(phi)/dt = A(x) * phi.
+     * @param problem [in] [problems] must have dense dynamics, see 'problems::has_variational'
+     * @param y [in] [linear_state<N>]
+     * @param t [in] [double]
+     * @param h [in] [double]
+     * @return linear_state<N>
+     */
+    template<std::size_t N> linear_state<N> rk4_step(const problems& problem, const linear_state<N>& y, double t,
+                                                     double h);
+
+    /**
+     * Single RK4 step of the state and its second-order variational equations: d(phi)/dt = A(x) * phi,
+     * d(psi)/dt = A(x) * psi + H(x)[phi, phi].
+     * @param problem [in] [problems] must have dense dynamics, see 'problems::has_variational'
+     * @param y [in] [quadratic_state<N>]
+     * @param t [in] [double]
+     * @param h [in] [double]
+     * @return quadratic_state<N>
+     */
+    template<std::size_t N> quadratic_state<N> rk4_step(const problems& problem, const quadratic_state<N>& y,
+                                                        double t, double h);
+
+    /**
+     * Scale the quaternion (first four components) of the state to unit norm, its rows of the STM too: what the
+     * integrator does to the DA state after every attitude step.
+     * @param y [in/out] [linear_state<N>]
+     */
+    template<std::size_t N> void normalize_quaternion(linear_state<N>& y);
+
+    /**
+     * Same for a second-order state: rows of the STM and STT too.
+     * @param y [in/out] [quadratic_state<N>]
+     */
+    template<std::size_t N> void normalize_quaternion(quadratic_state<N>& y);
+}
+
+// Include templates implementation
+#include "variational_temp.cpp"
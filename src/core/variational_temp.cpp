@@ -0,0 +1,415 @@
+/**
+ * VARIATIONAL TEMPLATE FILE
+ */
+
+namespace variational::detail {
+
+    /**
+     * Derivative of the state and of its STM.
+     */
+    template<std::size_t N> linear_state<N> derivative(const problems& problem, const linear_state<N>& y, double t)
+    {
+        // Result and Jacobian of the dynamics
+        linear_state<N> dy;
+        std::array<double, N * N> a;
+        problem.solve_variational(y.x.data(), t, dy.x.data(), a.data());
+
+        // d(phi)/dt = A * phi
+        for (std::size_t i = 0; i < N; i++)
+        {
+            for (std::size_t j = 0; j < N; j++)
+            {
+                double sum = 0.0;
+                for (std::size_t k = 0; k < N; k++)
+                {
+                    sum += a[i * N + k] * y.phi[k * N + j];
+                }
+                dy.phi[i * N + j] = sum;
+            }
+        }
+
+        return dy;
+    }
+
+    /**
+     * Derivative of the state, of its STM and of its STT.
+     */
+    template<std::size_t N> quadratic_state<N> derivative(const problems& problem, const quadratic_state<N>& y,
+                                                          double t)
+    {
+        // Result, Jacobian and Hessian of the dynamics
+        quadratic_state<N> dy;
+        std::array<double, N * N> jac;
+        std::array<double, N * N * N> h;
+        problem.solve_variational(y.x.data(), t, dy.x.data(), jac.data(), h.data());
+
+        // d(phi)/dt = A * phi
+        for (std::size_t i = 0; i < N; i++)
+        {
+            for (std::size_t j = 0; j < N; j++)
+            {
+                double sum = 0.0;
+                for (std::size_t k = 0; k < N; k++)
+                {
+                    sum += jac[i * N + k] * y.phi[k * N + j];
+                }
+                dy.phi[i * N + j] = sum;
+            }
+        }
+
+        // d(psi)/dt = A * psi + H[phi, phi], upper triangle of every component only
+        std::array<double, N * N> hphi;
+        for (std::size_t i = 0; i < N; i++)
+        {
+            // H_i * phi, skipping the zero rows of the Hessian
+            hphi.fill(0.0);
+            for (std::size_t k = 0; k < N; k++)
+            {
+                for (std::size_t l = 0; l < N; l++)
+                {
+                    double h_ikl = h[(i * N + k) * N + l];
+                    if (h_ikl == 0.0) { continue; }
+                    for (std::size_t b = 0; b < N; b++)
+                    {
+                        hphi[k * N + b] += h_ikl * y.phi[l * N + b];
+                    }
+                }
+            }
+
+            for (std::size_t a = 0; a < N; a++)
+            {
+                for (std::size_t b = a; b < N; b++)
+                {
+                    double sum = 0.0;
+                    for (std::size_t k = 0; k < N; k++)
+                    {
+                        sum += jac[i * N + k] * y.psi[(k * N + a) * N + b] + y.phi[k * N + a] * hphi[k * N + b];
+                    }
+                    dy.psi[(i * N + a) * N + b] = sum;
+                    dy.psi[(i * N + b) * N + a] = sum;
+                }
+            }
+        }
+
+        return dy;
+    }
+
+    /**
+     * r = y + h * (c1 * k1 + c2 * k2 + c3 * k3 + c4 * k4), array by array
+     */
+    template<std::size_t M> void combine(std::array<double, M>& r, const std::array<double, M>& y, double h,
+                                         const double* c, const std::array<double, M>* const* k)
+    {
+        for (std::size_t i = 0; i < M; i++)
+        {
+            r[i] = y[i] + h * (c[0] * (*k[0])[i] + c[1] * (*k[1])[i] + c[2] * (*k[2])[i] + c[3] * (*k[3])[i]);
+        }
+    }
+
+    template<std::size_t N> linear_state<N> combine(const linear_state<N>& y, double h, const double* c,
+                                                    const linear_state<N>* const* k)
+    {
+        linear_state<N> r;
+        const std::array<double, N>* kx[4] = {&k[0]->x, &k[1]->x, &k[2]->x, &k[3]->x};
+        const std::array<double, N * N>* kphi[4] = {&k[0]->phi, &k[1]->phi, &k[2]->phi, &k[3]->phi};
+        combine(r.x, y.x, h, c, kx);
+        combine(r.phi, y.phi, h, c, kphi);
+        return r;
+    }
+
+    template<std::size_t N> quadratic_state<N> combine(const quadratic_state<N>& y, double h, const double* c,
+                                                       const quadratic_state<N>* const* k)
+    {
+        quadratic_state<N> r;
+        const std::array<double, N>* kx[4] = {&k[0]->x, &k[1]->x, &k[2]->x, &k[3]->x};
+        const std::array<double, N * N>* kphi[4] = {&k[0]->phi, &k[1]->phi, &k[2]->phi, &k[3]->phi};
+        const std::array<double, N * N * N>* kpsi[4] = {&k[0]->psi, &k[1]->psi, &k[2]->psi, &k[3]->psi};
+        combine(r.x, y.x, h, c, kx);
+        combine(r.phi, y.phi, h, c, kphi);
+        combine(r.psi, y.psi, h, c, kpsi);
+        return r;
+    }
+
+    /**
+     * RK4 (3/8 rule) step of any state, as 'integrator::RK4_step'
+     */
+    template<typename S> S rk4(const problems& problem, const S& y, double t, double h)
+    {
+        // Profile
+        PROFILE_SCOPE(PROFILE_SECTION::STEP);
+
+        // Stages' weights
+        static constexpr double c2[4] = {1.0/3, 0.0, 0.0, 0.0};
+        static constexpr double c3[4] = {-1.0/3, 1.0, 0.0, 0.0};
+        static constexpr double c4[4] = {1.0, -1.0, 1.0, 0.0};
+        static constexpr double c5[4] = {1.0/8, 3.0/8, 3.0/8, 1.0/8};
+
+        // Compute points in between
+        S k1 = derivative(problem, y, t);
+        const S* k[4] = {&k1, &k1, &k1, &k1};
+        S k2 = derivative(problem, combine(y, h, c2, k), t + h/3);
+        k[1] = &k2;
+        S k3 = derivative(problem, combine(y, h, c3, k), t + 2*h/3);
+        k[2] = &k3;
+        S k4 = derivative(problem, combine(y, h, c4, k), t + h);
+        k[3] = &k4;
+
+        // Compute the single step
+        return combine(y, h, c5, k);
+    }
+}
+
+template<std::size_t N> void variational::from_da(const DACE::AlgebraicVector<DACE::DA>& x, linear_state<N>& y,
+                                                  std::vector<double>& linear, std::vector<double>& hessian)
+{
+    // Number of variables of the algebra
+    std::size_t nvar = DACE::DA::getMaxVariables();
+
+    // Constant part and identity
+    y = linear_state<N>{};
+    linear.assign(N * nvar, 0.0);
+    hessian.clear();
+    for (std::size_t i = 0; i < N; i++)
+    {
+        y.x[i] = x[i].cons();
+        y.phi[i * N + i] = 1.0;
+
+        // Linear part of the component
+        auto row = x[i].linear();
+        std::copy(row.begin(), row.end(), linear.begin() + (long) (i * nvar));
+    }
+}
+
+template<std::size_t N> DACE::AlgebraicVector<DACE::DA> variational::to_da(const linear_state<N>& y,
+                                                                           const std::vector<double>& linear,
+                                                                           const std::vector<double>& /* hessian */)
+{
+    // Number of variables of the algebra
+    std::size_t nvar = DACE::DA::getMaxVariables();
+
+    // Result
+    DACE::AlgebraicVector<DACE::DA> x(N);
+    for (std::size_t i = 0; i < N; i++)
+    {
+        // Constant part
+        x[i] = y.x[i];
+
+        // Linear part: phi * linear
+        for (std::size_t j = 0; j < nvar; j++)
+        {
+            double coefficient = 0.0;
+            for (std::size_t k = 0; k < N; k++)
+            {
+                coefficient += y.phi[i * N + k] * linear[k * nvar + j];
+            }
+
+            // Skip zeros, as the DA arithmetic would
+            if (coefficient != 0.0)
+            {
+                x[i] += DACE::DA((int) j + 1, coefficient);
+            }
+        }
+    }
+
+    return x;
+}
+
+template<std::size_t N> variational::linear_state<N> variational::rk4_step(const problems& problem,
+                                                                           const linear_state<N>& y, double t,
+                                                                           double h)
+{
+    return detail::rk4(problem, y, t, h);
+}
+
+template<std::size_t N> variational::quadratic_state<N> variational::rk4_step(const problems& problem,
+                                                                              const quadratic_state<N>& y, double t,
+                                                                              double h)
+{
+    return detail::rk4(problem, y, t, h);
+}
+
+template<std::size_t N> void variational::normalize_quaternion(linear_state<N>& y)
+{
+    // Norm of the nominal quaternion
+    double norm = std::sqrt(y.x[0]*y.x[0] + y.x[1]*y.x[1] + y.x[2]*y.x[2] + y.x[3]*y.x[3]);
+
+    // Scale state and STM rows alike
+    for (std::size_t i = 0; i < 4; i++)
+    {
+        y.x[i] /= norm;
+        for (std::size_t j = 0; j < N; j++)
+        {
+            y.phi[i * N + j] /= norm;
+        }
+    }
+}
+
+template<std::size_t N> void variational::normalize_quaternion(quadratic_state<N>& y)
+{
+    // Norm of the nominal quaternion
+    double norm = std::sqrt(y.x[0]*y.x[0] + y.x[1]*y.x[1] + y.x[2]*y.x[2] + y.x[3]*y.x[3]);
+
+    // Scale state, STM and STT rows alike
+    for (std::size_t i = 0; i < 4; i++)
+    {
+        y.x[i] /= norm;
+        for (std::size_t j = 0; j < N; j++)
+        {
+            y.phi[i * N + j] /= norm;
+            for (std::size_t k = 0; k < N; k++)
+            {
+                y.psi[(i * N + j) * N + k] /= norm;
+            }
+        }
+    }
+}
+
+template<std::size_t N> void variational::from_da(const DACE::AlgebraicVector<DACE::DA>& x, quadratic_state<N>& y,
+                                                  std::vector<double>& linear, std::vector<double>& hessian)
+{
+    // Number of variables of the algebra
+    std::size_t nvar = DACE::DA::getMaxVariables();
+
+    // Identity and no tensor
+    y = quadratic_state<N>{};
+    linear.assign(N * nvar, 0.0);
+    hessian.assign(N * nvar * nvar, 0.0);
+    for (std::size_t i = 0; i < N; i++)
+    {
+        y.phi[i * N + i] = 1.0;
+
+        // Every monomial of the component, by its order
+        for (const auto& monomial : x[i].getMonomials())
+        {
+            // Variables involved: a single one, twice for squares
+            std::size_t order = 0, a = nvar, b = nvar;
+            for (std::size_t v = 0; v < nvar; v++)
+            {
+                for (unsigned int e = 0; e < monomial.m_jj[v]; e++)
+                {
+                    (a == nvar ? a : b) = v;
+                    order++;
+                }
+            }
+
+            // Constant, linear and second order parts, the Hessian is twice the coefficient of a square
+            if (order == 0)
+            {
+                y.x[i] = monomial.m_coeff;
+            }
+            else if (order == 1)
+            {
+                linear[i * nvar + a] = monomial.m_coeff;
+            }
+            else if (order == 2)
+            {
+                double value = a == b ? 2.0 * monomial.m_coeff : monomial.m_coeff;
+                hessian[(i * nvar + a) * nvar + b] = value;
+                hessian[(i * nvar + b) * nvar + a] = value;
+            }
+        }
+    }
+
+}
+
+template<std::size_t N> void variational::compose(const quadratic_state<N>& y, const std::vector<double>& linear,
+                                                  const std::vector<double>& hessian,
+                                                  std::vector<double>& jacobian_out, std::vector<double>& hessian_out)
+{
+    // Number of variables of the algebra
+    std::size_t nvar = DACE::DA::getMaxVariables();
+
+    // Jacobian: phi * linear
+    jacobian_out.assign(N * nvar, 0.0);
+    for (std::size_t i = 0; i < N; i++)
+    {
+        for (std::size_t k = 0; k < N; k++)
+        {
+            double phi_ik = y.phi[i * N + k];
+            for (std::size_t a = 0; a < nvar; a++)
+            {
+                jacobian_out[i * nvar + a] += phi_ik * linear[k * nvar + a];
+            }
+        }
+    }
+
+    // Hessian: phi * hessian + psi[linear, linear], through psi * linear first
+    hessian_out.assign(N * nvar * nvar, 0.0);
+    std::vector<double> psi_linear(N * nvar);
+    for (std::size_t i = 0; i < N; i++)
+    {
+        // psi_i * linear, [N x nvar]
+        std::fill(psi_linear.begin(), psi_linear.end(), 0.0);
+        for (std::size_t k = 0; k < N; k++)
+        {
+            for (std::size_t l = 0; l < N; l++)
+            {
+                double psi_ikl = y.psi[(i * N + k) * N + l];
+                if (psi_ikl == 0.0) { continue; }
+                for (std::size_t b = 0; b < nvar; b++)
+                {
+                    psi_linear[k * nvar + b] += psi_ikl * linear[l * nvar + b];
+                }
+            }
+        }
+
+        for (std::size_t a = 0; a < nvar; a++)
+        {
+            for (std::size_t b = a; b < nvar; b++)
+            {
+                double sum = 0.0;
+                for (std::size_t k = 0; k < N; k++)
+                {
+                    sum += y.phi[i * N + k] * hessian[(k * nvar + a) * nvar + b] +
+                           linear[k * nvar + a] * psi_linear[k * nvar + b];
+                }
+                hessian_out[(i * nvar + a) * nvar + b] = sum;
+                hessian_out[(i * nvar + b) * nvar + a] = sum;
+            }
+        }
+    }
+}
+
+template<std::size_t N> DACE::AlgebraicVector<DACE::DA> variational::to_da(const quadratic_state<N>& y,
+                                                                           const std::vector<double>& linear,
+                                                                           const std::vector<double>& hessian)
+{
+    // Number of variables of the algebra
+    std::size_t nvar = DACE::DA::getMaxVariables();
+
+    // Derivatives in the DA variables
+    std::vector<double> jacobian, hessian_da;
+    variational::compose(y, linear, hessian, jacobian, hessian_da);
+
+    // Result
+    DACE::AlgebraicVector<DACE::DA> x(N);
+    std::vector<unsigned int> jj(nvar, 0);
+    for (std::size_t i = 0; i < N; i++)
+    {
+        // Constant part
+        x[i] = y.x[i];
+
+        for (std::size_t a = 0; a < nvar; a++)
+        {
+            // Linear part, skipping zeros as the DA arithmetic would
+            jj[a]++;
+            if (jacobian[i * nvar + a] != 0.0)
+            {
+                x[i].setCoefficient(jj, jacobian[i * nvar + a]);
+            }
+
+            // Second order part: half the Hessian for squares
+            for (std::size_t b = a; b < nvar; b++)
+            {
+                double value = hessian_da[(i * nvar + a) * nvar + b];
+                if (value == 0.0) { continue; }
+                jj[b]++;
+                x[i].setCoefficient(jj, a == b ? 0.5 * value : value);
+                jj[b]--;
+            }
+            jj[a]--;
+        }
+    }
+
+    return x;
+}
@@ -6,10 +6,35 @@
 
 void writer::write_files(delta* delta, const std::filesystem::path& output_dir)
 {
+    // Profile
+    tools::profiler::scoped_timer profile_timer(PROFILE_SECTION::WRITE_FILES);
+    tools::trace::scoped_span trace_span("write_files", "io");
+    trace_span.set_args("\"dir\": \"" + output_dir.string() + "\"");
+
     // Debugging files
     std::filesystem::path output_debug_splitting_history = output_dir / "splitting_history.txt";
     tools::io::dace::dump_splitting_history(delta, output_debug_splitting_history);
 
+    // Weighted moments of the final centers, if the patches carry their probability mass
+    tools::io::dace::dump_weighted_moments(delta, output_dir / "weighted_moments_fin.txt");
+
+    // Gaussian mixture of the final manifold, merged down to the target count
+    if (this->mixture_.enabled())
+    {
+        tools::trace::scoped_span mixture_span("dump_mixture", "io");
+        auto components = mixture::extract(*delta->get_SuperManifold()->get_manifold_fin(),
+                                           this->mixture_.confidence_interval);
+        mixture::reduce(components, this->mixture_.components);
+        if (this->mixture_.binary)
+        {
+            mixture::write_binary(output_dir / "mixture_fin.gmm", components);
+        }
+        if (this->mixture_.json)
+        {
+            mixture::write_json(output_dir / "mixture_fin.json", components);
+        }
+    }
+
     // Form objects
     structs::output::wdc_o wdc_ini{};
     structs::output::wdc_o wdc_fin{};
@@ -88,6 +113,13 @@ void writer::write_files(delta* delta, const std::filesystem::path& output_dir)
         wdc_fin.output_prefix = output_dir / "projection_fin";
         this->out_obj.wdcs.emplace_back(wdc_fin);
     }
+
+    // Dump the profile next to the splitting history
+    if (tools::profiler::enabled())
+    {
+        profile_timer.stop();
+        tools::profiler::dump(output_dir / "profile.json");
+    }
 }
 
 void writer::set_dump_nominal_results(bool final, bool initial)
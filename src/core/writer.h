@@ -8,6 +8,7 @@
 # include "delta.h"
 #include "tools/io.h"
 #include "base/structs.h"
+#include "ads/mixture.h"
 
 class writer
 {
@@ -42,6 +43,9 @@ private: // Private attributes
     bool walls_bool_set{false};
     bool centers_bool_set{false};
 
+    // Gaussian mixture of the final manifold
+    mixture::settings mixture_{};
+
 private: // Private attributes
 
     structs::out_obj out_obj{};
@@ -74,6 +78,12 @@ public: // Setters
      */
     void set_dump_centers_results(bool centers = true);
 
+    /**
+     * Set whether to dump the Gaussian mixture of the final manifold, and how
+     * @param settings [in] [mixture::settings]
+     */
+    void set_dump_mixture_results(const mixture::settings& settings) { this->mixture_ = settings; }
+
 public: // Getters
 
     /**
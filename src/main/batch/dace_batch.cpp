@@ -0,0 +1,554 @@
+/**
+ * DACE_BATCH: runs many scenarios in one process.
+ *  - Inputs are JSON files, directories (every '*.json' inside), glob patterns or JSON files holding an array of
+ *    scenarios. Every input is parsed (and checked) before anything runs.
+ *  - Scenarios are grouped by algebra (order and variables): DACE is initialized once per group and the scenarios are
+ *    run in forked workers that inherit the initialized algebra. DACE is not thread-safe, processes also isolate the
+ *    engine exits of a failing scenario from the rest of the batch.
+ *  - Each scenario writes its usual output files (no plots unless requested) and one consolidated summary is written.
+ *  - A scenario with a 'sweep' section runs all its cases in the same worker, sharing their common work, and writes
+ *    one sub-directory per case.
+ *
+ * Usage:
+ *  dace_batch [--jobs <n>] [--samples <n>] [--stratified] [--summary <file>] [--cache-dir <dir>] [--plots] [--verbose]
+ *             <inputs...>
+ *  Every core is used unless '--jobs' is given. With '--cache-dir', plain scenarios already propagated with the same
+ *  inputs and build are restored instead of propagated. With '--stratified', the samples of translation scenarios are
+ *  drawn patch by patch instead of located in the final manifold.
+ */
+
+// System libraries
+#include <chrono>
+#include <filesystem>
+#include <glob.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+// DACE libraries
+#include "dace/dace.h"
+
+// Project libraries
+#include "base/Header_Info.h"
+#include "session.h"
+#include "sweep.h"
+#include "tools/io.h"
+#include "tools/da_context.h"
+#include "json/json_parser.h"
+#include "writer.h"
+#include "FileProcessor.h"
+
+/**
+ * One scenario of the batch
+ */
+struct batch_scenario
+{
+    // Where it comes from: file, or file[index] for arrays
+    std::string name{};
+    json_input specs{};
+
+    // Result
+    bool ok{false};
+    int exit_code{-1};
+    std::size_t patches{};
+    double propagation_s{};
+    double total_s{};
+};
+
+/**
+ * Batch options
+ */
+struct batch_options
+{
+    int jobs{0};
+    int samples{10000};
+    bool stratified{false};
+    std::filesystem::path summary{"batch_summary.json"};
+    std::filesystem::path cache_dir{};
+    bool plots{false};
+    bool verbose{false};
+    std::vector<std::string> inputs{};
+};
+
+// Clock to be used
+using batch_clock = std::chrono::steady_clock;
+
+/**
+ * Expand the inputs (files, directories and glob patterns) into a sorted list of files.
+ * @param inputs [in] [std::vector<std::string>]
+ * @return std::vector<std::string>
+ */
+std::vector<std::string> expand_inputs(const std::vector<std::string>& inputs)
+{
+    // Files to be returned
+    std::vector<std::string> files;
+
+    for (const auto& input : inputs)
+    {
+        if (std::filesystem::is_directory(input))
+        {
+            // Every JSON in the directory, sorted so that the order is stable
+            std::vector<std::string> dir_files;
+            for (const auto& entry : std::filesystem::directory_iterator(input))
+            {
+                if (entry.path().extension() == ".json") { dir_files.push_back(entry.path()); }
+            }
+            std::sort(dir_files.begin(), dir_files.end());
+            files.insert(files.end(), dir_files.begin(), dir_files.end());
+        }
+        else if (input.find_first_of("*?[") != std::string::npos)
+        {
+            // Glob pattern (results are sorted by glob)
+            glob_t g{};
+            if (glob(input.c_str(), 0, nullptr, &g) == 0)
+            {
+                files.insert(files.end(), g.gl_pathv, g.gl_pathv + g.gl_pathc);
+            }
+            else
+            {
+                std::fprintf(stderr, "dace_batch: pattern '%s' does not match any file.\n", input.c_str());
+            }
+            globfree(&g);
+        }
+        else
+        {
+            // Plain file
+            files.push_back(input);
+        }
+    }
+
+    return files;
+}
+
+/**
+ * Parse every input file; a file holding a JSON array yields one scenario per element.
+ * @param files [in] [std::vector<std::string>]
+ * @return std::vector<batch_scenario>
+ */
+std::vector<batch_scenario> parse_scenarios(const std::vector<std::string>& files)
+{
+    // Scenarios to be returned
+    std::vector<batch_scenario> scenarios;
+
+    for (const auto& file : files)
+    {
+        // Read the file once
+        auto json_text = json_parser::read_file(file);
+
+        if (!json_text.empty() && json_text.front() == '[')
+        {
+            // Array of scenarios
+            auto elements = json_parser::split_array(json_text);
+            for (std::size_t k = 0; k < elements.size(); k++)
+            {
+                auto name = tools::string::print2string("%s[%zu]", file.c_str(), k);
+                scenarios.push_back({name, json_parser::parse_input_text(elements[k], name)});
+            }
+        }
+        else
+        {
+            // Single scenario
+            scenarios.push_back({file, json_parser::parse_input_text(json_text, file)});
+        }
+    }
+
+    return scenarios;
+}
+
+/**
+ * Evaluate samples and write the output files of a propagated super manifold, as 'dace_vsod' (translation) or
+ * 'dace_vsad' (attitude) do.
+ * @param sm [in] [SuperManifold]
+ * @param specs [in] [json_input]
+ * @param output_dir [in] [std::string]
+ * @param opts [in] [batch_options]
+ */
+void write_outputs(SuperManifold* sm, const json_input& specs, const std::string& output_dir, const batch_options& opts)
+{
+    // Attitude?
+    bool attitude = specs.problem == PROBLEM::FREE_TORQUE_MOTION;
+
+    // Build deltas class
+    auto deltas_engine = std::make_shared<delta>();
+
+    if (attitude)
+    {
+        // Euler angles manifolds, for plotting
+        sm->set_6dof_domain();
+
+        // Mean quaternion
+        DACE::AlgebraicVector<double> q_mean(std::vector<double>(specs.initial_conditions.mean.begin(),
+                                                                 specs.initial_conditions.mean.begin() + 4));
+
+        // Set some options
+        deltas_engine->set_bool_option(DELTA_GENERATOR_OPTION::ATTITUDE, true);
+        deltas_engine->set_bool_option(DELTA_GENERATOR_OPTION::QUAT2EULER, true);
+        deltas_engine->set_sampling_option(QUATERNION_SAMPLING::OMPL_GAUSSIAN);
+        deltas_engine->set_mean_quaternion_option(q_mean);
+    }
+
+    // Set distribution, compute deltas and insert nominal: stratified ones are drawn in the patches of the manifold
+    deltas_engine->set_superManifold(sm);
+    deltas_engine->set_stddevs(specs.initial_conditions.standard_deviation);
+    deltas_engine->generate_deltas(opts.stratified && !attitude ? DISTRIBUTION::STRATIFIED : DISTRIBUTION::GAUSSIAN,
+                                   opts.samples);
+    deltas_engine->insert_nominal(specs.algebra.variables);
+
+    // Evaluate deltas
+    deltas_engine->evaluate_deltas();
+
+    // Once evaluated, convert initial domain to euler angles, just for plotting stuff
+    if (attitude)
+    {
+        deltas_engine->convert_non_eval_deltas_to_euler();
+    }
+
+    // Create writer object to write files
+    writer writer{};
+    writer.set_dump_nominal_results(true, true);
+    if (attitude)
+    {
+        writer.set_dump_centers_results(false);
+        writer.set_dump_walls_results(false);
+    }
+
+    // Gaussian mixture of the final manifold if requested
+    if (specs.mixture.set)
+    {
+        writer.set_dump_mixture_results({(std::size_t) specs.mixture.components, specs.mixture.binary,
+                                         specs.mixture.json, specs.initial_conditions.confidence_interval});
+    }
+
+    // Write files
+    writer.write_files(deltas_engine.get(), output_dir);
+
+    // Plots only if requested: they are the slowest part of a scenario
+    if (opts.plots)
+    {
+        FileProcessor fproc(writer.get_out_obj());
+        fproc.set_metrics(specs.initial_conditions.length_units);
+        fproc.set_ucflags(attitude ? PYPLOT_ATTITUDE : PYPLOT_TRANSLATION, PYPLOT_BANANA);
+        fproc.process_files();
+    }
+}
+
+/**
+ * Propagate one scenario and write its output files. A scenario with a sweep writes one sub-directory per case.
+ * @param specs [in] [json_input]
+ * @param opts [in] [batch_options]
+ * @param propagation_s [out] [double]
+ * @return number of patches of the final manifold, summed over the cases of a sweep
+ */
+std::size_t run_scenario(const json_input& specs, const batch_options& opts, double& propagation_s)
+{
+    // Plain scenario
+    if (!specs.sweep.set)
+    {
+        // Build and propagate
+        auto t0 = batch_clock::now();
+        session s(specs);
+        s.set_cache({opts.cache_dir, GIT_HASH});
+        s.propagate();
+        propagation_s = std::chrono::duration<double>(batch_clock::now() - t0).count();
+
+        // Outputs
+        write_outputs(s.get_super_manifold(), specs, specs.output_dir, opts);
+
+        return s.get_manifold_fin()->size();
+    }
+
+    // Sweep: every final time of every case
+    std::size_t patches = 0;
+    double outputs_s = 0.0;
+    auto t0 = batch_clock::now();
+    sweep::run(specs, [&](const json_input& case_specs, session& s)
+    {
+        auto t_out = batch_clock::now();
+        auto sm = s.get_super_manifold();
+        for (std::size_t k = 0; k < sm->get_segment_count(); k++)
+        {
+            // View of the segment: copies of the initial domain and of the final manifold of the segment
+            SuperManifold view(case_specs.algorithm);
+            view.previous_ = std::make_unique<Manifold>(*sm->previous_);
+            view.current_ = std::make_unique<Manifold>(*sm->get_segment(k));
+
+            // Outputs
+            auto case_dir = std::filesystem::path(specs.output_dir) / sweep::case_name(case_specs, sm->get_segment_time(k));
+            write_outputs(&view, case_specs, case_dir, opts);
+            patches += view.current_->size();
+        }
+        outputs_s += std::chrono::duration<double>(batch_clock::now() - t_out).count();
+    });
+    propagation_s = std::chrono::duration<double>(batch_clock::now() - t0).count() - outputs_s;
+
+    return patches;
+}
+
+/**
+ * Worker body: runs one scenario and reports through the pipe. Never returns.
+ * @param scenario [in] [batch_scenario]
+ * @param opts [in] [batch_options]
+ * @param fd [in] [int] write end of the pipe
+ */
+[[noreturn]] void worker(const batch_scenario& scenario, const batch_options& opts, int fd)
+{
+    // Keep the engine output in a log next to the results
+    if (!opts.verbose)
+    {
+        std::filesystem::create_directories(scenario.specs.output_dir);
+        auto log_path = std::filesystem::path(scenario.specs.output_dir) / "batch.log";
+        int log_fd = open(log_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (log_fd >= 0)
+        {
+            dup2(log_fd, STDOUT_FILENO);
+            dup2(log_fd, STDERR_FILENO);
+            close(log_fd);
+        }
+    }
+
+    // Run, any exception is a failure
+    int code = 0;
+    std::string report{};
+    try
+    {
+        double propagation_s{};
+        auto patches = run_scenario(scenario.specs, opts, propagation_s);
+        report = tools::string::print2string("%zu %.9f\n", patches, propagation_s);
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "dace_batch: scenario '%s' failed: %s\n", scenario.name.c_str(), e.what());
+        code = 1;
+    }
+
+    // Report and leave without running the parent's atexit handlers
+    std::fflush(stdout);
+    std::fflush(stderr);
+    if (!report.empty() && write(fd, report.c_str(), report.size()) < 0) { code = 1; }
+    close(fd);
+    _exit(code);
+}
+
+/**
+ * Run every scenario: grouped by algebra, at most 'jobs' workers at a time.
+ * @param scenarios [in/out] [std::vector<batch_scenario>]
+ * @param opts [in] [batch_options]
+ */
+void run_batch(std::vector<batch_scenario>& scenarios, const batch_options& opts)
+{
+    // Group by algebra: order of execution
+    std::vector<std::size_t> order(scenarios.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b)
+    {
+        const auto& alg_a = scenarios[a].specs.algebra;
+        const auto& alg_b = scenarios[b].specs.algebra;
+        return std::tie(alg_a.order, alg_a.variables) < std::tie(alg_b.order, alg_b.variables);
+    });
+
+    // Running workers: pid -> (scenario, read end of its pipe, start)
+    struct running { std::size_t idx; int fd; batch_clock::time_point start; };
+    std::map<pid_t, running> workers;
+
+    // Wait for one worker and collect its result
+    auto collect = [&]()
+    {
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        auto it = workers.find(pid);
+        if (pid < 0 || it == workers.end()) { return; }
+
+        // Result
+        auto& sc = scenarios[it->second.idx];
+        sc.total_s = std::chrono::duration<double>(batch_clock::now() - it->second.start).count();
+        sc.exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+
+        // Report
+        char buffer[128]{};
+        auto n = read(it->second.fd, buffer, sizeof(buffer) - 1);
+        close(it->second.fd);
+        sc.ok = sc.exit_code == 0 && n > 0 && std::sscanf(buffer, "%zu %lf", &sc.patches, &sc.propagation_s) == 2;
+
+        // Info
+        std::fprintf(stdout, "dace_batch: %-6s %-50s %8.3f s  %6zu patches\n", sc.ok ? "OK" : "FAILED",
+                     sc.name.c_str(), sc.total_s, sc.patches);
+        std::fflush(stdout);
+
+        workers.erase(it);
+    };
+
+    for (auto idx : order)
+    {
+        const auto& algebra = scenarios[idx].specs.algebra;
+
+        // Wait for a free slot
+        while ((int) workers.size() >= opts.jobs) { collect(); }
+
+        // Initialize DACE once per group, workers inherit it. Running workers own a copy of the previous one
+        bool same_algebra = DACE::DA::isInitialized() && DACE::DA::getMaxOrder() == (unsigned int) algebra.order &&
+                DACE::DA::getMaxVariables() == (unsigned int) algebra.variables;
+        if (!same_algebra)
+        {
+            tools::da_context::pin(algebra.order, algebra.variables);
+            std::fprintf(stdout, "dace_batch: DACE initialized with order '%d' and '%d' variables.\n",
+                         algebra.order, algebra.variables);
+        }
+
+        // Launch worker
+        int fds[2];
+        if (pipe(fds) != 0)
+        {
+            std::fprintf(stderr, "dace_batch: cannot create pipe.\n");
+            std::exit(3);
+        }
+
+        std::fflush(stdout);
+        std::fflush(stderr);
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            close(fds[0]);
+            worker(scenarios[idx], opts, fds[1]);
+        }
+        else if (pid < 0)
+        {
+            std::fprintf(stderr, "dace_batch: cannot fork.\n");
+            std::exit(3);
+        }
+
+        close(fds[1]);
+        workers[pid] = {idx, fds[0], batch_clock::now()};
+    }
+
+    // Wait for the rest
+    while (!workers.empty()) { collect(); }
+}
+
+/**
+ * Write the consolidated summary (JSON).
+ * @param scenarios [in] [std::vector<batch_scenario>]
+ * @param opts [in] [batch_options]
+ * @param wall_s [in] [double]
+ */
+void write_summary(const std::vector<batch_scenario>& scenarios, const batch_options& opts, double wall_s)
+{
+    // Open file
+    std::ofstream file(opts.summary);
+
+    // Safety check
+    if (!file.is_open())
+    {
+        std::fprintf(stderr, "dace_batch: cannot open summary file '%s'.\n", opts.summary.c_str());
+        std::exit(2);
+    }
+
+    // Counters
+    auto n_ok = std::count_if(scenarios.begin(), scenarios.end(), [](const batch_scenario& sc) { return sc.ok; });
+
+    file << "{" << std::endl;
+    file << tools::string::print2string("  \"version\": \"%s\",", CODE_VERSION) << std::endl;
+    file << tools::string::print2string("  \"git_hash\": \"%s\",", GIT_HASH) << std::endl;
+    file << tools::string::print2string("  \"jobs\": %d,", opts.jobs) << std::endl;
+    file << tools::string::print2string("  \"wall_s\": %.6f,", wall_s) << std::endl;
+    file << tools::string::print2string("  \"succeeded\": %ld,", (long) n_ok) << std::endl;
+    file << tools::string::print2string("  \"failed\": %ld,", (long) scenarios.size() - n_ok) << std::endl;
+    file << "  \"scenarios\": [" << std::endl;
+    for (std::size_t k = 0; k < scenarios.size(); k++)
+    {
+        const auto& sc = scenarios[k];
+        file << tools::string::print2string(
+                "    {\"name\": \"%s\", \"status\": \"%s\", \"exit_code\": %d, \"algorithm\": \"%s\", "
+                "\"problem\": \"%s\", \"order\": %d, \"variables\": %d, \"final_time\": %.16f, \"patches\": %zu, "
+                "\"propagation_s\": %.6f, \"total_s\": %.6f, \"output_dir\": \"%s\"}%s",
+                sc.name.c_str(), sc.ok ? "ok" : "failed", sc.exit_code,
+                tools::enums::ALGORITHM2str(sc.specs.algorithm).c_str(),
+                tools::enums::PROBLEM2str(sc.specs.problem).c_str(), sc.specs.algebra.order,
+                sc.specs.algebra.variables, sc.specs.propagation.final_time, sc.patches, sc.propagation_s,
+                sc.total_s, sc.specs.output_dir.c_str(), k + 1 < scenarios.size() ? "," : "") << std::endl;
+    }
+    file << "  ]" << std::endl;
+    file << "}" << std::endl;
+
+    // Info
+    std::fprintf(stdout, "dace_batch: %ld/%zu scenarios succeeded in %.3f s, summary written in '%s'.\n",
+                 (long) n_ok, scenarios.size(), wall_s, opts.summary.c_str());
+}
+
+/**
+ * Parse command line options.
+ */
+batch_options parse_options(int argc, char* argv[])
+{
+    batch_options opts{};
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (arg == "--jobs" && has_value) { opts.jobs = std::stoi(argv[++i]); }
+        else if (arg == "--samples" && has_value) { opts.samples = std::stoi(argv[++i]); }
+        else if (arg == "--stratified") { opts.stratified = true; }
+        else if (arg == "--summary" && has_value) { opts.summary = argv[++i]; }
+        else if (arg == "--cache-dir" && has_value) { opts.cache_dir = argv[++i]; }
+        else if (arg == "--plots") { opts.plots = true; }
+        else if (arg == "--verbose") { opts.verbose = true; }
+        else if (arg.rfind("--", 0) == 0)
+        {
+            std::fprintf(stderr, "Usage: %s [--jobs <n>] [--samples <n>] [--stratified] [--summary <file>] "
+                                 "[--cache-dir <dir>] [--plots] [--verbose] <inputs...>\n", argv[0]);
+            std::exit(1);
+        }
+        else { opts.inputs.push_back(arg); }
+    }
+
+    // Default: every core
+    if (opts.jobs <= 0)
+    {
+        opts.jobs = (int) std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+    }
+
+    // Safety checks
+    if (opts.inputs.empty() || opts.samples <= 0)
+    {
+        std::fprintf(stderr, "dace_batch: at least one input is needed and samples must be positive.\n");
+        std::exit(1);
+    }
+
+    return opts;
+}
+
+/**
+ * Main entry point
+ */
+int main(int argc, char* argv[])
+{
+    // Build compilation info header
+    auto header_info = HeaderInfo(PROGRAM_NAME, CODE_VERSION, GIT_BRANCH, GIT_HASH,
+                                  USER_NAME, OS_VERSION, __DATE__, __TIME__);
+
+    // Parse options
+    auto opts = parse_options(argc, argv);
+
+    // Print ASCII BANNER, once for the whole batch
+    header_info.print_header_info();
+
+    // Remove warnings
+    DACE::DACEException::setWarning(false);
+
+    // Collect and parse every scenario before running any
+    auto scenarios = parse_scenarios(expand_inputs(opts.inputs));
+    std::fprintf(stdout, "dace_batch: '%zu' scenarios, '%d' jobs.\n", scenarios.size(), opts.jobs);
+
+    // Run
+    auto t0 = batch_clock::now();
+    run_batch(scenarios, opts);
+    double wall_s = std::chrono::duration<double>(batch_clock::now() - t0).count();
+
+    // Summary
+    write_summary(scenarios, opts, wall_s);
+
+    // Exit code: number of failures, saturated
+    auto n_failed = std::count_if(scenarios.begin(), scenarios.end(), [](const batch_scenario& sc) { return !sc.ok; });
+    return (int) std::min<long>(n_failed, 125);
+}
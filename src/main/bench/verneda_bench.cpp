@@ -0,0 +1,839 @@
+/**
+ * VERNEDA_BENCH: micro- and macro-benchmark suite.
+ *  - Micro: times the hot paths in isolation (RK4 step per problem, dense first- and second-order steps, ADS/LOADS checks, patch
+ *    splitting, manifold evaluations and deltas dumping).
+ *  - Macro: end-to-end propagation (and samples evaluation) of every JSON example.
+ *  - Stress: the same patches integrated serially and by several DA workers at once, results must be identical.
+ *  - Leak check: every example propagated and evaluated over and over in one process, the heap must not grow.
+ * Results are written in a machine-readable file (JSON or CSV) so that they can be compared between releases.
+ *
+ * Usage:
+ *  verneda_bench [--micro-only | --macro-only] [--examples <dir>] [--fraction <f>] [--min-time <s>]
+ *                [--samples <n>] [--output <file>] [--format json|csv] [--stress <threads>] [--repeats <n>]
+ *                [--leak-check <runs>]
+ */
+
+// System libraries
+#include <chrono>
+#include <filesystem>
+#include <malloc.h>
+#include <random>
+#include <unistd.h>
+
+// DACE libraries
+#include "dace/dace.h"
+
+// Project libraries
+#include "base/Header_Info.h"
+#include "session.h"
+#include "tools/io.h"
+#include "json/json_parser.h"
+#include "tools/da_context.h"
+#include "tools/arena.h"
+
+/**
+ * One benchmark measurement
+ */
+struct bench_result
+{
+    std::string group{};
+    std::string name{};
+    int iterations{};
+    double total_s{};
+    double mean_us{};
+    double min_us{};
+    std::size_t patches{};
+};
+
+/**
+ * Benchmark options
+ */
+struct bench_options
+{
+    bool micro{true};
+    bool macro{true};
+    std::filesystem::path examples_dir{EXAMPLES_DIR};
+    double fraction{1.0};
+    double min_time{0.5};
+    int samples{1000};
+    std::filesystem::path output{"verneda_bench.json"};
+    std::string format{"json"};
+    unsigned int stress_threads{0};
+    int stress_repeats{8};
+    int leak_runs{0};
+};
+
+// Clock to be used
+using bench_clock = std::chrono::steady_clock;
+
+/**
+ * Keep a kernel result alive so that the optimizer cannot drop the call that computed it.
+ * @param value [in] [T]
+ */
+template<typename T> inline void sink(const T& value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+/**
+ * Time a function: one warm-up call, then batches of calls until the minimum time is reached. The batch is doubled
+ * until it lasts 'min_batch_time', so that the clock overhead is negligible for the sub-microsecond kernels.
+ * @param group [in] [std::string]
+ * @param name [in] [std::string]
+ * @param min_time [in] [double]
+ * @param f [in] [F]
+ * @return bench_result
+ */
+template<typename F> bench_result time_it(const std::string& group, const std::string& name, double min_time, F f)
+{
+    // Shortest batch to be timed
+    constexpr double min_batch_time = 1e-3;
+
+    // Result to be returned
+    bench_result result{group, name};
+    result.min_us = std::numeric_limits<double>::max();
+
+    // Warm-up
+    f();
+
+    // Time a batch of calls
+    auto time_batch = [&f](int batch)
+    {
+        auto t0 = bench_clock::now();
+        for (int i = 0; i < batch; i++) { f(); }
+        return std::chrono::duration<double>(bench_clock::now() - t0).count();
+    };
+
+    // Calibrate the batch size
+    int batch = 1;
+    double dt = time_batch(batch);
+    while (dt < min_batch_time && dt < min_time)
+    {
+        batch *= 2;
+        dt = time_batch(batch);
+    }
+
+    // Run until the minimum time is reached, the calibration batch is the first measurement
+    while (true)
+    {
+        // Accumulate
+        result.total_s += dt;
+        result.min_us = std::min(result.min_us, dt / batch * 1e6);
+        result.iterations += batch;
+
+        // Stop
+        if (result.total_s >= min_time) { break; }
+
+        dt = time_batch(batch);
+    }
+
+    // Mean
+    result.mean_us = result.total_s / result.iterations * 1e6;
+
+    // Info
+    std::fprintf(stderr, "BENCH: %-6s %-40s %10.3f us (min %10.3f us, %d it)\n",
+                 group.c_str(), name.c_str(), result.mean_us, result.min_us, result.iterations);
+
+    return result;
+}
+
+/**
+ * Build the initial DA state: mean + beta * DA(i).
+ * @param mean [in] [std::vector<double>]
+ * @param beta [in] [std::vector<double>]
+ * @return DACE::AlgebraicVector<DACE::DA>
+ */
+DACE::AlgebraicVector<DACE::DA> initial_state(const std::vector<double>& mean, const std::vector<double>& beta)
+{
+    DACE::AlgebraicVector<DACE::DA> x(mean.size());
+    for (unsigned int i = 0; i < mean.size(); i++)
+    {
+        x[i] = mean[i] + beta[i] * DACE::DA((int) i + 1);
+    }
+    return x;
+}
+
+/**
+ * Micro-benchmarks: two-body problem kernels (LOADS algebra).
+ */
+void bench_two_body(const bench_options& opts, std::vector<bench_result>& results)
+{
+    // Same scenario as examples/translation_loads.json, normalized units
+    tools::da_context::pin(2, 6);
+    std::vector<double> mean = {0.5, 0.0, 0.0, 0.0, 1.7320508075688774, 0.0};
+    std::vector<double> beta = {3 * 7.487120281336031E-4, 3 * 0.007487120281336032, 0.0, 0.0, 0.0, 0.0};
+    auto x0 = initial_state(mean, beta);
+
+    // Build engine objects
+    problems prob(PROBLEM::TWO_BODY, 1.0);
+    integrator integ(INTEGRATOR::RK4, ALGORITHM::LOADS, 0.004090167590170333);
+    integ.set_problem_ptr(&prob);
+    integ.set_beta(beta);
+    integ.set_nli_threshold(0.02);
+    integ.set_integration_parameters(x0, 0.0, 2.356194490192345, true);
+
+    // Propagate a bit so that the checks see a non-trivial state
+    auto x = x0;
+    for (int i = 0; i < 300; i++) { x = integ.RK4_step(x, i * 0.004090167590170333, 0.004090167590170333); }
+
+    // Kernels
+    results.push_back(time_it("micro", "RK4_step/two_body", opts.min_time,
+                              [&]() { sink(integ.RK4_step(x, 0.0, 0.004090167590170333)); }));
+    results.push_back(time_it("micro", "check_loads_conditions/two_body", opts.min_time,
+                              [&]() { sink(integ.check_loads_conditions(x, false)); }));
+
+    // Split along the first direction
+    Patch p(x);
+    p.betas = beta;
+    p.algorithm_ = ALGORITHM::LOADS;
+    results.push_back(time_it("micro", "Patch::split/loads", opts.min_time,
+                              [&]() { sink(p.split(1)); }));
+
+    // Splitting history of a deep patch: history of a child and key of its siblings
+    SplittingHistory h(std::vector<int>{1, -2, 100, 2, -1, 200, 1, 2, -2});
+    results.push_back(time_it("micro", "SplittingHistory::child/depth9", opts.min_time,
+                              [&]() { sink(h.child(-1)); }));
+    results.push_back(time_it("micro", "SplittingHistory::parent/depth9", opts.min_time,
+                              [&]() { sink(h.parent()); }));
+}
+
+/**
+ * Micro-benchmarks: two-body problem kernels (ADS algebra).
+ */
+void bench_two_body_ads(const bench_options& opts, std::vector<bench_result>& results)
+{
+    // Same scenario as examples/translation_ads.json
+    tools::da_context::pin(4, 6);
+    std::vector<double> mean = {6678.135, 0.0, 0.0, 0.0, 9.462086638712861, 0.0};
+    std::vector<double> beta = {30.0, 300.0, 0.0, 0.0, 0.0, 0.0};
+    auto x0 = initial_state(mean, beta);
+
+    // Build engine objects
+    problems prob(PROBLEM::TWO_BODY, 398600.4418);
+    integrator integ(INTEGRATOR::RK4, ALGORITHM::ADS, 10.0);
+    integ.set_problem_ptr(&prob);
+    integ.set_errToll(std::vector<double>(6, 0.1));
+    integ.set_integration_parameters(x0, 0.0, 23042.522715742532, true);
+
+    // Kernels
+    results.push_back(time_it("micro", "RK4_step/two_body_order4", opts.min_time,
+                              [&]() { sink(integ.RK4_step(x0, 0.0, 10.0)); }));
+    results.push_back(time_it("micro", "taylor_step/two_body_order4", opts.min_time,
+                              [&]() { double h = 23042.522715742532; sink(integ.taylor_step(x0, h)); }));
+    results.push_back(time_it("micro", "check_ads_conditions/two_body_order4", opts.min_time,
+                              [&]() { sink(integ.check_ads_conditions(x0)); }));
+
+    // Split along the first direction
+    Patch p(x0);
+    p.algorithm_ = ALGORITHM::ADS;
+    results.push_back(time_it("micro", "Patch::split/ads", opts.min_time,
+                              [&]() { sink(p.split(1)); }));
+}
+
+/**
+ * Micro-benchmarks: free torque motion kernels.
+ */
+void bench_free_torque(const bench_options& opts, std::vector<bench_result>& results)
+{
+    // Same inertia as examples/attitude_loads.json
+    tools::da_context::pin(2, 7);
+    std::vector<double> mean = {1.0, 0.0, 0.0, 0.0, 0.01, 0.0, 0.0};
+    std::vector<double> beta = {0.0, 0.015, 0.015, 0.015, 0.0, 0.0, 0.0};
+    double inertia[3][3] = {{2040.0, 130.0, 25.0}, {130.0, 1670.0, -55.0}, {25.0, -55.0, 2570.0}};
+    auto x0 = initial_state(mean, beta);
+
+    // Build engine objects
+    problems prob(PROBLEM::FREE_TORQUE_MOTION);
+    prob.set_inertia_matrix(inertia);
+    integrator integ(INTEGRATOR::RK4, ALGORITHM::LOADS, 0.1);
+    integ.set_problem_ptr(&prob);
+    integ.set_beta(beta);
+    integ.set_nli_threshold(0.02);
+    integ.set_integration_parameters(x0, 0.0, 1000.0, true);
+
+    // Kernels
+    results.push_back(time_it("micro", "RK4_step/free_torque_motion", opts.min_time,
+                              [&]() { sink(integ.RK4_step(x0, 0.0, 0.1)); }));
+    results.push_back(time_it("micro", "taylor_step/free_torque_motion", opts.min_time,
+                              [&]() { double h = 1000.0; sink(integ.taylor_step(x0, h)); }));
+    results.push_back(time_it("micro", "check_loads_conditions/free_torque_motion", opts.min_time,
+                              [&]() { sink(integ.check_loads_conditions(x0, false)); }));
+}
+
+/**
+ * Micro-benchmarks: first- and second-order algebras, RK4 step and LOADS check of the DA state against the dense state,
+ * STM and STT.
+ */
+void bench_variational(const bench_options& opts, std::vector<bench_result>& results)
+{
+    // Same scenarios as the two-body LOADS and free torque motion ones, first order
+    tools::da_context::pin(1, 7);
+
+    // Two-body problem
+    std::vector<double> beta = {3 * 7.487120281336031E-4, 3 * 0.007487120281336032, 0.0, 0.0, 0.0, 0.0};
+    auto x0 = initial_state({0.5, 0.0, 0.0, 0.0, 1.7320508075688774, 0.0}, beta);
+    problems prob(PROBLEM::TWO_BODY, 1.0);
+    integrator integ(INTEGRATOR::RK4, ALGORITHM::LOADS, 0.004090167590170333);
+    integ.set_problem_ptr(&prob);
+    std::vector<double> linear, hessian;
+    variational::linear_state<6> y0;
+    variational::from_da(x0, y0, linear, hessian);
+
+    // Kernels
+    results.push_back(time_it("micro", "RK4_step/two_body_order1", opts.min_time,
+                              [&]() { sink(integ.RK4_step(x0, 0.0, 0.004090167590170333)); }));
+    results.push_back(time_it("micro", "variational::rk4_step/two_body", opts.min_time,
+                              [&]() { sink(variational::rk4_step<6>(prob, y0, 0.0, 0.004090167590170333)); }));
+
+    // Free torque motion
+    double inertia[3][3] = {{2040.0, 130.0, 25.0}, {130.0, 1670.0, -55.0}, {25.0, -55.0, 2570.0}};
+    auto q0 = initial_state({1.0, 0.0, 0.0, 0.0, 0.01, 0.0, 0.0}, {0.0, 0.015, 0.015, 0.015, 0.0, 0.0, 0.0});
+    problems prob_att(PROBLEM::FREE_TORQUE_MOTION);
+    prob_att.set_inertia_matrix(inertia);
+    integrator integ_att(INTEGRATOR::RK4, ALGORITHM::LOADS, 0.1);
+    integ_att.set_problem_ptr(&prob_att);
+    variational::linear_state<7> z0;
+    variational::from_da(q0, z0, linear, hessian);
+
+    // Kernels
+    results.push_back(time_it("micro", "RK4_step/free_torque_motion_order1", opts.min_time,
+                              [&]() { sink(integ_att.RK4_step(q0, 0.0, 0.1)); }));
+    results.push_back(time_it("micro", "variational::rk4_step/free_torque_motion", opts.min_time,
+                              [&]() { sink(variational::rk4_step<7>(prob_att, z0, 0.0, 0.1)); }));
+
+    // Second order, two-body problem propagated a bit so that the check sees a non-trivial state
+    tools::da_context::pin(2, 6);
+    x0 = initial_state({0.5, 0.0, 0.0, 0.0, 1.7320508075688774, 0.0}, beta);
+    integ.set_beta(beta);
+    integ.set_nli_threshold(0.02);
+    variational::quadratic_state<6> w0;
+    variational::from_da(x0, w0, linear, hessian);
+    auto x = x0;
+    auto w = w0;
+    for (int i = 0; i < 300; i++)
+    {
+        x = integ.RK4_step(x, i * 0.004090167590170333, 0.004090167590170333);
+        w = variational::rk4_step<6>(prob, w, i * 0.004090167590170333, 0.004090167590170333);
+    }
+    std::vector<double> jacobian, map_hessian;
+    variational::compose(w, linear, hessian, jacobian, map_hessian);
+
+    // Kernels
+    results.push_back(time_it("micro", "RK4_step/two_body_order2", opts.min_time,
+                              [&]() { sink(integ.RK4_step(x0, 0.0, 0.004090167590170333)); }));
+    results.push_back(time_it("micro", "variational::rk4_step/two_body_order2", opts.min_time,
+                              [&]() { sink(variational::rk4_step<6>(prob, w0, 0.0, 0.004090167590170333)); }));
+    results.push_back(time_it("micro", "check_loads_conditions/two_body_order2", opts.min_time,
+                              [&]() { sink(integ.check_loads_conditions(x, false)); }));
+    results.push_back(time_it("micro", "check_loads_conditions/two_body_tensors", opts.min_time,
+                              [&]()
+                              {
+                                  variational::compose(w, linear, hessian, jacobian, map_hessian);
+                                  sink(integ.check_loads_conditions(jacobian, map_hessian, 6, false));
+                              }));
+}
+
+/**
+ * Micro-benchmarks: evaluation of a propagated manifold and output.
+ */
+void bench_evaluation(const bench_options& opts, std::vector<bench_result>& results)
+{
+    // Scenario: LOADS two-body, analytic propagation so that building it is cheap
+    json_input specs{};
+    specs.problem = PROBLEM::TWO_BODY;
+    specs.algorithm = ALGORITHM::LOADS;
+    specs.mu = 1.0;
+    specs.algebra.order = 2;
+    specs.algebra.variables = 6;
+    specs.propagation.initial_time = 0.0;
+    specs.propagation.final_time = 2.356194490192345;
+    specs.propagation.time_step = 0.04090167590170333;
+    specs.propagation.integrator = INTEGRATOR::ANALYTIC_KEPLER;
+    specs.initial_conditions.mean = {0.5, 0.0, 0.0, 0.0, 1.7320508075688774, 0.0};
+    specs.initial_conditions.standard_deviation = {7.487120281336031E-4, 0.007487120281336032, 0.0, 0.0, 0.0, 0.0};
+    specs.initial_conditions.confidence_interval = 3.0;
+    specs.loads.nli_threshold = 0.02;
+    specs.loads.max_split = std::vector<int>(6, 10);
+    for (auto & s : specs.initial_conditions.standard_deviation) { specs.scaling.beta.push_back(3.0 * s); }
+
+    // Propagate
+    session s(specs);
+    s.propagate();
+    auto sm = s.get_super_manifold();
+    auto n_patches = sm->get_manifold_fin()->size();
+
+    // Samples
+    delta deltas_engine{};
+    deltas_engine.set_stddevs(specs.initial_conditions.standard_deviation);
+    deltas_engine.generate_deltas(DISTRIBUTION::GAUSSIAN, opts.samples);
+    deltas_engine.insert_nominal(specs.algebra.variables);
+    deltas_engine.set_superManifold(sm);
+    auto samples = deltas_engine.get_non_eval_deltas_poly();
+
+    // Single point evaluation
+    std::size_t k = 0;
+    auto r = time_it("micro", "pointEvaluationManifold", opts.min_time, [&]()
+    {
+        sink(sm->get_manifold_fin()->pointEvaluationManifold(sm->previous_->front(), samples->at(k++ % samples->size()),
+                                                              1));
+    });
+    r.patches = n_patches;
+    results.push_back(r);
+
+    // Walls evaluation
+    r = time_it("micro", "wallsPointEvaluationManifold", opts.min_time,
+                [&]() { sink(sm->get_manifold_fin()->wallsPointEvaluationManifold()); });
+    r.patches = n_patches;
+    results.push_back(r);
+
+    // Batch evaluation
+    r = time_it("micro", tools::string::print2string("delta::evaluate_deltas/%d", opts.samples), opts.min_time,
+                [&]() { deltas_engine.evaluate_deltas(); });
+    r.patches = n_patches;
+    results.push_back(r);
+
+    // Batch evaluation, stratified samples: no point location
+    delta stratified_engine{};
+    stratified_engine.set_superManifold(sm);
+    stratified_engine.set_stddevs(specs.initial_conditions.standard_deviation);
+    stratified_engine.generate_deltas(DISTRIBUTION::STRATIFIED, opts.samples);
+    stratified_engine.insert_nominal(specs.algebra.variables);
+    r = time_it("micro", tools::string::print2string("delta::evaluate_deltas/stratified/%d", opts.samples),
+                opts.min_time, [&]() { stratified_engine.evaluate_deltas(); });
+    r.patches = n_patches;
+    results.push_back(r);
+
+    // Dump evaluated deltas
+    auto dump_path = std::filesystem::temp_directory_path() / "verneda_bench_eval_deltas.dat";
+    results.push_back(time_it("micro", tools::string::print2string("dump_eval_deltas/%d", opts.samples), opts.min_time,
+                              [&]() { tools::io::dace::dump_eval_deltas(&deltas_engine, dump_path); }));
+    std::filesystem::remove(dump_path);
+}
+
+/**
+ * Macro-benchmarks: end-to-end propagation of every example.
+ */
+void bench_examples(const bench_options& opts, std::vector<bench_result>& results)
+{
+    // Collect examples, sorted so that the output is stable
+    std::vector<std::filesystem::path> examples;
+    for (const auto& entry : std::filesystem::directory_iterator(opts.examples_dir))
+    {
+        if (entry.path().extension() == ".json") { examples.push_back(entry.path()); }
+    }
+    std::sort(examples.begin(), examples.end());
+
+    // Random engine for the samples, fixed seed
+    std::mt19937 gen(42);
+
+    for (const auto& example : examples)
+    {
+        // Parse and shorten the propagation if requested
+        auto specs = json_parser::parse_input_file(example);
+        auto& prop = specs.propagation;
+        prop.final_time = prop.initial_time + opts.fraction * (prop.final_time - prop.initial_time);
+
+        try
+        {
+            // Build and propagate
+            auto t0 = bench_clock::now();
+            session s(specs);
+            s.propagate();
+            double t_prop = std::chrono::duration<double>(bench_clock::now() - t0).count();
+            auto n_patches = s.get_manifold_fin()->size();
+
+            // Samples: Gaussian in the DA box (sigma = beta / confidence interval)
+            auto nvar = (unsigned int) specs.algebra.variables;
+            double ci = specs.initial_conditions.confidence_interval > 0 ? specs.initial_conditions.confidence_interval : 1.0;
+            std::vector<DACE::AlgebraicVector<double>> samples(opts.samples, DACE::AlgebraicVector<double>(nvar));
+            for (auto& sample : samples)
+            {
+                for (unsigned int i = 0; i < nvar; i++)
+                {
+                    sample[i] = std::normal_distribution<double>(0.0, specs.scaling.beta[i] / ci)(gen);
+                }
+            }
+
+            // Evaluate
+            t0 = bench_clock::now();
+            s.evaluate(samples);
+            double t_eval = std::chrono::duration<double>(bench_clock::now() - t0).count();
+
+            // Save
+            auto name = example.stem().string();
+            results.push_back({"macro", name + "/propagate", 1, t_prop, t_prop * 1e6, t_prop * 1e6, n_patches});
+            results.push_back({"macro", name + tools::string::print2string("/evaluate/%d", opts.samples), 1,
+                               t_eval, t_eval * 1e6, t_eval * 1e6, n_patches});
+
+            // Info
+            std::fprintf(stderr, "BENCH: macro  %-40s %10.3f s propagation, %10.3f s evaluation, %zu patches\n",
+                         name.c_str(), t_prop, t_eval, n_patches);
+        }
+        catch (const std::exception& e)
+        {
+            std::fprintf(stderr, "BENCH: macro  %s skipped: %s\n", example.filename().c_str(), e.what());
+        }
+    }
+}
+
+/**
+ * Stress test of the DA execution context: the same patches are integrated serially and then by several workers at
+ * once, each one with its own integrator and problem. Every result must be identical bit by bit.
+ * @return number of mismatching results
+ */
+std::size_t stress_da_context(const bench_options& opts, std::vector<bench_result>& results)
+{
+    // Same scenario as examples/translation_ads.json, with the adaptive order so that the truncation order moves
+    tools::da_context::pin(4, 6);
+    tools::da_context::set_eps(1e-40);
+    std::vector<double> mean = {6678.135, 0.0, 0.0, 0.0, 9.462086638712861, 0.0};
+    std::vector<double> beta = {30.0, 300.0, 0.0, 0.0, 0.0, 0.0};
+    auto x0 = initial_state(mean, beta);
+
+    // Patches: the initial box split twice along the first two directions
+    std::vector<Patch> patches{Patch(x0)};
+    patches.front().algorithm_ = ALGORITHM::ADS;
+    for (int dir : {1, 2, 1, 2})
+    {
+        std::vector<Patch> children;
+        for (auto& p : patches)
+        {
+            auto s = p.split(dir);
+            children.insert(children.end(), s.begin(), s.end());
+        }
+        patches = children;
+    }
+
+    // Engine objects of a worker
+    struct engine
+    {
+        std::unique_ptr<problems> prob;
+        std::unique_ptr<integrator> integ;
+    };
+    auto build = [&]()
+    {
+        engine e{std::make_unique<problems>(PROBLEM::TWO_BODY, 398600.4418),
+                 std::make_unique<integrator>(INTEGRATOR::RK4, ALGORITHM::ADS, 10.0)};
+        e.integ->set_problem_ptr(e.prob.get());
+        e.integ->set_errToll(std::vector<double>(6, 0.1));
+        e.integ->set_adaptive_order(2);
+        e.integ->set_integration_parameters(x0, 0.0, 23042.522715742532, true);
+        return e;
+    };
+
+    // Integrate one patch up to its split or the final time
+    auto integrate = [&](engine& e, std::size_t k)
+    {
+        const auto& p = patches[k % patches.size()];
+        e.integ->t_ = 0.0;
+        e.integ->set_order(0);
+        auto x = e.integ->integrate(p, (int) k);
+
+        // The truncation order must be back
+        tools::da_context::validate();
+
+        return x;
+    };
+
+    // Serial reference
+    auto n_tasks = patches.size() * (std::size_t) opts.stress_repeats;
+    std::vector<DACE::AlgebraicVector<DACE::DA>> serial(patches.size());
+    auto serial_engine = build();
+    auto t0 = bench_clock::now();
+    for (std::size_t k = 0; k < patches.size(); k++)
+    {
+        serial[k] = integrate(serial_engine, k);
+    }
+    double t_serial = std::chrono::duration<double>(bench_clock::now() - t0).count();
+
+    // Every patch several times, on every worker at once
+    std::vector<engine> engines;
+    for (unsigned int w = 0; w < opts.stress_threads; w++) { engines.push_back(build()); }
+    std::vector<DACE::AlgebraicVector<DACE::DA>> parallel(n_tasks);
+    t0 = bench_clock::now();
+    tools::da_context::parallel_for(n_tasks, opts.stress_threads, [&](std::size_t k, unsigned int w)
+    {
+        parallel[k] = integrate(engines[w], k);
+    });
+    double t_parallel = std::chrono::duration<double>(bench_clock::now() - t0).count();
+
+    // Compare
+    std::size_t mismatches = 0;
+    for (std::size_t k = 0; k < n_tasks; k++)
+    {
+        const auto& ref = serial[k % patches.size()];
+        bool same = parallel[k].size() == ref.size();
+        for (unsigned int i = 0; same && i < ref.size(); i++)
+        {
+            same = (parallel[k][i] - ref[i]).norm(0) == 0.0;
+        }
+        mismatches += same ? 0 : 1;
+    }
+
+    // Nothing pinned may have changed in this thread either
+    tools::da_context::validate();
+
+    // Save
+    results.push_back({"stress", tools::string::print2string("da_context/serial/%zu", patches.size()), 1, t_serial,
+                       t_serial * 1e6, t_serial * 1e6, patches.size()});
+    results.push_back({"stress", tools::string::print2string("da_context/threads_%d/%zu", opts.stress_threads,
+                                                             n_tasks), 1, t_parallel, t_parallel * 1e6,
+                       t_parallel * 1e6, n_tasks});
+
+    // Info
+    std::fprintf(stderr, "BENCH: stress %zu patches serially in %.3f s, %zu on %d threads in %.3f s, %zu mismatches\n",
+                 patches.size(), t_serial, n_tasks, opts.stress_threads, t_parallel, mismatches);
+
+    return mismatches;
+}
+
+/**
+ * Heap in use, in bytes: small chunks plus mapped ones.
+ * @return std::size_t
+ */
+std::size_t heap_in_use()
+{
+    auto info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+/**
+ * Leak check: every example is propagated and evaluated 'runs' times in one process, the objects of each scenario
+ * built in an arena released at the end of it. The first run warms the caches up (DACE, streams), the heap in use at
+ * the end of the last one must be the same.
+ * @return heap growth since the first run, in bytes
+ */
+long leak_check(const bench_options& opts, std::vector<bench_result>& results)
+{
+    // Examples, sorted so that every run is the same
+    std::vector<json_input> examples;
+    for (const auto& entry : std::filesystem::directory_iterator(opts.examples_dir))
+    {
+        if (entry.path().extension() != ".json") { continue; }
+        auto specs = json_parser::parse_input_file(entry.path());
+        auto& prop = specs.propagation;
+        prop.final_time = prop.initial_time + opts.fraction * (prop.final_time - prop.initial_time);
+        examples.push_back(specs);
+    }
+    std::sort(examples.begin(), examples.end(), [](const json_input& a, const json_input& b)
+    {
+        return a.filepath < b.filepath;
+    });
+
+    // Heap after every run, reserved so that it does not count itself
+    std::vector<std::size_t> heap;
+    heap.reserve(opts.leak_runs);
+    std::size_t patches = 0;
+    auto t0 = bench_clock::now();
+    for (int run = 0; run < opts.leak_runs; run++)
+    {
+        for (const auto& specs : examples)
+        {
+            // Objects of this scenario
+            tools::arena arena{};
+
+            try
+            {
+                // Propagate
+                auto s = arena.make<session>(specs);
+                s->propagate();
+                patches += s->get_manifold_fin()->size();
+
+                // Attitude manifolds, built as the drivers do
+                if (specs.problem == PROBLEM::FREE_TORQUE_MOTION)
+                {
+                    s->get_super_manifold()->set_6dof_domain();
+                }
+
+                // Evaluate: fixed samples at the corners of the box
+                auto nvar = (unsigned int) specs.algebra.variables;
+                std::vector<DACE::AlgebraicVector<double>> samples(opts.samples, DACE::AlgebraicVector<double>(nvar));
+                for (std::size_t k = 0; k < samples.size(); k++)
+                {
+                    for (unsigned int i = 0; i < nvar; i++)
+                    {
+                        samples[k][i] = (((k >> i) & 1) ? 0.5 : -0.5) * specs.scaling.beta[i];
+                    }
+                }
+                s->evaluate(samples);
+            }
+            catch (const std::exception& e)
+            {
+                if (run == 0)
+                {
+                    std::fprintf(stderr, "BENCH: leak   %s skipped: %s\n", specs.filepath.c_str(), e.what());
+                }
+            }
+        }
+
+        // Every object of the run is gone
+        heap.push_back(heap_in_use());
+        std::fprintf(stderr, "BENCH: leak   run %d: %zu bytes in use\n", run + 1, heap.back());
+    }
+    double t = std::chrono::duration<double>(bench_clock::now() - t0).count();
+
+    // Growth after the warm-up run
+    long growth = heap.empty() ? 0 : (long) heap.back() - (long) heap.front();
+
+    // Save
+    results.push_back({"leak", tools::string::print2string("runs_%d/examples_%zu", opts.leak_runs, examples.size()),
+                       opts.leak_runs, t, t / opts.leak_runs * 1e6, t / opts.leak_runs * 1e6, patches});
+
+    // Info
+    std::fprintf(stderr, "BENCH: leak   %d runs of %zu examples in %.3f s, heap growth after the first run: %ld bytes\n",
+                 opts.leak_runs, examples.size(), t, growth);
+
+    return growth;
+}
+
+/**
+ * Write results in the requested format.
+ */
+void write_results(const bench_options& opts, const std::vector<bench_result>& results)
+{
+    // Open file
+    std::ofstream file(opts.output);
+
+    // Safety check
+    if (!file.is_open())
+    {
+        std::fprintf(stderr, "verneda_bench: cannot open output file '%s'.\n", opts.output.c_str());
+        std::exit(2);
+    }
+
+    if (opts.format == "csv")
+    {
+        file << "group,name,iterations,total_s,mean_us,min_us,patches" << std::endl;
+        for (const auto& r : results)
+        {
+            file << tools::string::print2string("%s,%s,%d,%.9f,%.6f,%.6f,%zu",
+                                                r.group.c_str(), r.name.c_str(), r.iterations, r.total_s,
+                                                r.mean_us, r.min_us, r.patches) << std::endl;
+        }
+    }
+    else
+    {
+        file << "{" << std::endl;
+        file << tools::string::print2string("  \"version\": \"%s\",", CODE_VERSION) << std::endl;
+        file << tools::string::print2string("  \"git_hash\": \"%s\",", GIT_HASH) << std::endl;
+        file << tools::string::print2string("  \"date\": \"%s\",", HeaderInfo::get_current_date().c_str()) << std::endl;
+        file << tools::string::print2string("  \"fraction\": %.6f,", opts.fraction) << std::endl;
+        file << "  \"results\": [" << std::endl;
+        for (std::size_t k = 0; k < results.size(); k++)
+        {
+            const auto& r = results[k];
+            file << tools::string::print2string(
+                    "    {\"group\": \"%s\", \"name\": \"%s\", \"iterations\": %d, \"total_s\": %.9f, "
+                    "\"mean_us\": %.6f, \"min_us\": %.6f, \"patches\": %zu}%s",
+                    r.group.c_str(), r.name.c_str(), r.iterations, r.total_s, r.mean_us, r.min_us, r.patches,
+                    k + 1 < results.size() ? "," : "") << std::endl;
+        }
+        file << "  ]" << std::endl;
+        file << "}" << std::endl;
+    }
+
+    std::fprintf(stderr, "BENCH: results written in '%s'.\n", opts.output.c_str());
+}
+
+/**
+ * Parse command line options.
+ */
+bench_options parse_options(int argc, char* argv[])
+{
+    bench_options opts{};
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (arg == "--micro-only") { opts.macro = false; }
+        else if (arg == "--macro-only") { opts.micro = false; }
+        else if (arg == "--examples" && has_value) { opts.examples_dir = argv[++i]; }
+        else if (arg == "--fraction" && has_value) { opts.fraction = std::stod(argv[++i]); }
+        else if (arg == "--min-time" && has_value) { opts.min_time = std::stod(argv[++i]); }
+        else if (arg == "--samples" && has_value) { opts.samples = std::stoi(argv[++i]); }
+        else if (arg == "--output" && has_value) { opts.output = argv[++i]; }
+        else if (arg == "--format" && has_value) { opts.format = argv[++i]; }
+        else if (arg == "--stress" && has_value) { opts.stress_threads = std::stoi(argv[++i]); }
+        else if (arg == "--repeats" && has_value) { opts.stress_repeats = std::stoi(argv[++i]); }
+        else if (arg == "--leak-check" && has_value) { opts.leak_runs = std::stoi(argv[++i]); }
+        else
+        {
+            std::fprintf(stderr, "Usage: %s [--micro-only | --macro-only] [--examples <dir>] [--fraction <f>] "
+                                 "[--min-time <s>] [--samples <n>] [--output <file>] [--format json|csv] "
+                                 "[--stress <threads>] [--repeats <n>] [--leak-check <runs>]\n", argv[0]);
+            std::exit(1);
+        }
+    }
+
+    // Safety checks
+    if (opts.fraction <= 0.0 || opts.samples <= 0 || opts.stress_repeats <= 0 || opts.leak_runs < 0 ||
+        (opts.format != "json" && opts.format != "csv"))
+    {
+        std::fprintf(stderr, "verneda_bench: fraction, samples and repeats must be positive, leak runs not negative, "
+                             "format 'json' or 'csv'.\n");
+        std::exit(1);
+    }
+
+    return opts;
+}
+
+/**
+ * Main entry point
+ */
+int main(int argc, char* argv[])
+{
+    // Parse options
+    auto opts = parse_options(argc, argv);
+
+    // Remove warnings
+    DACE::DACEException::setWarning(false);
+
+    // Results
+    std::vector<bench_result> results;
+
+    // Stress test only: the exit code tells whether every result matched
+    if (opts.stress_threads > 0)
+    {
+        auto mismatches = stress_da_context(opts, results);
+        write_results(opts, results);
+        return mismatches == 0 ? 0 : 1;
+    }
+
+    // Leak check only: the exit code tells whether the heap grew
+    if (opts.leak_runs > 0)
+    {
+        // Freed chunks kept in the glibc caches count as in use: start again without them
+        if (std::getenv("GLIBC_TUNABLES") == nullptr)
+        {
+            setenv("GLIBC_TUNABLES", "glibc.malloc.tcache_count=0:glibc.malloc.mxfast=0", 1);
+            execv("/proc/self/exe", argv);
+        }
+
+        auto growth = leak_check(opts, results);
+        write_results(opts, results);
+        return growth <= 0 ? 0 : 1;
+    }
+
+    // Micro-benchmarks, each one in its own algebra
+    if (opts.micro)
+    {
+        bench_two_body(opts, results);
+        bench_two_body_ads(opts, results);
+        bench_free_torque(opts, results);
+        bench_variational(opts, results);
+        bench_evaluation(opts, results);
+    }
+
+    // Macro-benchmarks
+    if (opts.macro)
+    {
+        bench_examples(opts, results);
+    }
+
+    // Write results
+    write_results(opts, results);
+
+    return 0;
+}
@@ -7,7 +7,7 @@
 
 // Project libraries
 #include "base/Header_Info.h"
-#include "ads/SuperManifold.h"
+#include "session.h"
 #include "tools/io.h"
 #include "json/json_parser.h"
 #include "specs/args_input.h"
@@ -29,6 +29,15 @@ int main(int argc, char* argv[])
     // Process arguments
     args_in.run_arguments(header_info);
 
+    // Enable profiler if requested
+    tools::profiler::set_enabled(args_in.profile);
+
+    // Open trace if requested, it is written at exit
+    if (!args_in.trace_filepath.empty())
+    {
+        tools::trace::open(args_in.trace_filepath);
+    }
+
     // Print ASCII BANNER
     header_info.print_header_info();
 
@@ -38,110 +47,42 @@ int main(int argc, char* argv[])
     // Create my_specs object
     auto my_specs = json_parser::parse_input_file(args_in.json_filepath);
 
-    // Initialize DACE with 6 variables
-    DACE::DA::init(my_specs.algebra.order, my_specs.algebra.variables);
-
-    // Set initial state
-    DACE::AlgebraicVector<DACE::DA> scv0 = {
-            my_specs.initial_conditions.mean[0] + my_specs.scaling.beta[0] * DACE::DA(1),
-            my_specs.initial_conditions.mean[1] + my_specs.scaling.beta[1] * DACE::DA(2),
-    };
-
-    std::cout << scv0 << std::endl;
-
-    // Declare and initialize class
-    auto s0 = std::make_unique<scv>(scv0);
-
-    // Now, should initialize all the dace variables from the initial conditions
-    auto scv0_DA = s0->get_state_vector_copy();
-
-    // Initial and final time and time step
-    double const t0 = my_specs.propagation.initial_time;
-    double const tf = my_specs.propagation.final_time;
-    double const dt = my_specs.propagation.time_step;
-
-    // Initialize integrator
-    auto objIntegrator = std::make_unique<integrator>(my_specs.propagation.integrator, my_specs.algorithm, dt);
-
-    // Deduce whether interruption feature shall be made or not
-    bool interruption = false;
-
-    // Define problem to solve
-    problems* prob;
-
-    // Create an empty SuperManifold to be filled in the switch case
-    SuperManifold* super_manifold;
-
-    // Build super manifold
-    switch (my_specs.algorithm)
+    // Sweeps are run by 'dace_batch', which shares the common work of their cases
+    if (my_specs.sweep.set)
     {
-        case ALGORITHM::ADS:
-        {
-            // Build super manifold: ADS
-            super_manifold = new SuperManifold(my_specs.ads.tolerance,my_specs.ads.max_split[0], ALGORITHM::ADS);
-
-            // Define problem
-            prob = new problems(my_specs.problem, my_specs.mu);
-
-            // Deduce whether interruption should be made or not
-            interruption = !my_specs.ads.max_split.empty() && my_specs.ads.max_split[0] > 0;
-
-            // Exit switch case
-            break;
-        }
-        case ALGORITHM::LOADS:
-        {
-            // Build super manifold: LOADS
-            super_manifold = new SuperManifold(my_specs.loads.nli_threshold, my_specs.loads.max_split[0], ALGORITHM::LOADS);
-
-            // Set beta constant in integrator
-            objIntegrator->set_beta(my_specs.scaling.beta);
-
-            // Initialize problem
-            prob = new problems(my_specs.problem, my_specs.mu);
-
-            // Deduce whether interruption should be made or not
-            interruption = !my_specs.loads.max_split.empty() && my_specs.loads.max_split[0] > 0;
-
-            // Exit switch case
-            break;
-        }
-        case ALGORITHM::NONE:
-        {
-            // NONE algorithm is equivalent to Splitting algorithms but with interruption mode DISABLED
-            super_manifold = new SuperManifold(ALGORITHM::NONE);
-
-            // Initialize problem
-            prob = new problems(my_specs.problem, my_specs.mu);
-
-            // Exit switch case
-            break;
-        }
-        default:
-        {
-            // TODO: Show some errors here
-            std::exit(20);
-        }
+        std::fprintf(stderr, "The input has a 'sweep' section, run it with 'dace_batch'. JSON file: '%s'\n",
+                     my_specs.filepath.c_str());
+        std::exit(10);
     }
 
-    // Set problem ptr in the integrator
-    objIntegrator->set_problem_ptr(prob);
+    // Build the run: DACE, problem, integrator and super manifold
+    session run(my_specs);
+    auto super_manifold = run.get_super_manifold();
 
-    // Setting integrator parameters
-    objIntegrator->set_integration_parameters(scv0_DA, t0, tf,interruption);
+    std::cout << run.get_initial_state() << std::endl;
 
-    // Set integrator in the super manifold
-    super_manifold->set_integrator_ptr(objIntegrator.get());
-
-    // Docu: Set new truncation error and get the previous one
-    double new_eps = 1e-40;
-    double previous_eps = DACE::DA::setEps(new_eps);
+    // Periodic checkpoints if requested
+    if (!args_in.checkpoint_filepath.empty())
+    {
+        super_manifold->set_checkpoint({args_in.checkpoint_filepath, args_in.checkpoint_interval});
+    }
 
-    // Show to the used the new epsilon value
-    std::fprintf(stdout, "Epsilon update: Previous: '%1.16f', New: '%1.16f'\n", previous_eps, new_eps);
+    // Spill the segments to disk if requested
+    if (!args_in.spill_dir.empty())
+    {
+        super_manifold->set_segment_spill_dir(args_in.spill_dir);
+    }
 
-    // Apply main algorithm: ADS / LOADS. And integration algorithm
-    super_manifold->split_domain();
+    // Apply main algorithm: ADS / LOADS. And integration algorithm, unless the propagation is cached
+    if (args_in.resume_filepath.empty())
+    {
+        run.set_cache({args_in.cache_dir, GIT_HASH});
+        run.propagate();
+    }
+    else
+    {
+        run.resume(args_in.resume_filepath);
+    }
 
     // Build deltas class
     auto deltas_engine = std::make_shared<delta>();
@@ -168,6 +109,13 @@ int main(int argc, char* argv[])
     writer.set_dump_nominal_results(true, true);
     // writer.set_dump_frames_results(true, true);
 
+    // Gaussian mixture of the final manifold if requested
+    if (my_specs.mixture.set)
+    {
+        writer.set_dump_mixture_results({(std::size_t) my_specs.mixture.components, my_specs.mixture.binary,
+                                         my_specs.mixture.json, my_specs.initial_conditions.confidence_interval});
+    }
+
     // Write files
     writer.write_files(deltas_engine.get(), my_specs.output_dir);
 
@@ -180,6 +128,4 @@ int main(int argc, char* argv[])
 
     // Process files
     fproc.process_files();
-
-    // TODO: Destroy here all the stuff to avoid mem-leaks
 }
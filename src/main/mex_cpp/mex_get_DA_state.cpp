@@ -1,5 +1,5 @@
 /**
- * Only return DA vector
+ * Only return DA vector, as a numeric coefficient array (see mex_aux::packDAVectors)
  */
 // MEX thingy
 #include "mex.hpp"
@@ -43,29 +43,16 @@ public:
             auto scv0 = DACE::AlgebraicVector<DACE::DA>(ini_state.size());
             for (int i = 0; i < ini_state.size(); i++) { scv0[i] = ini_state[i] + betas[i] * DACE::DA(i + 1); }
 
-            // Return DA vector as str
-            outputs[0] = this->convertDAVector2MatlabStr(scv0);
+            // Return DA vector as numeric coefficients: [n_mono x n_var] and the monomial exponents
+            outputs[0] = mex_aux::packDAVectors(*this->factoryPtr, {scv0});
+            if (outputs.size() > 1)
+            {
+                outputs[1] = mex_aux::packMonomialExponents(*this->factoryPtr);
+            }
         }
         catch (int) {
             std::fprintf(stdout, "ERROR: Something unexpected happened...");
         }
     }
 
-    template<class T>
-    matlab::data::TypedArray<matlab::data::MATLABString> convertDAVector2MatlabStr(const DACE::AlgebraicVector<T>& da_vector)
-    {
-        std::u16string u16_String{};
-        // Attention: this line is sensitive to MATLAB versions
-        auto result = this->factoryPtr->createArray<matlab::data::MATLABString>({6, 1});
-
-        for (unsigned int i = 0; i < (unsigned int ) da_vector.size(); i++)
-        {
-            // Convert format
-            mex_aux::fromUTF8(da_vector[i].toString(), u16_String);
-            // Fill result
-            result[i] = u16_String;
-        }
-        return result;
-    }
-
 };
\ No newline at end of file
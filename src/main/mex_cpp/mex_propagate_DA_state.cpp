@@ -13,6 +13,7 @@
 
 // Project libraries
 #include "ads/SuperManifold.h"
+#include "tools/arena.h"
 
 class MexFunction : public matlab::mex::Function {
 
@@ -33,60 +34,44 @@ public:
             // mex_aux::checkArguments(outputs, inputs, MEX_FILE_TYPE::GET_DA);
 
             // Extract inputs -----------
-            auto state_str = mex_aux::convertMatlabStrVector2NormalStrVector(inputs[0]);
+            matlab::data::TypedArray<double> state_coeffs = inputs[0];
             auto betas = mex_aux::convertMatlabTypedArray2NormalVector(inputs[1]);
             auto t = mex_aux::convertMatlabTypedArray2NormalVector(inputs[2]);
             auto nli = mex_aux::convertMatlabDouble2NormalDouble(inputs[3]);
 
-            // Initialize DACE with 6 variables
-            DACE::DA::init(2, state_str.size());
+            // Initialize DACE with as many variables as components: [n_mono x n_var]
+            auto dims = state_coeffs.getDimensions();
+            DACE::DA::init(2, dims[1]);
 
-            // Convert state to DA vector
-            auto state_DA = DACE::AlgebraicVector<DACE::DA>(state_str.size());
+            // Monomial exponents are optional, the default basis is assumed otherwise
+            auto exponents = inputs.size() > 4 ?
+                    matlab::data::TypedArray<uint32_t>(inputs[4]) :
+                    this->factoryPtr->createArray<uint32_t>({0, 0});
 
-            for (int i = 0; i < state_str.size(); i++) {
-                state_DA[i] = DACE::DA::fromString(state_str[i]);
-            }
+            // Convert state to DA vector
+            auto state_DA = mex_aux::unpackDAVectors(state_coeffs, exponents).front();
 
             // Perform logic here -----------
-            // Now we can propagate
-            auto final_manifold = propagate_orbit_loads_SUPER_MANIFOLD(state_DA, betas, t, nli);
-
-            // Return DA vector as str
-            outputs[0] = this->convertManifoldVector2MatlabStr(final_manifold->current_);
+            // Now we can propagate: objects of this call, released all together on return
+            tools::arena run{};
+            auto final_manifold = propagate_orbit_loads_SUPER_MANIFOLD(run, state_DA, betas, t, nli);
+
+            // Return every patch as numeric coefficients: [n_mono x n_var x n_patches] and the monomial exponents
+            std::vector<DACE::AlgebraicVector<DACE::DA>> patches(final_manifold->current_->begin(),
+                                                                 final_manifold->current_->end());
+            outputs[0] = mex_aux::packDAVectors(*this->factoryPtr, patches);
+            if (outputs.size() > 1)
+            {
+                outputs[1] = mex_aux::packMonomialExponents(*this->factoryPtr);
+            }
         }
         catch (int) {
             std::fprintf(stdout, "ERROR: Something unexpected happened...");
         }
     }
 
-
-    matlab::data::TypedArray<matlab::data::MATLABString> convertManifoldVector2MatlabStr(Manifold* manifold)
-    {
-        std::vector<DACE::DA> da_vector;
-        std::u16string u16_String{};
-        // Attention: this line is sensitive to MATLAB versions
-        auto result = this->factoryPtr->createArray<matlab::data::MATLABString>({6, manifold->size()});
-
-        for (int j = 0; j < manifold->size(); j++)
-        {
-            // Get DA vector
-            da_vector = manifold->at(j);
-
-            for (unsigned int i = 0; i < (unsigned int ) da_vector.size(); i++)
-            {
-                // Convert format
-                mex_aux::fromUTF8(da_vector[i].toString(), u16_String);
-                // Fill result
-                result[i][j] = u16_String;
-            }
-        }
-
-        return result;
-    }
-
     static SuperManifold *
-    propagate_orbit_loads_SUPER_MANIFOLD(const DACE::AlgebraicVector<DACE::DA> scv, std::vector<double> betas, std::vector<double> t, double nli)
+    propagate_orbit_loads_SUPER_MANIFOLD(tools::arena& run, const DACE::AlgebraicVector<DACE::DA> scv, std::vector<double> betas, std::vector<double> t, double nli)
     {
         // Initial and final time and time step
         double const t0 = t[0];
@@ -94,17 +79,17 @@ public:
         double const dt = t[2];
 
         // Initialize integrator
-        auto objIntegrator = std::make_unique<integrator>(INTEGRATOR::RK4, ALGORITHM::LOADS, dt);
+        auto objIntegrator = run.make<integrator>(INTEGRATOR::RK4, ALGORITHM::LOADS, dt);
 
         // Build super manifold: LOADS
-        auto super_manifold = new SuperManifold(nli, 10, ALGORITHM::LOADS);
+        auto super_manifold = run.make<SuperManifold>(nli, 10, ALGORITHM::LOADS);
 
         // Set beta constant in integrator
         objIntegrator->set_beta(betas);
 
         // Initialize problem
         problems *problem;
-        problem = new problems(PROBLEM::TWO_BODY, 1);
+        problem = run.make<problems>(PROBLEM::TWO_BODY, 1);
 
         // Deduce whether interruption should be made or not
         auto interruption = true;
@@ -116,7 +101,7 @@ public:
         objIntegrator->set_integration_parameters(scv, t0, tf, interruption);
 
         // Set integrator in the super manifold
-        super_manifold->set_integrator_ptr(objIntegrator.get());
+        super_manifold->set_integrator_ptr(objIntegrator);
 
         // Docu: Set new truncation error and get the previous one
         double new_eps = 1e-40;
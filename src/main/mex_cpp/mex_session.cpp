@@ -0,0 +1,308 @@
+/**
+ * Persistent propagation sessions to be embedded in matlab. The propagated manifold is kept alive between calls and
+ * accessed through an opaque handle, so that it can be queried many times without propagating it again.
+ *
+ * Usage (all commands are MATLAB strings):
+ *  h = mex_session("create", ini_state, stddev, [t0, tf, dt], ci, nli, int16(n_max), "tbp"|"ftmp", [inertia]);
+ *  y = mex_session("evaluate", h, deltas);     % deltas: [n_var x n_samples] deviations from ini_state
+ *      mex_session("extend", h, tf);
+ *  p = mex_session("patches", h);              % struct array: id, history, center, width, t, nli, state
+ *  g = mex_session("mixture", h, [n]);         % struct array: weight, mean, covariance; merged down to n components
+ *      mex_session("free", h);
+ *  l = mex_session("list");
+ */
+
+// MEX thingy
+#include "mex.hpp"
+#include "mexAdapter.hpp"
+
+// MEX aux library
+#include "tools/mex_aux.h"
+
+// DACE libraries
+#include "dace/dace.h"
+
+// Project libraries
+#include "session.h"
+#include "ads/mixture.h"
+
+class MexFunction : public matlab::mex::Function {
+
+private:
+    // Get pointer to engine
+    std::shared_ptr<matlab::engine::MATLABEngine> matlabPtr = getEngine();
+
+    // Get array factory
+    std::shared_ptr<matlab::data::ArrayFactory> factoryPtr;
+
+public:
+    void operator()(matlab::mex::ArgumentList outputs, matlab::mex::ArgumentList inputs) override
+    {
+        // Set factory
+        this->factoryPtr = std::make_shared<matlab::data::ArrayFactory>();
+
+        // Safety check
+        if (inputs.empty())
+        {
+            this->throw_error("mex_session: a command is required: create, evaluate, extend, patches, mixture, free "
+                              "or list.");
+        }
+
+        // Get the command
+        auto command = mex_aux::convertMatlabStr2NormalStr(inputs[0]);
+
+        try
+        {
+            if (command == "create")
+            {
+                this->require_arguments(inputs, 8, command);
+                outputs[0] = this->factoryPtr->createScalar<uint64_t>(this->create(inputs));
+            }
+            else if (command == "evaluate")
+            {
+                this->require_arguments(inputs, 3, command);
+                outputs[0] = this->evaluate(inputs);
+            }
+            else if (command == "extend")
+            {
+                this->require_arguments(inputs, 3, command);
+                this->get_session(inputs)->extend(mex_aux::convertMatlabDouble2NormalDouble(inputs[2]));
+            }
+            else if (command == "patches")
+            {
+                outputs[0] = this->patches(inputs);
+            }
+            else if (command == "mixture")
+            {
+                outputs[0] = this->mixture(inputs);
+            }
+            else if (command == "free")
+            {
+                session_registry::erase(this->get_handle(inputs));
+            }
+            else if (command == "list")
+            {
+                auto handles = session_registry::handles();
+                outputs[0] = this->factoryPtr->createArray<uint64_t>({1, handles.size()}, handles.data(),
+                                                                     handles.data() + handles.size());
+            }
+            else
+            {
+                this->throw_error("mex_session: unknown command '" + command + "'.");
+            }
+        }
+        catch (const std::exception& e)
+        {
+            this->throw_error(e.what());
+        }
+    }
+
+    std::uint64_t create(matlab::mex::ArgumentList& inputs)
+    {
+        // Extract inputs
+        auto ini_state = mex_aux::convertMatlabTypedArray2NormalVector(inputs[1]);
+        auto stddev = mex_aux::convertMatlabTypedArray2NormalVector(inputs[2]);
+        auto t = mex_aux::convertMatlabTypedArray2NormalVector(inputs[3]);
+        auto ci = mex_aux::convertMatlabDouble2NormalDouble(inputs[4]);
+        auto nli = mex_aux::convertMatlabDouble2NormalDouble(inputs[5]);
+        auto n_max = mex_aux::convertMatlabInt2NormalInt(inputs[6]);
+        auto str_alg = mex_aux::convertMatlabStr2NormalStr(inputs[7]);
+
+        // Safety check
+        if (t.size() != 3)
+        {
+            this->throw_error("mex_session: the times must be [t0, tf, dt].");
+        }
+
+        // Fill specifications, same defaults as mex_vsaod
+        json_input specs{};
+        specs.problem =
+                str_alg == "tbp" ? PROBLEM::TWO_BODY :
+                str_alg == "ftmp" ? PROBLEM::FREE_TORQUE_MOTION : PROBLEM::NA;
+        specs.algorithm = n_max == -1 ? ALGORITHM::NONE : ALGORITHM::LOADS;
+        specs.mu = 1.0;
+        specs.algebra.order = 2;
+        specs.algebra.variables = (int) ini_state.size();
+        specs.propagation.initial_time = t[0];
+        specs.propagation.final_time = t[1];
+        specs.propagation.time_step = t[2];
+        specs.propagation.integrator = INTEGRATOR::RK4;
+        specs.initial_conditions.mean = ini_state;
+        specs.initial_conditions.standard_deviation = stddev;
+        specs.initial_conditions.confidence_interval = ci;
+        specs.loads.nli_threshold = nli;
+        specs.loads.max_split = std::vector<int>(ini_state.size(), n_max);
+
+        // Betas
+        for (auto & s : stddev) { specs.scaling.beta.push_back(ci * s); }
+
+        // Safety check
+        if (specs.problem == PROBLEM::NA)
+        {
+            this->throw_error("mex_session: problem must be 'tbp' or 'ftmp'.");
+        }
+
+        // Inertia matrix if attitude
+        if (specs.problem == PROBLEM::FREE_TORQUE_MOTION)
+        {
+            this->require_arguments(inputs, 9, "create");
+            matlab::data::TypedArray<double> inertia = inputs[8];
+            if (inertia.getNumberOfElements() != 9)
+            {
+                this->throw_error("mex_session: the inertia matrix must be 3 x 3.");
+            }
+            for (int i = 0; i < 3; i++)
+            {
+                for (int j = 0; j < 3; j++)
+                {
+                    specs.initial_conditions.inertia[i][j] = inertia[i][j];
+                }
+            }
+        }
+
+        // Build and propagate
+        auto s = std::make_unique<session>(specs);
+        s->propagate();
+
+        // Store it
+        return session_registry::insert(std::move(s));
+    }
+
+    matlab::data::TypedArray<double> evaluate(matlab::mex::ArgumentList& inputs)
+    {
+        // Get session
+        auto s = this->get_session(inputs);
+
+        // Get samples: one per column
+        matlab::data::TypedArray<double> deltas = inputs[2];
+        auto dims = deltas.getDimensions();
+        std::vector<DACE::AlgebraicVector<double>> samples(dims[1], DACE::AlgebraicVector<double>(dims[0]));
+        for (std::size_t j = 0; j < dims[1]; j++)
+        {
+            for (std::size_t i = 0; i < dims[0]; i++)
+            {
+                samples[j][i] = deltas[i][j];
+            }
+        }
+
+        // Evaluate
+        auto evals = s->evaluate(samples);
+
+        // Build output
+        std::size_t n_rows = evals.empty() ? 0 : evals[0].size();
+        auto result = this->factoryPtr->createArray<double>({n_rows, evals.size()});
+        for (std::size_t j = 0; j < evals.size(); j++)
+        {
+            for (std::size_t i = 0; i < n_rows; i++)
+            {
+                result[i][j] = evals[j][i];
+            }
+        }
+
+        return result;
+    }
+
+    matlab::data::StructArray patches(matlab::mex::ArgumentList& inputs)
+    {
+        // Get manifold
+        auto manifold = this->get_session(inputs)->get_manifold_fin();
+
+        // Build output
+        auto result = this->factoryPtr->createStructArray({1, manifold->size()},
+                                                          {"id", "history", "center", "width", "t", "nli", "state"});
+
+        // Fill each patch
+        for (std::size_t k = 0; k < manifold->size(); k++)
+        {
+            auto& p = manifold->at(k);
+            auto history = p.get_history_int();
+            auto center = p.get_center();
+            auto width = p.get_width();
+            auto state = p.cons();
+
+            result[k]["id"] = this->factoryPtr->createScalar<double>(p.id_);
+            result[k]["history"] = this->factoryPtr->createArray<int>({1, history.size()}, history.data(),
+                                                                     history.data() + history.size());
+            result[k]["center"] = this->factoryPtr->createArray<double>({1, center.size()}, center.data(),
+                                                                       center.data() + center.size());
+            result[k]["width"] = this->factoryPtr->createArray<double>({1, width.size()}, width.data(),
+                                                                      width.data() + width.size());
+            result[k]["t"] = this->factoryPtr->createScalar<double>(p.t_);
+            result[k]["nli"] = this->factoryPtr->createScalar<double>(p.nli);
+            result[k]["state"] = this->factoryPtr->createArray<double>({state.size(), 1}, state.data(),
+                                                                      state.data() + state.size());
+        }
+
+        return result;
+    }
+
+    matlab::data::StructArray mixture(matlab::mex::ArgumentList& inputs)
+    {
+        // Get session and the optional target count
+        auto s = this->get_session(inputs);
+        std::size_t target = inputs.size() > 2 ? (std::size_t) mex_aux::convertMatlabDouble2NormalDouble(inputs[2]) : 0;
+
+        // Extract and merge
+        auto components = mixture::extract(*s->get_manifold_fin(), s->get_specs().initial_conditions.confidence_interval);
+        mixture::reduce(components, target);
+
+        // Build output
+        auto result = this->factoryPtr->createStructArray({1, components.size()}, {"weight", "mean", "covariance"});
+
+        // Fill each component: the covariance is symmetric, row-major and column-major are the same
+        for (std::size_t k = 0; k < components.size(); k++)
+        {
+            const auto& g = components[k];
+            result[k]["weight"] = this->factoryPtr->createScalar<double>(g.weight);
+            result[k]["mean"] = this->factoryPtr->createArray<double>({g.mean.size(), 1}, g.mean.data(),
+                                                                     g.mean.data() + g.mean.size());
+            result[k]["covariance"] = this->factoryPtr->createArray<double>({g.mean.size(), g.mean.size()},
+                                                                           g.covariance.data(),
+                                                                           g.covariance.data() + g.covariance.size());
+        }
+
+        return result;
+    }
+
+    void require_arguments(matlab::mex::ArgumentList& inputs, std::size_t n, const std::string& command)
+    {
+        // Safety check: command included
+        if (inputs.size() < n)
+        {
+            this->throw_error("mex_session: '" + command + "' needs " + std::to_string(n - 1) + " arguments, got " +
+                              std::to_string(inputs.size() - 1) + ".");
+        }
+    }
+
+    std::uint64_t get_handle(matlab::mex::ArgumentList& inputs)
+    {
+        // Safety check
+        if (inputs.size() < 2)
+        {
+            this->throw_error("mex_session: a session handle is required.");
+        }
+
+        matlab::data::TypedArray<uint64_t> handle = inputs[1];
+        return handle[0];
+    }
+
+    session* get_session(matlab::mex::ArgumentList& inputs)
+    {
+        // Look for it
+        auto s = session_registry::find(this->get_handle(inputs));
+
+        // Safety check
+        if (s == nullptr)
+        {
+            this->throw_error("mex_session: invalid or already freed session handle.");
+        }
+
+        return s;
+    }
+
+    void throw_error(const std::string& msg)
+    {
+        this->matlabPtr->feval(u"error", 0,
+                               std::vector<matlab::data::Array>({this->factoryPtr->createScalar(msg)}));
+    }
+};
@@ -14,6 +14,7 @@
 
 // Project libraries
 #include "ads/SuperManifold.h"
+#include "tools/arena.h"
 #include "delta.h"
 
 // Some definitions
@@ -149,7 +150,7 @@ public:
                                                                          {matlab::data::MATLABString(u16_String.c_str()) });
     }
 
-    SuperManifold* propagate_orbit_loads_SUPER_MANIFOLD(const std::vector<double>& t, double& nli, int& n_max, PROBLEM prob, const double* inertia = nullptr, bool simple_DA_propagation = false)
+    SuperManifold* propagate_orbit_loads_SUPER_MANIFOLD(tools::arena& run, const std::vector<double>& t, double& nli, int& n_max, PROBLEM prob, const double* inertia = nullptr, bool simple_DA_propagation = false)
     {
       this->matlabPtr->feval(u"fprintf",
                        0,
@@ -161,10 +162,10 @@ public:
       double const dt = t[2];
 
       // Initialize integrator
-      auto objIntegrator = std::make_unique<integrator>(INTEGRATOR::RK4, simple_DA_propagation ? ALGORITHM::NONE : ALGORITHM::LOADS , dt);
+      auto objIntegrator = run.make<integrator>(INTEGRATOR::RK4, simple_DA_propagation ? ALGORITHM::NONE : ALGORITHM::LOADS , dt);
 
       // Build super manifold: LOADS
-      auto super_manifold = new SuperManifold(nli, n_max, simple_DA_propagation ? ALGORITHM::NONE : ALGORITHM::LOADS );
+      auto super_manifold = run.make<SuperManifold>(nli, n_max, simple_DA_propagation ? ALGORITHM::NONE : ALGORITHM::LOADS );
 
       // Set beta constant in integrator
       objIntegrator->set_beta(const_cast<std::vector<double> &>(betas));
@@ -174,12 +175,12 @@ public:
 
       if (prob == PROBLEM::TWO_BODY)
       {
-        problem = new problems(prob, 1);
+        problem = run.make<problems>(prob, 1);
       }
       else if (prob == PROBLEM::FREE_TORQUE_MOTION)
       {
         // Free Torque Motion problem
-        problem = new problems(prob);
+        problem = run.make<problems>(prob);
 
         // Create double[3][3]
         double inertia3x3[3][3];
@@ -220,7 +221,7 @@ public:
       objIntegrator->set_integration_parameters(scv0, t0, tf,interruption);
 
       // Set integrator in the super manifold
-      super_manifold->set_integrator_ptr(objIntegrator.get());
+      super_manifold->set_integrator_ptr(objIntegrator);
 
       // Docu: Set new truncation error and get the previous one
       double new_eps = 1e-40;
@@ -253,8 +254,9 @@ public:
       // Initialize initial conditions
       this->initialize_initial_conditions(ini_state, stddev, ci);
 
-      // Get super manifold
-      auto super_manifold = propagate_orbit_loads_SUPER_MANIFOLD(t, nli,  n_max, prob, inertia);
+      // Get super manifold: objects of this call, released all together on return
+      tools::arena run{};
+      auto super_manifold = propagate_orbit_loads_SUPER_MANIFOLD(run, t, nli,  n_max, prob, inertia);
 
       // Return result
       return super_manifold->current_->front().toString();
@@ -266,8 +268,9 @@ public:
       // Initialize initial conditions
       this->initialize_initial_conditions(ini_state, stddev, ci);
 
-      // Get super manifold
-      auto super_manifold = propagate_orbit_loads_SUPER_MANIFOLD(t, nli,  n_max, prob, inertia);
+      // Get super manifold: objects of this call, released all together on return
+      tools::arena run{};
+      auto super_manifold = propagate_orbit_loads_SUPER_MANIFOLD(run, t, nli,  n_max, prob, inertia);
 
       // Build deltas class
       auto deltas_engine = std::make_shared<delta>();